@@ -8,6 +8,7 @@ class ClientApp : public XYZ::Application
 {
 public:
 	ClientApp()
+		: Application({ true })
 	{
 		PushLayer(new XYZ::ClientLayer());
 	}
@@ -23,8 +23,8 @@ layout(location = 0) out vec4 o_Color;
 
 in vec2 v_TexCoords;
 
-uniform int u_NumberPointLights;
-uniform int u_NumberSpotLights;
+uniform int u_TileSize;
+uniform int u_TileCountX;
 
 struct PointLightData
 {
@@ -56,17 +56,37 @@ layout(std430, binding = 2) buffer buffer_SpotLights
 	SpotLightData SpotLights[];
 };
 
+// Point light indices of tile are followed by spot light indices
+struct LightTile
+{
+	uint Offset;
+	uint PointLightCount;
+	uint SpotLightCount;
+	uint Alignment;
+};
+
+layout(std430, binding = 3) buffer buffer_LightTiles
+{
+	LightTile LightTiles[];
+};
+
+layout(std430, binding = 4) buffer buffer_LightIndices
+{
+	uint LightIndices[];
+};
+
 
 float Determinant(vec2 a, vec2 b)
 {
 	return a.x * b.y - a.y * b.x;
 }
 
-vec3 CalculatePointLights(vec3 defaultColor, vec2 fragPos)
+vec3 CalculatePointLights(vec3 defaultColor, vec2 fragPos, LightTile tile)
 {
 	vec3 litColor = vec3(0.0, 0.0, 0.0);
-	for (int i = 0; i < u_NumberPointLights; ++i)
+	for (uint j = 0; j < tile.PointLightCount; ++j)
 	{
+		uint i = LightIndices[tile.Offset + j];
 		float dist = distance(fragPos, PointLights[i].Position.xy);
 		float radius = PointLights[i].Radius;
 		if (dist <= radius)
@@ -75,11 +95,13 @@ vec3 CalculatePointLights(vec3 defaultColor, vec2 fragPos)
 	return litColor;
 }
 
-vec3 CalculateSpotLights(vec3 defaultColor, vec2 fragPos)
+vec3 CalculateSpotLights(vec3 defaultColor, vec2 fragPos, LightTile tile)
 {
 	vec3 litColor = vec3(0.0, 0.0, 0.0);
-	for (int i = 0; i < u_NumberSpotLights; ++i)
+	uint first = tile.Offset + tile.PointLightCount;
+	for (uint j = 0; j < tile.SpotLightCount; ++j)
 	{
+		uint i = LightIndices[first + j];
 		float dist = distance(fragPos, SpotLights[i].Position.xy);
 		float radius = SpotLights[i].Radius;
 		if (dist <= radius)
@@ -106,8 +128,11 @@ void main()
 	vec4 color = texture(u_Texture[0], v_TexCoords);
 	vec3 fragPos = texture(u_Texture[1], v_TexCoords).xyz;
 
-	vec3 litColor = CalculatePointLights(color.xyz, fragPos.xy);
-	litColor += CalculateSpotLights(color.xyz, fragPos.xy);
+	ivec2 tileCoord = ivec2(gl_FragCoord.xy) / u_TileSize;
+	LightTile tile = LightTiles[tileCoord.y * u_TileCountX + tileCoord.x];
+
+	vec3 litColor = CalculatePointLights(color.xyz, fragPos.xy, tile);
+	litColor += CalculateSpotLights(color.xyz, fragPos.xy, tile);
 
 	o_Color = vec4(litColor, color.a);
 }
\ No newline at end of file
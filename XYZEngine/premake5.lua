@@ -91,6 +91,13 @@ project "XYZEngine"
 			"src/Platform/Windows/**.cpp",
 		}
 
+		filter "system:linux"
+		files
+		{
+			"src/Platform/Linux/**.h",
+			"src/Platform/Linux/**.cpp",
+		}
+
 		filter "configurations:Debug"
 				defines "XYZ_DEBUG"
 				runtime "Debug"
@@ -0,0 +1,157 @@
+#include "stdafx.h"
+#include "LinuxFileWatcher.h"
+
+#ifdef XYZ_PLATFORM_LINUX
+
+#include <sys/inotify.h>
+#include <poll.h>
+#include <unistd.h>
+
+#include <filesystem>
+
+namespace XYZ {
+
+	static constexpr uint32_t sc_WatchMask = IN_MODIFY | IN_CLOSE_WRITE | IN_ATTRIB
+										   | IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO
+										   | IN_DELETE_SELF;
+	// Stop is checked at least this often
+	static constexpr int sc_PollTimeoutMs = 100;
+
+	static std::wstring ToWide(const std::string& path)
+	{
+		return std::filesystem::path(path).wstring();
+	}
+
+	LinuxFileWatcher::LinuxFileWatcher(const std::wstring& dir)
+		:
+		FileWatcher(dir),
+		m_NativeDirectory(std::filesystem::path(dir).string())
+	{
+	}
+	LinuxFileWatcher::~LinuxFileWatcher()
+	{
+		Stop();
+	}
+	void LinuxFileWatcher::Start()
+	{
+		if (m_Running)
+			return;
+
+		m_Inotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+		if (m_Inotify < 0)
+		{
+			XYZ_LOG_ERR("Failed to initialize inotify for ", m_NativeDirectory);
+			return;
+		}
+
+		// inotify is not recursive, every subdirectory needs its own watch
+		addWatch("");
+		std::error_code error;
+		for (auto& entry : std::filesystem::recursive_directory_iterator(m_NativeDirectory, error))
+		{
+			if (entry.is_directory())
+				addWatch(std::filesystem::relative(entry.path(), m_NativeDirectory).generic_string());
+		}
+
+		m_Running = true;
+		startDispatch();
+		m_FileWatcherThread = std::thread(&LinuxFileWatcher::watcherThread, this);
+	}
+	void LinuxFileWatcher::Stop()
+	{
+		m_Running = false;
+		if (m_FileWatcherThread.joinable())
+			m_FileWatcherThread.join();
+
+		stopDispatch();
+		if (m_Inotify >= 0)
+		{
+			close(m_Inotify);
+			m_Inotify = -1;
+		}
+		m_WatchedDirectories.clear();
+	}
+
+	void LinuxFileWatcher::watcherThread()
+	{
+		// Large enough for many events, aligned for inotify_event
+		alignas(inotify_event) char buffer[16 * 1024];
+		pollfd descriptor = { m_Inotify, POLLIN, 0 };
+
+		while (m_Running)
+		{
+			const int ready = poll(&descriptor, 1, sc_PollTimeoutMs);
+			if (ready <= 0)
+				continue;
+
+			ssize_t length;
+			while ((length = read(m_Inotify, buffer, sizeof(buffer))) > 0)
+			{
+				for (char* ptr = buffer; ptr < buffer + length;)
+				{
+					const inotify_event* event = reinterpret_cast<const inotify_event*>(ptr);
+					ptr += sizeof(inotify_event) + event->len;
+
+					if (event->mask & IN_Q_OVERFLOW)
+					{
+						XYZ_LOG_WARN("File watcher event queue overflowed, changes of ", m_NativeDirectory, " were lost");
+						continue;
+					}
+					if (event->mask & (IN_IGNORED | IN_DELETE_SELF))
+					{
+						m_WatchedDirectories.erase(event->wd);
+						continue;
+					}
+					auto it = m_WatchedDirectories.find(event->wd);
+					if (it == m_WatchedDirectories.end() || event->len == 0)
+						continue;
+
+					const std::string relativePath = it->second.empty() ? std::string(event->name) : it->second + "/" + event->name;
+					const std::wstring fileName = ToWide(relativePath);
+
+					if ((event->mask & IN_ISDIR) && (event->mask & (IN_CREATE | IN_MOVED_TO)))
+					{
+						// Files created before the watch was added are not reported, report them here
+						addWatch(relativePath);
+						std::error_code error;
+						for (auto& entry : std::filesystem::recursive_directory_iterator(m_NativeDirectory + "/" + relativePath, error))
+						{
+							const std::string entryPath = std::filesystem::relative(entry.path(), m_NativeDirectory).generic_string();
+							if (entry.is_directory())
+								addWatch(entryPath);
+							OnFileAdded(ToWide(entryPath));
+						}
+					}
+
+					if (event->mask & (IN_MODIFY | IN_CLOSE_WRITE | IN_ATTRIB))
+						OnFileChange(fileName);
+					else if (event->mask & IN_CREATE)
+						OnFileAdded(fileName);
+					else if (event->mask & IN_DELETE)
+						OnFileRemoved(fileName);
+					else if (event->mask & (IN_MOVED_FROM | IN_MOVED_TO))
+						OnFileRenamed(fileName);
+				}
+			}
+		}
+	}
+
+	void LinuxFileWatcher::addWatch(const std::string& relativeDir)
+	{
+		const std::string path = relativeDir.empty() ? m_NativeDirectory : m_NativeDirectory + "/" + relativeDir;
+		const int watch = inotify_add_watch(m_Inotify, path.c_str(), sc_WatchMask);
+		if (watch < 0)
+		{
+			XYZ_LOG_WARN("Failed to watch directory ", path);
+			return;
+		}
+		m_WatchedDirectories[watch] = relativeDir;
+	}
+
+	std::shared_ptr<FileWatcher> FileWatcher::Create(const std::wstring& dir)
+	{
+		return std::make_shared<LinuxFileWatcher>(dir);
+	}
+}
+
+#endif
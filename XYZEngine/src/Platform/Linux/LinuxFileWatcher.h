@@ -0,0 +1,31 @@
+#pragma once
+#include "XYZ/FileWatcher/FileWatcher.h"
+
+#include <thread>
+
+namespace XYZ {
+
+	class LinuxFileWatcher : public FileWatcher
+	{
+	public:
+		LinuxFileWatcher(const std::wstring& dir);
+		virtual ~LinuxFileWatcher() override;
+
+		virtual void Start() override;
+		virtual void Stop() override;
+		virtual bool IsRunning() const override { return m_Running; }
+
+	private:
+		void watcherThread();
+		void addWatch(const std::string& relativeDir);
+
+	private:
+		std::thread m_FileWatcherThread;
+		std::atomic<bool> m_Running = false;
+
+		int m_Inotify = -1;
+		std::string m_NativeDirectory;
+		// Watch descriptor to directory relative to watched directory
+		std::unordered_map<int, std::string> m_WatchedDirectories;
+	};
+}
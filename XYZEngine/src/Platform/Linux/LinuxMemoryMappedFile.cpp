@@ -0,0 +1,52 @@
+#include "stdafx.h"
+#include "XYZ/Utils/MemoryMappedFile.h"
+
+#ifdef XYZ_PLATFORM_LINUX
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace XYZ {
+
+	MemoryMappedFile::~MemoryMappedFile()
+	{
+		Close();
+	}
+
+	bool MemoryMappedFile::Open(const std::string& filepath)
+	{
+		Close();
+		int file = open(filepath.c_str(), O_RDONLY);
+		if (file < 0)
+			return false;
+
+		struct stat info;
+		if (fstat(file, &info) != 0 || info.st_size == 0)
+		{
+			close(file);
+			return false;
+		}
+
+		void* data = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+		// Mapping keeps its own reference to the file
+		close(file);
+		if (data == MAP_FAILED)
+			return false;
+
+		m_Data = (const uint8_t*)data;
+		m_Size = (size_t)info.st_size;
+		return true;
+	}
+
+	void MemoryMappedFile::Close()
+	{
+		if (m_Data)
+			munmap((void*)m_Data, m_Size);
+
+		m_Data = nullptr;
+		m_Size = 0;
+	}
+}
+
+#endif
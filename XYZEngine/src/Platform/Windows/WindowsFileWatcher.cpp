@@ -19,7 +19,6 @@ namespace XYZ {
 			NULL													 // file with attributes to copy
 		);
 
-		wchar_t filename[MAX_PATH];
 		FILE_NOTIFY_INFORMATION Buffer[1024];
 		DWORD BytesReturned;
 
@@ -41,19 +40,16 @@ namespace XYZ {
 			NULL									 // completion routine
 		) && watcherObj->IsRunning())
 		{
-			int offset = 0;
-			FILE_NOTIFY_INFORMATION* pNotify;
-			pNotify = (FILE_NOTIFY_INFORMATION*)((char*)Buffer + offset);
-			wcscpy(filename, L"");
+			// Zero bytes means that buffer overflowed and changes were lost
+			if (BytesReturned == 0)
+				continue;
 
-			wcsncpy(filename, pNotify->FileName, pNotify->FileNameLength / 2);
-
-			filename[pNotify->FileNameLength / 2] = NULL;
-
-			auto fullPath = watcherObj->GetDirectory() + L"/" + filename;
+			// Buffer holds multiple notifications, bulk operations are coalesced by FileWatcher
+			FILE_NOTIFY_INFORMATION* pNotify = Buffer;
 			while (true)
-			{	
-				switch (Buffer[0].Action)
+			{
+				std::wstring filename(pNotify->FileName, pNotify->FileNameLength / sizeof(wchar_t));
+				switch (pNotify->Action)
 				{
 				case FILE_ACTION_MODIFIED:
 					watcherObj->OnFileChange(filename);
@@ -71,8 +67,10 @@ namespace XYZ {
 					watcherObj->OnFileRenamed(filename);
 					break;
 				}
-				break;			
-			}		
+				if (pNotify->NextEntryOffset == 0)
+					break;
+				pNotify = (FILE_NOTIFY_INFORMATION*)((char*)pNotify + pNotify->NextEntryOffset);
+			}
 		}
 		CloseHandle(hDir);
 	}
@@ -85,12 +83,14 @@ namespace XYZ {
 	void WindowsFileWatcher::Start()
 	{
 		m_Running = true;
+		startDispatch();
 		m_FileWatcherThread = std::unique_ptr<std::thread>(new std::thread(FileWatcherThread, this->shared_from_this()));
 		m_FileWatcherThread->detach();
 	}
 	void WindowsFileWatcher::Stop()
 	{
 		m_Running = false;
+		stopDispatch();
 	}
 
 	std::shared_ptr<FileWatcher> FileWatcher::Create(const std::wstring& dir)
@@ -30,6 +30,7 @@
 #include "XYZ/Animation/Animation.h"
 #include "XYZ/Animation/TransformTrack.h"
 #include "XYZ/Animation/SpriteRendererTrack.h"
+#include "XYZ/Animation/Skinning.h"
 
 #include "XYZ/Particle/GPU/ParticleMaterial.h"
 #include "XYZ/Particle/GPU/ParticleSystem.h"
@@ -3,6 +3,7 @@
 
 #include "XYZ/Renderer/Renderer.h"
 #include "XYZ/Utils/StringUtils.h"
+#include "XYZ/Asset/AssetManager.h"
 
 #include <GL/glew.h>
 #include <glm/gtc/type_ptr.hpp>
@@ -136,16 +137,7 @@ namespace XYZ {
 	std::string readShaderFromFile(const std::string& filepath)
 	{
 		std::string result;
-		std::ifstream in(filepath, std::ios::in | std::ios::binary);
-		if (in)
-		{
-			in.seekg(0, std::ios::end);
-			result.resize(in.tellg());
-			in.seekg(0, std::ios::beg);
-			in.read(&result[0], result.size());
-			in.close();
-		}
-		else
+		if (!AssetManager::ReadFile(filepath, result))
 		{
 			XYZ_ASSERT(false, "Could not load shader!");
 		}
@@ -192,42 +184,41 @@ namespace XYZ {
 			});
 	}
 
-	void OpenGLShader::SetVSUniforms(ByteBuffer buffer) const
+	void OpenGLShader::SetVSUniforms(ByteBuffer buffer, uint32_t dirtyBegin, uint32_t dirtyEnd) const
 	{
-		for (auto& uniform : m_VSUniformList.Uniforms)
-		{
-			if (uniform.Count > 1)
-			{
-				Renderer::Submit([=]() {
-					setUniformArr(&uniform, buffer);
-					});
-			}
-			else
-			{
-				Renderer::Submit([=]() {
-					setUniform(&uniform, buffer);
-					});
-			}
-		}
+		Ref<const OpenGLShader> instance = this;
+		Renderer::Submit([instance, buffer, dirtyBegin, dirtyEnd]() {
+			instance->uploadUniforms(instance->m_VSUniformList, buffer, dirtyBegin, dirtyEnd, instance->m_LastVSBuffer);
+			});
 	}
 
-	void OpenGLShader::SetFSUniforms(ByteBuffer buffer)const
+	void OpenGLShader::SetFSUniforms(ByteBuffer buffer, uint32_t dirtyBegin, uint32_t dirtyEnd) const
 	{
-		for (auto& uniform : m_FSUniformList.Uniforms)
+		Ref<const OpenGLShader> instance = this;
+		Renderer::Submit([instance, buffer, dirtyBegin, dirtyEnd]() {
+			instance->uploadUniforms(instance->m_FSUniformList, buffer, dirtyBegin, dirtyEnd, instance->m_LastFSBuffer);
+			});
+	}
+
+	void OpenGLShader::uploadUniforms(const UniformList& list, ByteBuffer data, uint32_t dirtyBegin, uint32_t dirtyEnd, const uint8_t*& lastBuffer) const
+	{
+		// Program keeps values of different buffer, everything must be uploaded
+		const bool uploadAll = lastBuffer != (const uint8_t*)data;
+		if (!uploadAll && dirtyBegin >= dirtyEnd)
+			return;
+
+		for (auto& uniform : list.Uniforms)
 		{
+			if (!uploadAll
+				&& (uniform.Offset >= dirtyEnd || uniform.Offset + uniform.Size * uniform.Count <= dirtyBegin))
+				continue;
+
 			if (uniform.Count > 1)
-			{
-				Renderer::Submit([=]() {
-					setUniformArr(&uniform, buffer);
-					});
-			}
+				setUniformArr(&uniform, data);
 			else
-			{
-				Renderer::Submit([=]() {
-					setUniform(&uniform, buffer);
-					});
-			}
+				setUniform(&uniform, data);
 		}
+		lastBuffer = data;
 	}
 
 	
@@ -322,61 +313,106 @@ namespace XYZ {
 
 	void OpenGLShader::SetFloat(const std::string& name, float value)
 	{
-		Ref<OpenGLShader> instance = this;
-		Renderer::Submit([instance, name, value]() {
-			auto location = glGetUniformLocation(instance->m_RendererID, name.c_str());
-			XYZ_ASSERT(location != -1, "Uniform ", name, " does not exist");
-			instance->uploadFloat(location, value);
-		});
+		SetFloat(GetUniformID(name), value);
 	}
 
 	void OpenGLShader::SetFloat2(const std::string& name, const glm::vec2& value)
+	{
+		SetFloat2(GetUniformID(name), value);
+	}
+
+	void OpenGLShader::SetFloat3(const std::string& name, const glm::vec3& value)
+	{
+		SetFloat3(GetUniformID(name), value);
+	}
+
+	void OpenGLShader::SetFloat4(const std::string& name, const glm::vec4& value)
+	{
+		SetFloat4(GetUniformID(name), value);
+	}
+
+	void OpenGLShader::SetInt(const std::string& name, int value)
+	{
+		SetInt(GetUniformID(name), value);
+	}
+
+	void OpenGLShader::SetMat4(const std::string& name, const glm::mat4& value)
+	{
+		SetMat4(GetUniformID(name), value);
+	}
+
+	void OpenGLShader::SetFloat(uint32_t uniformID, float value)
 	{
 		Ref<OpenGLShader> instance = this;
-		Renderer::Submit([instance, name, value]() {
-			auto location = glGetUniformLocation(instance->m_RendererID, name.c_str());
-			XYZ_ASSERT(location != -1, "Uniform ", name, " does not exist");
-			instance->uploadFloat2(location, value);
+		Renderer::Submit([instance, uniformID, value]() {
+			instance->uploadFloat(instance->getUniformLocation(uniformID), value);
+			instance->m_LastVSBuffer = nullptr;
+			instance->m_LastFSBuffer = nullptr;
 			});
 	}
 
-	void OpenGLShader::SetFloat3(const std::string& name, const glm::vec3& value)
+	void OpenGLShader::SetFloat2(uint32_t uniformID, const glm::vec2& value)
 	{
 		Ref<OpenGLShader> instance = this;
-		Renderer::Submit([instance, name, value]() {
-			auto location = glGetUniformLocation(instance->m_RendererID, name.c_str());
-			XYZ_ASSERT(location != -1, "Uniform ", name, " does not exist");
-			instance->uploadFloat3(location, value);
+		Renderer::Submit([instance, uniformID, value]() {
+			instance->uploadFloat2(instance->getUniformLocation(uniformID), value);
+			instance->m_LastVSBuffer = nullptr;
+			instance->m_LastFSBuffer = nullptr;
 			});
 	}
 
-	void OpenGLShader::SetFloat4(const std::string& name, const glm::vec4& value)
+	void OpenGLShader::SetFloat3(uint32_t uniformID, const glm::vec3& value)
 	{
 		Ref<OpenGLShader> instance = this;
-		Renderer::Submit([instance, name, value]() {
-			auto location = glGetUniformLocation(instance->m_RendererID, name.c_str());
-			XYZ_ASSERT(location != -1, "Uniform ", name, " does not exist");
-			instance->uploadFloat4(location, value);
+		Renderer::Submit([instance, uniformID, value]() {
+			instance->uploadFloat3(instance->getUniformLocation(uniformID), value);
+			instance->m_LastVSBuffer = nullptr;
+			instance->m_LastFSBuffer = nullptr;
 			});
 	}
 
-	void OpenGLShader::SetInt(const std::string& name, int value)
+	void OpenGLShader::SetFloat4(uint32_t uniformID, const glm::vec4& value)
 	{
 		Ref<OpenGLShader> instance = this;
-		Renderer::Submit([instance, name, value]() {
-			auto location = glGetUniformLocation(instance->m_RendererID, name.c_str());
-			XYZ_ASSERT(location != -1, "Uniform ", name, " does not exist");
-			instance->uploadInt(location, value);
+		Renderer::Submit([instance, uniformID, value]() {
+			instance->uploadFloat4(instance->getUniformLocation(uniformID), value);
+			instance->m_LastVSBuffer = nullptr;
+			instance->m_LastFSBuffer = nullptr;
 			});
 	}
 
-	void OpenGLShader::SetMat4(const std::string& name, const glm::mat4& value)
+	void OpenGLShader::SetInt(uint32_t uniformID, int value)
 	{
 		Ref<OpenGLShader> instance = this;
-		Renderer::Submit([instance, name, value]() {
-			auto location = glGetUniformLocation(instance->m_RendererID, name.c_str());
-			XYZ_ASSERT(location != -1, "Uniform ", name, " does not exist");
-			instance->uploadMat4(location, value);
+		Renderer::Submit([instance, uniformID, value]() {
+			instance->uploadInt(instance->getUniformLocation(uniformID), value);
+			instance->m_LastVSBuffer = nullptr;
+			instance->m_LastFSBuffer = nullptr;
+			});
+	}
+
+	void OpenGLShader::SetMat4(uint32_t uniformID, const glm::mat4& value)
+	{
+		Ref<OpenGLShader> instance = this;
+		Renderer::Submit([instance, uniformID, value]() {
+			instance->uploadMat4(instance->getUniformLocation(uniformID), value);
+			instance->m_LastVSBuffer = nullptr;
+			instance->m_LastFSBuffer = nullptr;
+			});
+	}
+
+	void OpenGLShader::SetMat4Array(uint32_t uniformID, const glm::mat4* values, uint32_t count)
+	{
+		if (!count)
+			return;
+
+		Ref<OpenGLShader> instance = this;
+		// Matrices are stored in the command queue, no allocation per call
+		const glm::mat4* data = (const glm::mat4*)Renderer::SubmitData(values, count * sizeof(glm::mat4));
+		Renderer::Submit([instance, uniformID, data, count]() {
+			instance->uploadMat4Arr(instance->getUniformLocation(uniformID), data[0], count);
+			instance->m_LastVSBuffer = nullptr;
+			instance->m_LastFSBuffer = nullptr;
 			});
 	}
 
@@ -441,12 +477,31 @@ namespace XYZ {
 	void OpenGLShader::load(const std::string& source)
 	{
 		m_ShaderSources = preProcess(source);
-		parse();
+
+		const uint64_t sourceHash = OpenGLShaderCache::HashSource(source);
+		OpenGLShaderCacheEntry cache;
+		if (OpenGLShaderCache::Load(m_AssetPath, sourceHash, cache))
+		{
+			m_IsCompute = cache.IsCompute;
+			m_VSUniformList = std::move(cache.VSUniformList);
+			m_FSUniformList = std::move(cache.FSUniformList);
+			m_TextureList = std::move(cache.TextureList);
+		}
+		else
+		{
+			parse();
+		}
 
 		Ref<OpenGLShader> instance = this;
-		Renderer::Submit([instance]() mutable {
-			instance->compileAndUpload();
+		Renderer::Submit([instance, sourceHash, format = cache.BinaryFormat, binary = std::move(cache.Binary)]() mutable {
+			if (!instance->loadProgramBinary(format, binary))
+			{
+				if (instance->compileAndUpload())
+					instance->saveCache(sourceHash);
+			}
 			instance->resolveUniforms();
+			instance->m_LastVSBuffer = nullptr;
+			instance->m_LastFSBuffer = nullptr;
 		});
 	}
 
@@ -540,7 +595,7 @@ namespace XYZ {
 			}			
 		}
 	}
-	void OpenGLShader::compileAndUpload()
+	bool OpenGLShader::compileAndUpload()
 	{
 		GLuint program = glCreateProgram();
 		XYZ_ASSERT(m_ShaderSources.size() <= 3, "We only support 3 shaders for now");
@@ -588,6 +643,7 @@ namespace XYZ {
 
 		// Link our program
 		m_RendererID = program;
+		glProgramParameteri(m_RendererID, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
 		glLinkProgram(m_RendererID);
 
 		GLint isLinked = 0;
@@ -611,7 +667,7 @@ namespace XYZ {
 
 			XYZ_LOG_ERR(infoLog.data());
 			XYZ_ASSERT(false, "Shader link failure!");
-			return;
+			return false;
 		}
 
 		for (size_t i = 0; i < glShaderIDIndex; ++i)
@@ -619,18 +675,80 @@ namespace XYZ {
 			glDetachShader(m_RendererID, glShaderIDs[i]);
 			glDeleteShader(glShaderIDs[i]);
 		}
+		return true;
+	}
+	bool OpenGLShader::loadProgramBinary(uint32_t format, const std::vector<uint8_t>& binary)
+	{
+		if (binary.empty())
+			return false;
+
+		GLuint program = glCreateProgram();
+		glProgramBinary(program, format, binary.data(), (GLsizei)binary.size());
+
+		GLint isLinked = 0;
+		glGetProgramiv(program, GL_LINK_STATUS, &isLinked);
+		if (isLinked == GL_FALSE)
+		{
+			// Binary was produced by different driver, fallback to compilation
+			glDeleteProgram(program);
+			return false;
+		}
+
+		if (m_RendererID)
+			glDeleteProgram(m_RendererID);
+		m_RendererID = program;
+		return true;
+	}
+	void OpenGLShader::saveCache(uint64_t sourceHash) const
+	{
+		OpenGLShaderCacheEntry entry = OpenGLShaderCache::CreateEntry(sourceHash, m_IsCompute, m_VSUniformList, m_FSUniformList, m_TextureList);
+
+		GLint length = 0;
+		glGetProgramiv(m_RendererID, GL_PROGRAM_BINARY_LENGTH, &length);
+		if (length > 0)
+		{
+			GLenum format = 0;
+			entry.Binary.resize(length);
+			glGetProgramBinary(m_RendererID, length, nullptr, &format, entry.Binary.data());
+			entry.BinaryFormat = format;
+		}
+		OpenGLShaderCache::Save(m_AssetPath, entry);
 	}
 	void OpenGLShader::resolveUniforms()
 	{
 		glUseProgram(m_RendererID);
+		m_UniformLocations.clear();
 		for (auto& uni : m_VSUniformList.Uniforms)
 		{
 			uni.Location = glGetUniformLocation(m_RendererID, uni.Name.c_str());
+			uint32_t uniformID = GetUniformID(uni.Name);
+			if (uniformID >= m_UniformLocations.size())
+				m_UniformLocations.resize((size_t)uniformID + 1, sc_UnresolvedLocation);
+			m_UniformLocations[uniformID] = (int32_t)uni.Location;
 		}
 		for (auto& uni : m_FSUniformList.Uniforms)
 		{
 			uni.Location = glGetUniformLocation(m_RendererID, uni.Name.c_str());
+			uint32_t uniformID = GetUniformID(uni.Name);
+			if (uniformID >= m_UniformLocations.size())
+				m_UniformLocations.resize((size_t)uniformID + 1, sc_UnresolvedLocation);
+			m_UniformLocations[uniformID] = (int32_t)uni.Location;
+		}
+	}
+	uint32_t OpenGLShader::getUniformLocation(uint32_t uniformID) const
+	{
+		if (uniformID >= m_UniformLocations.size())
+			m_UniformLocations.resize((size_t)uniformID + 1, sc_UnresolvedLocation);
+
+		int32_t& location = m_UniformLocations[uniformID];
+		if (location == sc_UnresolvedLocation)
+		{
+			// Uniforms not found by parser, for example elements of arrays
+			std::string name = GetUniformName(uniformID);
+			location = glGetUniformLocation(m_RendererID, name.c_str());
+			XYZ_ASSERT(location != -1, "Uniform ", name, " does not exist");
 		}
+		return (uint32_t)location;
 	}
 	const char* FindToken(const char* str, const std::string& token)
 	{
@@ -657,7 +775,7 @@ namespace XYZ {
 		m_VSUniformList.Uniforms.clear();
 		m_VSUniformList.Size = 0;
 		m_FSUniformList.Uniforms.clear();
-		m_VSUniformList.Size = 0;
+		m_FSUniformList.Size = 0;
 
 		auto& vertexSource = m_ShaderSources[GL_VERTEX_SHADER];
 		auto& fragmentSource = m_ShaderSources[GL_FRAGMENT_SHADER];
@@ -1,5 +1,6 @@
 #pragma once
 #include "XYZ/Renderer/Shader.h"
+#include "OpenGLShaderCache.h"
 
 namespace XYZ {
 	class OpenGLShader : public Shader
@@ -12,8 +13,8 @@ namespace XYZ {
 		virtual void Bind() const override;
 		virtual void Unbind() const override;
 		virtual void Compute(uint32_t groupX, uint32_t groupY = 1, uint32_t groupZ = 1) const override;
-		virtual void SetVSUniforms(ByteBuffer buffer) const override;
-		virtual void SetFSUniforms(ByteBuffer buffer) const override;
+		virtual void SetVSUniforms(ByteBuffer buffer, uint32_t dirtyBegin = 0, uint32_t dirtyEnd = UINT32_MAX) const override;
+		virtual void SetFSUniforms(ByteBuffer buffer, uint32_t dirtyBegin = 0, uint32_t dirtyEnd = UINT32_MAX) const override;
 
 
 		virtual void Reload() override;
@@ -26,6 +27,14 @@ namespace XYZ {
 		virtual void SetFloat4(const std::string& name, const glm::vec4& value) override;
 		virtual void SetMat4(const std::string& name, const glm::mat4& value) override;
 
+		virtual void SetInt(uint32_t uniformID, int value) override;
+		virtual void SetFloat(uint32_t uniformID, float value) override;
+		virtual void SetFloat2(uint32_t uniformID, const glm::vec2& value) override;
+		virtual void SetFloat3(uint32_t uniformID, const glm::vec3& value) override;
+		virtual void SetFloat4(uint32_t uniformID, const glm::vec4& value) override;
+		virtual void SetMat4(uint32_t uniformID, const glm::mat4& value) override;
+		virtual void SetMat4Array(uint32_t uniformID, const glm::mat4* values, uint32_t count) override;
+
 		virtual const UniformList& GetVSUniformList() const override { return m_VSUniformList; }
 		virtual const UniformList& GetFSUniformList() const override { return m_FSUniformList; }
 		virtual const TextureUniformList& GetTextureList() const override { return m_TextureList; }
@@ -38,13 +47,17 @@ namespace XYZ {
 		void parse();
 		void load(const std::string& source);
 		void parseUniform(const std::string& statement, ShaderType type, const std::vector<ShaderStruct>& structs);
-		void compileAndUpload();
+		bool compileAndUpload();
+		bool loadProgramBinary(uint32_t format, const std::vector<uint8_t>& binary);
+		void saveCache(uint64_t sourceHash) const;
 		void resolveUniforms();
+		uint32_t getUniformLocation(uint32_t uniformID) const;
 
 		std::unordered_map<uint32_t, std::string> preProcess(const std::string& source);
 
 		void parseSource(uint32_t component,const std::string& source);
 
+		void uploadUniforms(const UniformList& list, ByteBuffer data, uint32_t dirtyBegin, uint32_t dirtyEnd, const uint8_t*& lastBuffer) const;
 		void setUniform(const Uniform* uniform, ByteBuffer data) const;
 		void setUniformArr(const Uniform* uniform, ByteBuffer data) const;
 
@@ -76,11 +89,18 @@ namespace XYZ {
 		UniformList m_FSUniformList;
 		TextureUniformList m_TextureList;
 
+		// Buffers which values are currently stored in the program, accessed only from render thread
+		mutable const uint8_t* m_LastVSBuffer = nullptr;
+		mutable const uint8_t* m_LastFSBuffer = nullptr;
+		// Uniform locations indexed by uniform id, accessed only from render thread
+		mutable std::vector<int32_t> m_UniformLocations;
+
 		std::vector<std::function<void()>> m_ShaderReloadCallbacks;
 		std::unordered_map<uint32_t, std::string> m_ShaderSources;
 
 		// Temporary, in future we will get that information from the GPU
 		static constexpr uint32_t sc_MaxTextureSlots = 32;
+		static constexpr int32_t  sc_UnresolvedLocation = -2;
 	};
 
 }
\ No newline at end of file
@@ -0,0 +1,226 @@
+#include "stdafx.h"
+#include "OpenGLShaderCache.h"
+
+#include <filesystem>
+
+namespace XYZ {
+
+	template <typename T>
+	static void WriteValue(std::ofstream& stream, const T& value)
+	{
+		static_assert(std::is_trivially_copyable<T>::value, "Value must be trivially copyable");
+		stream.write((const char*)&value, sizeof(T));
+	}
+
+	template <typename T>
+	static bool ReadValue(std::ifstream& stream, T& value)
+	{
+		static_assert(std::is_trivially_copyable<T>::value, "Value must be trivially copyable");
+		stream.read((char*)&value, sizeof(T));
+		return (bool)stream;
+	}
+
+	static void WriteString(std::ofstream& stream, const std::string& value)
+	{
+		WriteValue(stream, (uint32_t)value.size());
+		stream.write(value.data(), value.size());
+	}
+
+	static bool ReadString(std::ifstream& stream, std::string& value)
+	{
+		uint32_t size = 0;
+		if (!ReadValue(stream, size))
+			return false;
+		value.resize(size);
+		stream.read(value.data(), size);
+		return (bool)stream;
+	}
+
+	static void WriteUniformList(std::ofstream& stream, const UniformList& list)
+	{
+		WriteValue(stream, list.Size);
+		WriteValue(stream, (uint32_t)list.Uniforms.size());
+		for (const Uniform& uniform : list.Uniforms)
+		{
+			WriteString(stream, uniform.Name);
+			WriteValue(stream, (uint32_t)uniform.DataType);
+			WriteValue(stream, (uint32_t)uniform.ShaderType);
+			WriteValue(stream, uniform.Offset);
+			WriteValue(stream, uniform.Size);
+			WriteValue(stream, uniform.Count);
+		}
+	}
+
+	static bool ReadUniformList(std::ifstream& stream, UniformList& list)
+	{
+		uint32_t count = 0;
+		if (!ReadValue(stream, list.Size) || !ReadValue(stream, count))
+			return false;
+
+		list.Uniforms.resize(count);
+		for (Uniform& uniform : list.Uniforms)
+		{
+			uint32_t dataType = 0, shaderType = 0;
+			if (!ReadString(stream, uniform.Name)
+			 || !ReadValue(stream, dataType)
+			 || !ReadValue(stream, shaderType)
+			 || !ReadValue(stream, uniform.Offset)
+			 || !ReadValue(stream, uniform.Size)
+			 || !ReadValue(stream, uniform.Count))
+				return false;
+
+			uniform.DataType = (UniformDataType)dataType;
+			uniform.ShaderType = (ShaderType)shaderType;
+			uniform.Location = 0; // Resolved after the program is linked
+		}
+		return true;
+	}
+
+	static bool IsUniformListEqual(const UniformList& a, const UniformList& b)
+	{
+		if (a.Size != b.Size || a.Uniforms.size() != b.Uniforms.size())
+			return false;
+		for (size_t i = 0; i < a.Uniforms.size(); ++i)
+		{
+			const Uniform& ua = a.Uniforms[i];
+			const Uniform& ub = b.Uniforms[i];
+			if (ua.Name != ub.Name || ua.DataType != ub.DataType || ua.ShaderType != ub.ShaderType
+			 || ua.Offset != ub.Offset || ua.Size != ub.Size || ua.Count != ub.Count)
+				return false;
+		}
+		return true;
+	}
+
+	uint64_t OpenGLShaderCache::HashSource(const std::string& source)
+	{
+		// FNV-1a
+		uint64_t hash = 14695981039346656037ull;
+		for (char c : source)
+		{
+			hash ^= (uint8_t)c;
+			hash *= 1099511628211ull;
+		}
+		return hash;
+	}
+
+	OpenGLShaderCacheEntry OpenGLShaderCache::CreateEntry(uint64_t sourceHash, bool isCompute, const UniformList& vsUniforms, const UniformList& fsUniforms, const TextureUniformList& textures)
+	{
+		OpenGLShaderCacheEntry entry;
+		entry.SourceHash = sourceHash;
+		entry.IsCompute = isCompute;
+		entry.VSUniformList = vsUniforms;
+		entry.FSUniformList = fsUniforms;
+		entry.TextureList = textures;
+		return entry;
+	}
+
+	bool OpenGLShaderCache::Load(const std::string& shaderPath, uint64_t sourceHash, OpenGLShaderCacheEntry& entry)
+	{
+		std::ifstream stream(GetCachePath(shaderPath), std::ios::in | std::ios::binary);
+		if (!stream)
+			return false;
+
+		uint32_t magic = 0, version = 0, isCompute = 0, textureCount = 0, binarySize = 0;
+		if (!ReadValue(stream, magic) || magic != sc_Magic)
+			return false;
+		if (!ReadValue(stream, version) || version != sc_Version)
+			return false;
+		if (!ReadValue(stream, entry.SourceHash) || entry.SourceHash != sourceHash)
+			return false;
+
+		bool valid = ReadValue(stream, isCompute)
+				  && ReadUniformList(stream, entry.VSUniformList)
+				  && ReadUniformList(stream, entry.FSUniformList)
+				  && ReadValue(stream, entry.TextureList.Count)
+				  && ReadValue(stream, textureCount);
+		if (valid)
+		{
+			entry.IsCompute = isCompute != 0;
+			entry.TextureList.Textures.resize(textureCount);
+			for (TextureUniform& texture : entry.TextureList.Textures)
+			{
+				valid = ReadString(stream, texture.Name)
+					 && ReadValue(stream, texture.Slot)
+					 && ReadValue(stream, texture.Count);
+				if (!valid)
+					break;
+			}
+		}
+		if (valid)
+			valid = ReadValue(stream, entry.BinaryFormat) && ReadValue(stream, binarySize);
+		if (valid)
+		{
+			entry.Binary.resize(binarySize);
+			stream.read((char*)entry.Binary.data(), binarySize);
+			valid = (bool)stream;
+		}
+		if (!valid)
+		{
+			XYZ_LOG_WARN("Shader cache of ", shaderPath, " is corrupted, recompiling");
+			entry = OpenGLShaderCacheEntry();
+		}
+		return valid;
+	}
+
+	bool OpenGLShaderCache::Save(const std::string& shaderPath, const OpenGLShaderCacheEntry& entry)
+	{
+		std::error_code error;
+		std::filesystem::create_directories(sc_CacheDirectory, error);
+
+		const std::string cachePath = GetCachePath(shaderPath);
+		std::ofstream stream(cachePath, std::ios::out | std::ios::binary | std::ios::trunc);
+		if (!stream)
+		{
+			XYZ_LOG_WARN("Could not write shader cache ", cachePath);
+			return false;
+		}
+		WriteValue(stream, sc_Magic);
+		WriteValue(stream, sc_Version);
+		WriteValue(stream, entry.SourceHash);
+		WriteValue(stream, (uint32_t)entry.IsCompute);
+		WriteUniformList(stream, entry.VSUniformList);
+		WriteUniformList(stream, entry.FSUniformList);
+		WriteValue(stream, entry.TextureList.Count);
+		WriteValue(stream, (uint32_t)entry.TextureList.Textures.size());
+		for (const TextureUniform& texture : entry.TextureList.Textures)
+		{
+			WriteString(stream, texture.Name);
+			WriteValue(stream, texture.Slot);
+			WriteValue(stream, texture.Count);
+		}
+		WriteValue(stream, entry.BinaryFormat);
+		WriteValue(stream, (uint32_t)entry.Binary.size());
+		stream.write((const char*)entry.Binary.data(), entry.Binary.size());
+		return (bool)stream;
+	}
+
+	bool OpenGLShaderCache::IsReflectionEqual(const OpenGLShaderCacheEntry& a, const OpenGLShaderCacheEntry& b)
+	{
+		if (a.SourceHash != b.SourceHash || a.IsCompute != b.IsCompute
+		 || !IsUniformListEqual(a.VSUniformList, b.VSUniformList)
+		 || !IsUniformListEqual(a.FSUniformList, b.FSUniformList))
+			return false;
+
+		const auto& texturesA = a.TextureList.Textures;
+		const auto& texturesB = b.TextureList.Textures;
+		if (a.TextureList.Count != b.TextureList.Count || texturesA.size() != texturesB.size())
+			return false;
+		for (size_t i = 0; i < texturesA.size(); ++i)
+		{
+			if (texturesA[i].Name != texturesB[i].Name || texturesA[i].Slot != texturesB[i].Slot || texturesA[i].Count != texturesB[i].Count)
+				return false;
+		}
+		return true;
+	}
+
+	std::string OpenGLShaderCache::GetCachePath(const std::string& shaderPath)
+	{
+		std::string name = shaderPath;
+		for (char& c : name)
+		{
+			if (c == '/' || c == '\\' || c == ':')
+				c = '_';
+		}
+		return std::string(sc_CacheDirectory) + "/" + name + ".cache";
+	}
+}
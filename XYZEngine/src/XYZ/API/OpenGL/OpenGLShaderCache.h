@@ -0,0 +1,43 @@
+#pragma once
+#include "XYZ/Renderer/Shader.h"
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace XYZ {
+
+	// Parsed reflection and driver program binary of one shader source
+	struct OpenGLShaderCacheEntry
+	{
+		uint64_t			 SourceHash = 0;
+		bool				 IsCompute = false;
+		UniformList			 VSUniformList;
+		UniformList			 FSUniformList;
+		TextureUniformList	 TextureList;
+
+		// Empty if the driver does not support program binaries
+		uint32_t			 BinaryFormat = 0;
+		std::vector<uint8_t> Binary;
+	};
+
+	class OpenGLShaderCache
+	{
+	public:
+		static uint64_t HashSource(const std::string& source);
+		// Entry without program binary, reflection is copied from the parsed shader
+		static OpenGLShaderCacheEntry CreateEntry(uint64_t sourceHash, bool isCompute, const UniformList& vsUniforms, const UniformList& fsUniforms, const TextureUniformList& textures);
+
+		// Fails if there is no cache for the shader or the source hash does not match
+		static bool Load(const std::string& shaderPath, uint64_t sourceHash, OpenGLShaderCacheEntry& entry);
+		static bool Save(const std::string& shaderPath, const OpenGLShaderCacheEntry& entry);
+		// Compares everything except program binary and resolved uniform locations
+		static bool IsReflectionEqual(const OpenGLShaderCacheEntry& a, const OpenGLShaderCacheEntry& b);
+
+		static std::string GetCachePath(const std::string& shaderPath);
+
+		static constexpr const char* sc_CacheDirectory = "ShaderCache";
+		static constexpr uint32_t	 sc_Magic = 0x43485358; // "XSHC"
+		static constexpr uint32_t	 sc_Version = 1;
+	};
+}
@@ -2,19 +2,86 @@
 #include "OpenGLTexture.h" 
 
 #include "XYZ/Renderer/Renderer.h"
+#include "XYZ/Asset/AssetManager.h"
+#include "XYZ/Renderer/TextureCooker.h"
 
 #include <stb_image.h>
 
 
 namespace XYZ {
+	static void SetTextureParameters(uint32_t rendererID, const TextureSpecs& specs, uint32_t levels)
+	{
+		if (specs.MinParam == TextureParam::Linear)
+		{
+			glTextureParameteri(rendererID, GL_TEXTURE_MIN_FILTER, levels > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+		}
+		else if (specs.MinParam == TextureParam::Nearest)
+		{
+			glTextureParameteri(rendererID, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		}
+
+		if (specs.MagParam == TextureParam::Linear)
+		{
+			glTextureParameteri(rendererID, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		}
+		else if (specs.MagParam == TextureParam::Nearest)
+		{
+			glTextureParameteri(rendererID, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+		}
+
+		if (specs.Wrap == TextureWrap::Repeat)
+		{
+			glTextureParameteri(rendererID, GL_TEXTURE_WRAP_S, GL_REPEAT);
+			glTextureParameteri(rendererID, GL_TEXTURE_WRAP_T, GL_REPEAT);
+		}
+		else if (specs.Wrap == TextureWrap::Clamp)
+		{
+			glTextureParameteri(rendererID, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+			glTextureParameteri(rendererID, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		}
+	}
+
+	static GLenum CookedFormatToGLInternalFormat(CookedTextureFormat format)
+	{
+		switch (format)
+		{
+		case CookedTextureFormat::R8:    return GL_R8;
+		case CookedTextureFormat::RGB8:  return GL_RGB8;
+		case CookedTextureFormat::RGBA8: return GL_RGBA8;
+		case CookedTextureFormat::BC1:   return GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+		case CookedTextureFormat::BC3:   return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+		}
+		XYZ_ASSERT(false, "Unknown cooked texture format");
+		return 0;
+	}
+
+	static GLenum CookedFormatToGLDataFormat(CookedTextureFormat format)
+	{
+		switch (format)
+		{
+		case CookedTextureFormat::R8:    return GL_RED;
+		case CookedTextureFormat::RGB8:  return GL_RGB;
+		case CookedTextureFormat::RGBA8: return GL_RGBA;
+		default:
+			return 0;
+		}
+	}
+
 	OpenGLTexture2D::OpenGLTexture2D(const TextureSpecs& specs, const std::string& path)
 		: 
 		m_Specification(specs),
 		m_Filepath(path)
 	{
+		if (TextureCooker::HasCookedTexture(path) && loadCooked(TextureCooker::GetCookedPath(path)))
+			return;
+
 		int width, height, channels;
 		stbi_set_flip_vertically_on_load(1);	
-		m_LocalData = (uint8_t*)stbi_load(path.c_str(), &width, &height, &channels, 0);
+		AssetPackData fileData;
+		if (AssetManager::IsAssetPackMounted() && AssetManager::ReadFile(path, fileData))
+			m_LocalData = (uint8_t*)stbi_load_from_memory(fileData.Data, (int)fileData.Size, &width, &height, &channels, 0);
+		else
+			m_LocalData = (uint8_t*)stbi_load(path.c_str(), &width, &height, &channels, 0);
 
 		
 		XYZ_ASSERT(m_LocalData, "Failed to load image!");
@@ -48,35 +115,8 @@ namespace XYZ {
 		Renderer::Submit([instance]() mutable {
 			glCreateTextures(GL_TEXTURE_2D, 1, &instance->m_RendererID);
 			int levels = Texture::CalculateMipMapCount(instance->m_Width, instance->m_Height);
-			glTextureStorage2D(instance->m_RendererID, 1, instance->m_InternalFormat, instance->m_Width, instance->m_Height);
-			if (instance->m_Specification.MinParam == TextureParam::Linear)
-			{
-				glTextureParameteri(instance->m_RendererID, GL_TEXTURE_MIN_FILTER, levels > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
-			}
-			else if (instance->m_Specification.MinParam == TextureParam::Nearest)
-			{
-				glTextureParameteri(instance->m_RendererID, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-			}
-
-			if (instance->m_Specification.MagParam == TextureParam::Linear)
-			{
-				glTextureParameteri(instance->m_RendererID, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-			}
-			else if (instance->m_Specification.MagParam == TextureParam::Nearest)
-			{
-				glTextureParameteri(instance->m_RendererID, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-			}
-
-			if (instance->m_Specification.Wrap == TextureWrap::Repeat)
-			{
-				glTextureParameteri(instance->m_RendererID, GL_TEXTURE_WRAP_S, GL_REPEAT);
-				glTextureParameteri(instance->m_RendererID, GL_TEXTURE_WRAP_T, GL_REPEAT);
-			}
-			else if (instance->m_Specification.Wrap == TextureWrap::Clamp)
-			{
-				glTextureParameteri(instance->m_RendererID, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-				glTextureParameteri(instance->m_RendererID, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-			}
+			glTextureStorage2D(instance->m_RendererID, levels, instance->m_InternalFormat, instance->m_Width, instance->m_Height);
+			SetTextureParameters(instance->m_RendererID, instance->m_Specification, levels);
 			glTextureSubImage2D(instance->m_RendererID, 0, 0, 0, instance->m_Width,instance->m_Height, instance->m_DataFormat, GL_UNSIGNED_BYTE, instance->m_LocalData);
 			glGenerateTextureMipmap(instance->m_RendererID);
 
@@ -85,6 +125,52 @@ namespace XYZ {
 		});
 	}
 
+	bool OpenGLTexture2D::loadCooked(const std::string& cookedPath)
+	{
+		CookedTextureView view;
+		if (!AssetManager::ReadFile(cookedPath, m_CookedData)
+		 || !TextureCooker::Parse(m_CookedData.Data, m_CookedData.Size, view))
+		{
+			XYZ_LOG_WARN("Invalid cooked texture ", cookedPath, ", falling back to source image");
+			m_CookedData = AssetPackData();
+			return false;
+		}
+
+		m_Width = view.Header->Width;
+		m_Height = view.Header->Height;
+		m_Channels = view.Header->Channels;
+		m_InternalFormat = CookedFormatToGLInternalFormat(view.Header->Format);
+		m_DataFormat = CookedFormatToGLDataFormat(view.Header->Format);
+
+		Ref<OpenGLTexture2D> instance = this;
+		Renderer::Submit([instance, view]() mutable {
+			const uint32_t levels = view.Header->MipCount;
+			glCreateTextures(GL_TEXTURE_2D, 1, &instance->m_RendererID);
+			glTextureStorage2D(instance->m_RendererID, levels, instance->m_InternalFormat, instance->m_Width, instance->m_Height);
+			SetTextureParameters(instance->m_RendererID, instance->m_Specification, levels);
+
+			if (!view.IsCompressed())
+				glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+			for (uint32_t level = 0; level < levels; ++level)
+			{
+				const CookedTextureMip& mip = view.Mips[level];
+				if (view.IsCompressed())
+				{
+					glCompressedTextureSubImage2D(instance->m_RendererID, level, 0, 0, mip.Width, mip.Height, instance->m_InternalFormat, (GLsizei)mip.Size, view.GetMipData(level));
+				}
+				else
+				{
+					glTextureSubImage2D(instance->m_RendererID, level, 0, 0, mip.Width, mip.Height, instance->m_DataFormat, GL_UNSIGNED_BYTE, view.GetMipData(level));
+				}
+			}
+			if (!view.IsCompressed())
+				glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+			instance->m_CookedData = AssetPackData();
+		});
+		return true;
+	}
+
 	OpenGLTexture2D::OpenGLTexture2D(uint32_t width, uint32_t height, uint32_t channels, const TextureSpecs& specs)
 		: m_Width(width), m_Height(height), m_Channels(channels), m_Specification(specs)
 	{	
@@ -111,8 +197,6 @@ namespace XYZ {
 			XYZ_ASSERT("Channel is not supported ", m_Channels);
 		}
 		
-		m_LocalData.Allocate(m_Width * m_Height * m_Channels);
-
 		Ref<OpenGLTexture2D> instance = this;
 		Renderer::Submit([instance]() mutable {
 
@@ -159,13 +243,14 @@ namespace XYZ {
 
 	void OpenGLTexture2D::SetData(void* data, uint32_t size)
 	{
-		m_LocalData.ZeroInitialize();
-		m_LocalData.Write(data, size, 0);
+		// Staging copy lives only until the render thread uploads it
+		ByteBuffer buffer = ByteBuffer::Copy(data, size);
 		Ref<OpenGLTexture2D> instance = this;
-		Renderer::Submit([instance,size]() {
+		Renderer::Submit([instance, buffer, size]() mutable {
 			XYZ_ASSERT(size == instance->m_Width * instance->m_Height * instance->m_Channels, "Data must be entire texture!");
 			XYZ_ASSERT(instance->m_DataFormat && instance->m_InternalFormat, "Texture has no format or was created from frame buffer");
-			glTextureSubImage2D(instance->m_RendererID, 0, 0, 0, instance->m_Width, instance->m_Height, instance->m_DataFormat, GL_UNSIGNED_BYTE, instance->m_LocalData);
+			glTextureSubImage2D(instance->m_RendererID, 0, 0, 0, instance->m_Width, instance->m_Height, instance->m_DataFormat, GL_UNSIGNED_BYTE, buffer);
+			delete[]buffer;
 		});
 	}
 
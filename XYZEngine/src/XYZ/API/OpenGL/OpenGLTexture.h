@@ -2,6 +2,7 @@
 
 #include "XYZ/Renderer/Texture.h"
 #include "XYZ/Utils/DataStructures/ByteBuffer.h"
+#include "XYZ/Asset/AssetPack.h"
 
 #include <GL/glew.h>
 
@@ -25,6 +26,9 @@ namespace XYZ {
 		virtual const TextureSpecs& GetSpecification() const override { return m_Specification; };
 		virtual const std::string GetFilepath() const override { return m_Filepath; }
 		static void Bind(uint32_t rendererID, uint32_t slot);
+	private:
+		bool loadCooked(const std::string& cookedPath);
+
 	private:
 		uint32_t m_RendererID = 0;
 
@@ -35,6 +39,8 @@ namespace XYZ {
 		
 		GLenum m_DataFormat, m_InternalFormat;
 		ByteBuffer m_LocalData;
+		// Cooked texture data waiting for upload
+		AssetPackData m_CookedData;
 
 		std::string m_Filepath;
 	};	
@@ -17,19 +17,119 @@ namespace XYZ {
 	}
 
 	void Animation::Update(Timestep ts)
+	{
+		float time;
+		if (!Advance(ts, time))
+			return;
+
+		m_Output.resize(GetClip()->GetOutputSize());
+		Evaluate(time, m_Output.data(), m_Cursors.data());
+		Apply(m_Output.data());
+	}
+
+	bool Animation::Advance(Timestep ts, float& time)
 	{
 		if (m_CurrentTime >= m_Length)
 		{
 			if (!m_Repeat)
-				return;
-			m_CurrentTime = 0.0f;
+				return false;
+			// Large timesteps wrap around instead of restarting from zero
+			m_CurrentTime = m_Length > 0.0f ? std::fmod(m_CurrentTime, m_Length) : 0.0f;
+		}
+		time = m_CurrentTime;
+		m_CurrentTime += ts;
+		return true;
+	}
+
+	void Animation::Evaluate(float time, float* output, uint32_t* cursors) const
+	{
+		const auto& channels = m_Clip->GetChannels();
+		for (uint32_t i = 0; i < (uint32_t)channels.size(); ++i)
+		{
+			m_Clip->Sample(i, time, output, cursors[i]);
+			output += channels[i].ComponentCount;
+		}
+	}
+
+	void Animation::Apply(const float* output)
+	{
+		for (const AnimationChannel& channel : m_Clip->GetChannels())
+		{
+			switch (channel.Type)
+			{
+			case AnimationChannelType::Translation:
+				memcpy(&m_Entity.GetComponent<TransformComponent>().Translation, output, sizeof(glm::vec3));
+				break;
+			case AnimationChannelType::Rotation:
+				memcpy(&m_Entity.GetComponent<TransformComponent>().Rotation, output, sizeof(glm::vec3));
+				break;
+			case AnimationChannelType::Scale:
+				memcpy(&m_Entity.GetComponent<TransformComponent>().Scale, output, sizeof(glm::vec3));
+				break;
+			case AnimationChannelType::Color:
+				memcpy(&m_Entity.GetComponent<SpriteRenderer>().Color, output, sizeof(glm::vec4));
+				break;
+			case AnimationChannelType::SubTexture:
+				m_Entity.GetComponent<SpriteRenderer>().SubTexture = m_Clip->GetSubTexture((uint32_t)output[0]);
+				break;
+			default:
+				break;
+			}
+			output += channel.ComponentCount;
+		}
+	}
+
+	const Ref<AnimationClip>& Animation::GetClip()
+	{
+		if (m_Baked)
+			return m_Clip;
+
+		const uint32_t version = tracksVersion();
+		if (m_ClipDirty || version != m_ClipVersion || !m_Clip.Raw())
+		{
+			if (!m_Clip.Raw())
+				m_Clip = Ref<AnimationClip>::Create();
+			m_Clip->Clear();
 			for (auto& track : m_Tracks)
-				track->Reset();
+				track->Compile(*m_Clip);
+			if (m_SampleRate > 0.0f)
+				m_Clip->Resample(m_SampleRate);
+
+			m_Cursors.assign(m_Clip->GetChannels().size(), 0);
+			m_ClipVersion = version;
+			m_ClipDirty = false;
 		}
-		for (auto& track : m_Tracks)
-			track->Update(m_CurrentTime);
+		return m_Clip;
+	}
 
-		m_CurrentTime += ts;
+	bool Animation::BakeClip(const std::string& filepath, const AnimationCompressionSettings& settings)
+	{
+		XYZ_ASSERT(!m_Baked, "Animation is already baked");
+		GetClip();
+		m_Clip->Compress(settings);
+		// Tracks are released only if the saved clip can be loaded back
+		if (!m_Clip->Save(filepath) || !LoadClip(filepath))
+		{
+			m_ClipDirty = true;
+			return false;
+		}
+		return true;
+	}
+
+	bool Animation::LoadClip(const std::string& filepath)
+	{
+		Ref<AnimationClip> clip = Ref<AnimationClip>::Create();
+		if (!clip->Load(filepath))
+			return false;
+
+		m_Clip = clip;
+		m_Cursors.assign(m_Clip->GetChannels().size(), 0);
+		m_Tracks.clear();
+		m_Tracks.shrink_to_fit();
+		m_Length = m_Clip->GetLength();
+		m_ClipPath = filepath;
+		m_Baked = true;
+		return true;
 	}
 
 	void Animation::UpdateLength()
@@ -38,4 +138,11 @@ namespace XYZ {
 			m_Length = std::max(m_Length, track->Length());
 	}
 
+	uint32_t Animation::tracksVersion() const
+	{
+		uint32_t version = 0;
+		for (auto& track : m_Tracks)
+			version += track->GetVersion();
+		return version;
+	}
 }
\ No newline at end of file
@@ -2,6 +2,7 @@
 #include "XYZ/Asset/Asset.h"
 #include "XYZ/Scene/SceneEntity.h"
 #include "Track.h"
+#include "AnimationClip.h"
 
 #include <glm/glm.hpp>
 
@@ -14,10 +15,24 @@ namespace XYZ {
 		Animation(SceneEntity entity);
 
 		void Update(Timestep ts);
+		// Moves current time, returns false if animation is not playing. Time is time to evaluate
+		bool Advance(Timestep ts, float& time);
+		// Writes sampled values of all channels of the clip compiled by GetClip.
+		// Cursors hold one key hint per channel, calls with different cursors are safe in parallel
+		void Evaluate(float time, float* output, uint32_t* cursors) const;
+		// Writes evaluated values to components of the entity
+		void Apply(const float* output);
 		void UpdateLength();
 		void SetLength(float length) { m_Length = length; }
 		void SetRepeat(bool repeat) { m_Repeat = repeat; }
 		void SetCurrentTime(float time) { m_CurrentTime = time; }
+		// Zero keeps original keys, otherwise the clip is resampled for constant time key lookup
+		void SetSampleRate(float sampleRate) { m_SampleRate = sampleRate; m_ClipDirty = true; }
+		// Compiles and compresses the clip, saves it to the file and replaces tracks with the clip loaded back.
+		// Baked animation plays only its clip, tracks can not be edited anymore
+		bool BakeClip(const std::string& filepath, const AnimationCompressionSettings& settings = AnimationCompressionSettings());
+		// Replaces tracks with the clip saved by BakeClip, path of the clip is stored by scene serializer
+		bool LoadClip(const std::string& filepath);
 
 		template <typename T>
 		void CreateTrack();
@@ -29,11 +44,31 @@ namespace XYZ {
 		const Ref<T>& FindTrack() const;
 		
 		inline float GetCurrentTime() const { return m_CurrentTime; }
+		inline SceneEntity GetEntity() const { return m_Entity; }
+		inline bool IsBaked() const { return m_Baked; }
+		inline bool IsRepeating() const { return m_Repeat; }
+		inline const std::string& GetClipPath() const { return m_ClipPath; }
+
+		// Recompiles the clip if tracks changed since the last call
+		const Ref<AnimationClip>& GetClip();
+
+	private:
+		uint32_t tracksVersion() const;
 
 	private:
 		SceneEntity m_Entity;
 		std::vector<Ref<Track>> m_Tracks;
 
+		Ref<AnimationClip>	  m_Clip;
+		uint32_t			  m_ClipVersion = 0;
+		bool				  m_ClipDirty = true;
+		float				  m_SampleRate = 0.0f;
+		bool				  m_Baked = false;
+		std::string			  m_ClipPath;
+		// Used only by Update, evaluator keeps cursors in animator components
+		std::vector<uint32_t> m_Cursors;
+		std::vector<float>	  m_Output;
+
 		float m_Length;
 		float m_CurrentTime;
 		bool  m_Repeat;
@@ -44,7 +79,9 @@ namespace XYZ {
 	inline void Animation::CreateTrack()
 	{
 		static_assert(std::is_base_of<Track, T>::value, "Type T must be derived from Track base");
+		XYZ_ASSERT(!m_Baked, "Baked animation has no tracks");
 		m_Tracks.push_back(Ref<T>::Create(m_Entity));
+		m_ClipDirty = true;
 	}
 
 	template<typename T>
@@ -56,6 +93,7 @@ namespace XYZ {
 			if (dynamic_cast<T*>(it->Raw()))
 			{
 				m_Tracks.erase(it);
+				m_ClipDirty = true;
 				return;
 			}
 		}
@@ -0,0 +1,525 @@
+#include "stdafx.h"
+#include "AnimationClip.h"
+
+#include "XYZ/Renderer/SubTexture.h"
+#include "XYZ/Asset/AssetManager.h"
+
+namespace XYZ {
+
+	struct AnimationClipHeader
+	{
+		uint32_t Magic;
+		uint32_t Version;
+		uint32_t ChannelCount;
+		uint32_t TimeCount;
+		uint32_t ValueCount;
+		uint32_t QuantizedValueCount;
+		uint32_t QuantizationParamCount;
+		uint32_t SubTextureCount;
+		uint32_t OutputSize;
+		float	 Length;
+	};
+
+	template <typename T>
+	static void WriteArray(std::ofstream& stream, const std::vector<T>& values)
+	{
+		static_assert(std::is_trivially_copyable<T>::value, "Value must be trivially copyable");
+		stream.write((const char*)values.data(), values.size() * sizeof(T));
+	}
+
+	template <typename T>
+	static bool ReadArray(const std::string& data, size_t& offset, std::vector<T>& values, uint32_t count)
+	{
+		static_assert(std::is_trivially_copyable<T>::value, "Value must be trivially copyable");
+		const size_t size = (size_t)count * sizeof(T);
+		if (offset + size > data.size())
+			return false;
+		values.resize(count);
+		if (size)
+			memcpy(values.data(), data.data() + offset, size);
+		offset += size;
+		return true;
+	}
+
+	void AnimationClip::AddChannel(AnimationChannelType type, const float* times, const float* values, uint32_t keyCount)
+	{
+		XYZ_ASSERT(type != AnimationChannelType::SubTexture, "Use AddSubTextureChannel");
+		if (!keyCount)
+			return;
+
+		AnimationChannel channel;
+		channel.Type = type;
+		channel.ComponentCount = GetComponentCount(type);
+		channel.KeyOffset = (uint32_t)m_Times.size();
+		channel.ValueOffset = (uint32_t)m_Values.size();
+		channel.KeyCount = keyCount;
+
+		m_Times.insert(m_Times.end(), times, times + keyCount);
+		m_Values.insert(m_Values.end(), values, values + (size_t)keyCount * channel.ComponentCount);
+		m_Channels.push_back(channel);
+		m_OutputSize += channel.ComponentCount;
+		m_Length = std::max(m_Length, times[keyCount - 1]);
+	}
+
+	void AnimationClip::AddSubTextureChannel(const float* times, const Ref<SubTexture>* subTextures, uint32_t keyCount)
+	{
+		if (!keyCount)
+			return;
+
+		AnimationChannel channel;
+		channel.Type = AnimationChannelType::SubTexture;
+		channel.ComponentCount = GetComponentCount(AnimationChannelType::SubTexture);
+		channel.KeyOffset = (uint32_t)m_Times.size();
+		channel.KeyCount = keyCount;
+
+		m_Times.insert(m_Times.end(), times, times + keyCount);
+		// Sub textures share key offset with times
+		m_SubTextures.resize(m_Times.size() - keyCount);
+		m_SubTextures.insert(m_SubTextures.end(), subTextures, subTextures + keyCount);
+		m_Channels.push_back(channel);
+		m_OutputSize += channel.ComponentCount;
+		m_Length = std::max(m_Length, times[keyCount - 1]);
+	}
+
+	void AnimationClip::Resample(float sampleRate)
+	{
+		XYZ_ASSERT(sampleRate > 0.0f, "Sample rate must be positive");
+
+		std::vector<AnimationChannel> channels;
+		std::vector<float> times;
+		std::vector<float> values;
+		std::vector<Ref<SubTexture>> subTextures;
+		for (const AnimationChannel& original : m_Channels)
+		{
+			AnimationChannel channel = original;
+			if (channel.Type == AnimationChannelType::SubTexture)
+			{
+				channel.KeyOffset = (uint32_t)times.size();
+				times.insert(times.end(), m_Times.begin() + original.KeyOffset, m_Times.begin() + original.KeyOffset + original.KeyCount);
+				subTextures.resize(channel.KeyOffset);
+				subTextures.insert(subTextures.end(), m_SubTextures.begin() + original.KeyOffset, m_SubTextures.begin() + original.KeyOffset + original.KeyCount);
+				channels.push_back(channel);
+				continue;
+			}
+
+			const float start = original.SampleRate > 0.0f ? original.StartTime : m_Times[original.KeyOffset];
+			const float end = original.SampleRate > 0.0f
+				? original.StartTime + (float)(original.KeyCount - 1) / original.SampleRate
+				: m_Times[original.KeyOffset + original.KeyCount - 1];
+
+			const float duration = end - start;
+			const uint32_t keyCount = duration > 0.0f ? (uint32_t)std::ceil(duration * sampleRate) + 1 : 1;
+			channel.StartTime = start;
+			// Rate is adjusted so the last key lands exactly on the end
+			channel.SampleRate = keyCount > 1 ? (float)(keyCount - 1) / duration : sampleRate;
+			channel.KeyOffset = 0;
+			channel.ValueOffset = (uint32_t)values.size();
+			channel.KeyCount = keyCount;
+			channel.Quantized = false;
+			channel.ParamOffset = 0;
+
+			values.resize(values.size() + (size_t)keyCount * channel.ComponentCount);
+			uint32_t cursor = 0;
+			const uint32_t channelIndex = (uint32_t)(&original - m_Channels.data());
+			for (uint32_t i = 0; i < keyCount; ++i)
+			{
+				const float time = start + (float)i / channel.SampleRate;
+				Sample(channelIndex, time, &values[channel.ValueOffset + (size_t)i * channel.ComponentCount], cursor);
+			}
+			channels.push_back(channel);
+		}
+		m_Channels = std::move(channels);
+		m_Times = std::move(times);
+		m_Values = std::move(values);
+		m_SubTextures = std::move(subTextures);
+		m_QuantizedValues.clear();
+		m_QuantizationParams.clear();
+	}
+
+	static float CompressionTolerance(AnimationChannelType type, const AnimationCompressionSettings& settings)
+	{
+		switch (type)
+		{
+		case AnimationChannelType::Translation: return settings.TranslationTolerance;
+		case AnimationChannelType::Rotation:	return settings.RotationTolerance;
+		case AnimationChannelType::Scale:		return settings.ScaleTolerance;
+		case AnimationChannelType::Color:		return settings.ColorTolerance;
+		default:
+			return 0.0f;
+		}
+	}
+
+	// Greedy removal of keys which are within tolerance of line between the last kept key and candidate key
+	static void ReduceChannelKeys(std::vector<float>& times, std::vector<float>& values, uint32_t components, float tolerance)
+	{
+		const uint32_t count = (uint32_t)times.size();
+		if (count < 3)
+			return;
+
+		std::vector<uint32_t> kept = { 0 };
+		uint32_t anchor = 0;
+		for (uint32_t end = 2; end < count; ++end)
+		{
+			const float duration = times[end] - times[anchor];
+			bool fits = duration > 0.0f;
+			for (uint32_t key = anchor + 1; key < end && fits; ++key)
+			{
+				const float factor = (times[key] - times[anchor]) / duration;
+				for (uint32_t c = 0; c < components; ++c)
+				{
+					const float start = values[(size_t)anchor * components + c];
+					const float target = values[(size_t)end * components + c];
+					const float interpolated = start + (target - start) * factor;
+					if (std::abs(interpolated - values[(size_t)key * components + c]) > tolerance)
+					{
+						fits = false;
+						break;
+					}
+				}
+			}
+			if (!fits)
+			{
+				anchor = end - 1;
+				kept.push_back(anchor);
+			}
+		}
+		kept.push_back(count - 1);
+
+		std::vector<float> reducedTimes(kept.size());
+		std::vector<float> reducedValues(kept.size() * components);
+		for (size_t i = 0; i < kept.size(); ++i)
+		{
+			reducedTimes[i] = times[kept[i]];
+			memcpy(&reducedValues[i * components], &values[(size_t)kept[i] * components], components * sizeof(float));
+		}
+		times = std::move(reducedTimes);
+		values = std::move(reducedValues);
+	}
+
+	void AnimationClip::Compress(const AnimationCompressionSettings& settings)
+	{
+		std::vector<AnimationChannel> channels;
+		std::vector<float> times;
+		std::vector<float> values;
+		std::vector<uint16_t> quantizedValues;
+		std::vector<float> quantizationParams;
+		std::vector<Ref<SubTexture>> subTextures;
+
+		std::vector<float> keyTimes;
+		std::vector<float> keyValues;
+		for (const AnimationChannel& original : m_Channels)
+		{
+			AnimationChannel channel = original;
+			if (channel.Type == AnimationChannelType::SubTexture)
+			{
+				channel.KeyOffset = (uint32_t)times.size();
+				times.insert(times.end(), m_Times.begin() + original.KeyOffset, m_Times.begin() + original.KeyOffset + original.KeyCount);
+				subTextures.resize(channel.KeyOffset);
+				subTextures.insert(subTextures.end(), m_SubTextures.begin() + original.KeyOffset, m_SubTextures.begin() + original.KeyOffset + original.KeyCount);
+				channels.push_back(channel);
+				continue;
+			}
+
+			const uint32_t components = channel.ComponentCount;
+			const bool uniform = channel.SampleRate > 0.0f;
+			keyTimes.clear();
+			keyValues.resize((size_t)original.KeyCount * components);
+			for (uint32_t key = 0; key < original.KeyCount; ++key)
+				readKey(original, key, &keyValues[(size_t)key * components]);
+			if (!uniform)
+				keyTimes.assign(m_Times.begin() + original.KeyOffset, m_Times.begin() + original.KeyOffset + original.KeyCount);
+
+			const float tolerance = CompressionTolerance(channel.Type, settings);
+			// Uniform channels need every key to keep constant time lookup
+			if (settings.ReduceKeys && tolerance > 0.0f && !uniform)
+				ReduceChannelKeys(keyTimes, keyValues, components, tolerance * 0.5f);
+
+			channel.KeyCount = (uint32_t)(keyValues.size() / components);
+			channel.KeyOffset = (uint32_t)times.size();
+			times.insert(times.end(), keyTimes.begin(), keyTimes.end());
+
+			float minimum[4], step[4];
+			bool quantize = settings.Quantize && tolerance > 0.0f;
+			for (uint32_t c = 0; c < components && quantize; ++c)
+			{
+				float low = keyValues[c], high = keyValues[c];
+				for (uint32_t key = 1; key < channel.KeyCount; ++key)
+				{
+					low = std::min(low, keyValues[(size_t)key * components + c]);
+					high = std::max(high, keyValues[(size_t)key * components + c]);
+				}
+				minimum[c] = low;
+				step[c] = (high - low) / (float)UINT16_MAX;
+				// Rounding error is half of the step
+				quantize = step[c] <= tolerance;
+			}
+
+			channel.Quantized = quantize;
+			if (quantize)
+			{
+				channel.ParamOffset = (uint32_t)quantizationParams.size();
+				quantizationParams.insert(quantizationParams.end(), minimum, minimum + components);
+				quantizationParams.insert(quantizationParams.end(), step, step + components);
+
+				channel.ValueOffset = (uint32_t)quantizedValues.size();
+				for (size_t i = 0; i < keyValues.size(); ++i)
+				{
+					const uint32_t c = (uint32_t)(i % components);
+					const float normalized = step[c] > 0.0f ? (keyValues[i] - minimum[c]) / step[c] : 0.0f;
+					quantizedValues.push_back((uint16_t)std::min(normalized + 0.5f, (float)UINT16_MAX));
+				}
+			}
+			else
+			{
+				channel.ParamOffset = 0;
+				channel.ValueOffset = (uint32_t)values.size();
+				values.insert(values.end(), keyValues.begin(), keyValues.end());
+			}
+			channels.push_back(channel);
+		}
+		m_Channels = std::move(channels);
+		m_Times = std::move(times);
+		m_Values = std::move(values);
+		m_QuantizedValues = std::move(quantizedValues);
+		m_QuantizationParams = std::move(quantizationParams);
+		m_SubTextures = std::move(subTextures);
+	}
+
+	void AnimationClip::Clear()
+	{
+		m_Channels.clear();
+		m_Times.clear();
+		m_Values.clear();
+		m_QuantizedValues.clear();
+		m_QuantizationParams.clear();
+		m_SubTextures.clear();
+		m_OutputSize = 0;
+		m_Length = 0.0f;
+	}
+
+	bool AnimationClip::Save(const std::string& filepath) const
+	{
+		std::ofstream out(filepath, std::ios::out | std::ios::binary | std::ios::trunc);
+		if (!out)
+		{
+			XYZ_LOG_ERR("Could not write animation clip ", filepath);
+			return false;
+		}
+		AnimationClipHeader header;
+		header.Magic = sc_Magic;
+		header.Version = sc_Version;
+		header.ChannelCount = (uint32_t)m_Channels.size();
+		header.TimeCount = (uint32_t)m_Times.size();
+		header.ValueCount = (uint32_t)m_Values.size();
+		header.QuantizedValueCount = (uint32_t)m_QuantizedValues.size();
+		header.QuantizationParamCount = (uint32_t)m_QuantizationParams.size();
+		header.SubTextureCount = (uint32_t)m_SubTextures.size();
+		header.OutputSize = m_OutputSize;
+		header.Length = m_Length;
+		out.write((const char*)&header, sizeof(AnimationClipHeader));
+
+		WriteArray(out, m_Channels);
+		WriteArray(out, m_Times);
+		WriteArray(out, m_Values);
+		WriteArray(out, m_QuantizedValues);
+		WriteArray(out, m_QuantizationParams);
+
+		// Empty slots of sub texture keys are stored as zero handles
+		std::vector<uint64_t> handles(m_SubTextures.size() * 2, 0);
+		for (size_t i = 0; i < m_SubTextures.size(); ++i)
+		{
+			if (!m_SubTextures[i].Raw())
+				continue;
+			handles[i * 2] = m_SubTextures[i]->Handle.GetHigh();
+			handles[i * 2 + 1] = m_SubTextures[i]->Handle.GetLow();
+		}
+		WriteArray(out, handles);
+		return (bool)out;
+	}
+
+	bool AnimationClip::Load(const std::string& filepath)
+	{
+		std::string data;
+		if (!AssetManager::ReadFile(filepath, data) || data.size() < sizeof(AnimationClipHeader))
+		{
+			XYZ_LOG_ERR("Could not read animation clip ", filepath);
+			return false;
+		}
+		AnimationClipHeader header;
+		memcpy(&header, data.data(), sizeof(AnimationClipHeader));
+		if (header.Magic != sc_Magic || header.Version != sc_Version)
+		{
+			XYZ_LOG_ERR("Animation clip ", filepath, " has invalid format");
+			return false;
+		}
+
+		Clear();
+		size_t offset = sizeof(AnimationClipHeader);
+		std::vector<uint64_t> handles;
+		if (!ReadArray(data, offset, m_Channels, header.ChannelCount)
+		 || !ReadArray(data, offset, m_Times, header.TimeCount)
+		 || !ReadArray(data, offset, m_Values, header.ValueCount)
+		 || !ReadArray(data, offset, m_QuantizedValues, header.QuantizedValueCount)
+		 || !ReadArray(data, offset, m_QuantizationParams, header.QuantizationParamCount)
+		 || !ReadArray(data, offset, handles, header.SubTextureCount * 2))
+		{
+			XYZ_LOG_ERR("Animation clip ", filepath, " is truncated");
+			Clear();
+			return false;
+		}
+
+		m_SubTextures.resize(header.SubTextureCount);
+		uint32_t outputSize = 0;
+		for (const AnimationChannel& channel : m_Channels)
+		{
+			if (!isChannelValid(channel))
+			{
+				XYZ_LOG_ERR("Animation clip ", filepath, " has invalid channel");
+				Clear();
+				return false;
+			}
+			outputSize += channel.ComponentCount;
+		}
+		if (outputSize != header.OutputSize)
+		{
+			XYZ_LOG_ERR("Animation clip ", filepath, " has invalid output size");
+			Clear();
+			return false;
+		}
+
+		for (size_t i = 0; i < m_SubTextures.size(); ++i)
+		{
+			if (handles[i * 2] || handles[i * 2 + 1])
+				m_SubTextures[i] = AssetManager::GetAsset<SubTexture>(GUID(handles[i * 2], handles[i * 2 + 1]));
+		}
+		m_OutputSize = header.OutputSize;
+		m_Length = header.Length;
+		return true;
+	}
+
+	void AnimationClip::Sample(uint32_t channelIndex, float time, float* result, uint32_t& cursor) const
+	{
+		const AnimationChannel& channel = m_Channels[channelIndex];
+		if (channel.Type == AnimationChannelType::SubTexture)
+		{
+			// Key is displayed until its end time, the first key also before its end time
+			uint32_t key = findKey(channel, time, cursor);
+			if (time >= m_Times[channel.KeyOffset + key])
+				key = std::min(key + 1, channel.KeyCount - 1);
+			result[0] = (float)(channel.KeyOffset + key);
+			return;
+		}
+
+		uint32_t key = 0;
+		float factor = 0.0f;
+		if (channel.SampleRate > 0.0f)
+		{
+			const float position = glm::clamp((time - channel.StartTime) * channel.SampleRate, 0.0f, (float)(channel.KeyCount - 1));
+			key = std::min((uint32_t)position, channel.KeyCount > 1 ? channel.KeyCount - 2 : 0);
+			factor = position - (float)key;
+		}
+		else
+		{
+			const float* times = &m_Times[channel.KeyOffset];
+			key = findKey(channel, time, cursor);
+			if (key + 1 < channel.KeyCount)
+			{
+				// Keys with equal times step to the next value instead of dividing by zero
+				const float span = times[key + 1] - times[key];
+				factor = span > 0.0f ? glm::clamp((time - times[key]) / span, 0.0f, 1.0f) : 1.0f;
+			}
+		}
+
+		readKey(channel, key, result);
+		if (key + 1 >= channel.KeyCount)
+			return;
+
+		float next[4];
+		readKey(channel, key + 1, next);
+		for (uint32_t i = 0; i < channel.ComponentCount; ++i)
+			result[i] += (next[i] - result[i]) * factor;
+	}
+
+	size_t AnimationClip::GetMemorySize() const
+	{
+		return m_Channels.size() * sizeof(AnimationChannel)
+			 + m_Times.size() * sizeof(float)
+			 + m_Values.size() * sizeof(float)
+			 + m_QuantizedValues.size() * sizeof(uint16_t)
+			 + m_QuantizationParams.size() * sizeof(float)
+			 + m_SubTextures.size() * sizeof(Ref<SubTexture>);
+	}
+
+	uint32_t AnimationClip::GetComponentCount(AnimationChannelType type)
+	{
+		switch (type)
+		{
+		case AnimationChannelType::Translation: return 3;
+		case AnimationChannelType::Rotation:	return 3;
+		case AnimationChannelType::Scale:		return 3;
+		case AnimationChannelType::Color:		return 4;
+		case AnimationChannelType::SubTexture:	return 1;
+		}
+		XYZ_ASSERT(false, "Invalid channel type");
+		return 0;
+	}
+
+	// Returns index of the last key with time <= time, or zero if time is before the first key
+	uint32_t AnimationClip::findKey(const AnimationChannel& channel, float time, uint32_t& cursor) const
+	{
+		const float* times = &m_Times[channel.KeyOffset];
+		const uint32_t count = channel.KeyCount;
+		if (cursor + 1 < count && times[cursor] <= time)
+		{
+			if (time < times[cursor + 1])
+				return cursor;
+			if (cursor + 2 >= count || time < times[cursor + 2])
+				return ++cursor;
+		}
+		const float* it = std::upper_bound(times, times + count, time);
+		cursor = (it == times) ? 0 : (uint32_t)(it - times) - 1;
+		return cursor;
+	}
+
+	bool AnimationClip::isChannelValid(const AnimationChannel& channel) const
+	{
+		if (channel.Type >= AnimationChannelType::NumTypes
+		 || channel.ComponentCount != GetComponentCount(channel.Type)
+		 || channel.KeyCount == 0
+		 || !(channel.SampleRate >= 0.0f))
+			return false;
+
+		const uint64_t keyEnd = (uint64_t)channel.KeyOffset + channel.KeyCount;
+		if (channel.Type == AnimationChannelType::SubTexture)
+			return channel.SampleRate == 0.0f && keyEnd <= m_Times.size() && keyEnd <= m_SubTextures.size();
+		
+		// Times of resampled channels are not stored
+		if (channel.SampleRate == 0.0f && keyEnd > m_Times.size())
+			return false;
+
+		const uint64_t valueEnd = (uint64_t)channel.ValueOffset + (uint64_t)channel.KeyCount * channel.ComponentCount;
+		if (channel.Quantized)
+		{
+			return valueEnd <= m_QuantizedValues.size()
+				&& (uint64_t)channel.ParamOffset + 2 * channel.ComponentCount <= m_QuantizationParams.size();
+		}
+		return valueEnd <= m_Values.size();
+	}
+
+	void AnimationClip::readKey(const AnimationChannel& channel, uint32_t key, float* result) const
+	{
+		const uint32_t components = channel.ComponentCount;
+		if (channel.Quantized)
+		{
+			const uint16_t* quantized = &m_QuantizedValues[channel.ValueOffset + (size_t)key * components];
+			const float* minimum = &m_QuantizationParams[channel.ParamOffset];
+			const float* step = minimum + components;
+			for (uint32_t i = 0; i < components; ++i)
+				result[i] = minimum[i] + (float)quantized[i] * step[i];
+		}
+		else
+		{
+			memcpy(result, &m_Values[channel.ValueOffset + (size_t)key * components], components * sizeof(float));
+		}
+	}
+}
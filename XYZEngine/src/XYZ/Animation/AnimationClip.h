@@ -0,0 +1,116 @@
+#pragma once
+#include "XYZ/Core/Ref.h"
+#include "Track.h"
+
+#include <glm/glm.hpp>
+
+namespace XYZ {
+
+	class SubTexture;
+
+	enum class AnimationChannelType : uint8_t
+	{
+		Translation,
+		Rotation,
+		Scale,
+		Color,
+		SubTexture,
+		NumTypes
+	};
+
+	struct AnimationChannel
+	{
+		AnimationChannelType Type = AnimationChannelType::Translation;
+		uint32_t ComponentCount = 0; // Floats per key
+		uint32_t KeyOffset = 0;		 // Index of the first key time and sub texture
+		uint32_t ValueOffset = 0;	 // Index of the first float of values
+		uint32_t KeyCount = 0;
+		// Keys are placed every 1 / SampleRate seconds from StartTime if non zero, times are not stored
+		float	 SampleRate = 0.0f;
+		float	 StartTime = 0.0f;
+		// Values are 16 bit, decoded as minimum + value * step with per component parameters at ParamOffset
+		bool	 Quantized = false;
+		uint32_t ParamOffset = 0;
+	};
+
+	struct AnimationCompressionSettings
+	{
+		// Maximum error of a value, half is used by key reduction and half by quantization.
+		// Channels with zero tolerance are not compressed
+		float TranslationTolerance = 0.001f;
+		float RotationTolerance = 0.0005f;
+		float ScaleTolerance = 0.001f;
+		float ColorTolerance = 0.0f;
+		// Removes keys that can be linearly interpolated from neighbours
+		bool  ReduceKeys = true;
+		bool  Quantize = true;
+	};
+
+	// Keys of all channels stored in contiguous arrays, sampled without per track virtual calls
+	class AnimationClip : public RefCount
+	{
+	public:
+		void AddChannel(AnimationChannelType type, const float* times, const float* values, uint32_t keyCount);
+		void AddSubTextureChannel(const float* times, const Ref<SubTexture>* subTextures, uint32_t keyCount);
+		// Replaces keys of interpolated channels with keys sampled at constant rate, lookup becomes constant time
+		void Resample(float sampleRate);
+		// Reduces keys and quantizes values of interpolated channels within tolerances of settings
+		void Compress(const AnimationCompressionSettings& settings = AnimationCompressionSettings());
+		void Clear();
+
+		// Binary file, sub textures are stored as asset handles
+		bool Save(const std::string& filepath) const;
+		bool Load(const std::string& filepath);
+
+		// Writes ComponentCount floats, sub texture channel writes index for GetSubTexture.
+		// Cursor is hint of the channel for sequential playback
+		void Sample(uint32_t channel, float time, float* result, uint32_t& cursor) const;
+
+		template <typename T>
+		void AddChannel(AnimationChannelType type, const std::vector<KeyFrame<T>>& keys);
+
+		const Ref<SubTexture>&				 GetSubTexture(uint32_t index) const { return m_SubTextures[index]; }
+		const std::vector<AnimationChannel>& GetChannels() const { return m_Channels; }
+		uint32_t							 GetOutputSize() const { return m_OutputSize; }
+		float								 GetLength() const { return m_Length; }
+		size_t								 GetMemorySize() const;
+
+		static uint32_t GetComponentCount(AnimationChannelType type);
+
+		static constexpr uint32_t sc_Magic = 0x434E4158; // "XANC"
+		static constexpr uint32_t sc_Version = 1;
+
+	private:
+		uint32_t findKey(const AnimationChannel& channel, float time, uint32_t& cursor) const;
+		void	 readKey(const AnimationChannel& channel, uint32_t key, float* result) const;
+		// Checks that keys of the channel are inside of the arrays, used for loaded clips
+		bool	 isChannelValid(const AnimationChannel& channel) const;
+
+	private:
+		std::vector<AnimationChannel> m_Channels;
+		std::vector<float>			  m_Times;
+		std::vector<float>			  m_Values;
+		std::vector<uint16_t>		  m_QuantizedValues;
+		std::vector<float>			  m_QuantizationParams;
+		std::vector<Ref<SubTexture>>  m_SubTextures;
+		uint32_t					  m_OutputSize = 0;
+		float						  m_Length = 0.0f;
+	};
+
+	template<typename T>
+	inline void AnimationClip::AddChannel(AnimationChannelType type, const std::vector<KeyFrame<T>>& keys)
+	{
+		static_assert(sizeof(T) % sizeof(float) == 0, "Only float based values can be compiled");
+		constexpr uint32_t componentCount = sizeof(T) / sizeof(float);
+		XYZ_ASSERT(GetComponentCount(type) == componentCount, "Value type does not match channel type");
+
+		std::vector<float> times(keys.size());
+		std::vector<float> values(keys.size() * componentCount);
+		for (size_t i = 0; i < keys.size(); ++i)
+		{
+			times[i] = keys[i].EndTime;
+			memcpy(&values[i * componentCount], &keys[i].Value, sizeof(T));
+		}
+		AddChannel(type, times.data(), values.data(), (uint32_t)keys.size());
+	}
+}
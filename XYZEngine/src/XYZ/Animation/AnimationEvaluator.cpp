@@ -0,0 +1,73 @@
+#include "stdafx.h"
+#include "AnimationEvaluator.h"
+
+#include "Animation.h"
+#include "XYZ/Scene/Components.h"
+
+namespace XYZ {
+
+	void AnimationEvaluator::Update(ComponentStorage<AnimatorComponent>& storage, Timestep ts, ThreadPool* pool)
+	{
+		m_Animations.clear();
+		m_Cursors.clear();
+		m_Times.clear();
+		m_OutputOffsets.clear();
+
+		uint32_t outputSize = 0;
+		for (size_t i = 0; i < storage.Size(); ++i)
+		{
+			AnimatorComponent& animator = storage[i];
+			Animation* animation = animator.Animation.Raw();
+			if (!animation)
+				continue;
+
+			// Animation keeps its own time and writes to its entity, sharing it would advance it once per animator
+			const bool owned = (uint32_t)animation->GetEntity() == (uint32_t)storage.GetEntityAtIndex(i);
+			XYZ_ASSERT(owned, "Animation must be owned by animator of its entity");
+			float time;
+			if (!owned || !animation->Advance(ts, time))
+				continue;
+
+			const Ref<AnimationClip>& clip = animation->GetClip();
+			// Old hints stay valid after recompilation, lookup falls back to binary search
+			animator.Cursors.resize(clip->GetChannels().size(), 0);
+
+			m_Animations.push_back(animation);
+			m_Cursors.push_back(animator.Cursors.data());
+			m_Times.push_back(time);
+			m_OutputOffsets.push_back(outputSize);
+			outputSize += clip->GetOutputSize();
+		}
+		m_Output.resize(outputSize);
+
+		const uint32_t count = (uint32_t)m_Animations.size();
+		if (pool && count > sc_AnimationsPerJob)
+		{
+			std::vector<std::future<void>> futures;
+			for (uint32_t begin = sc_AnimationsPerJob; begin < count; begin += sc_AnimationsPerJob)
+			{
+				const uint32_t end = std::min(begin + sc_AnimationsPerJob, count);
+				futures.push_back(pool->PushJob<void>([this, begin, end]() {
+					evaluate(begin, end);
+				}));
+			}
+			evaluate(0, sc_AnimationsPerJob);
+			for (auto& future : futures)
+				future.wait();
+		}
+		else
+		{
+			evaluate(0, count);
+		}
+
+		// Component access is not thread safe, values are written on calling thread
+		for (uint32_t i = 0; i < count; ++i)
+			m_Animations[i]->Apply(m_Output.data() + m_OutputOffsets[i]);
+	}
+
+	void AnimationEvaluator::evaluate(uint32_t begin, uint32_t end)
+	{
+		for (uint32_t i = begin; i < end; ++i)
+			m_Animations[i]->Evaluate(m_Times[i], m_Output.data() + m_OutputOffsets[i], m_Cursors[i]);
+	}
+}
@@ -0,0 +1,30 @@
+#pragma once
+#include "XYZ/Core/Timestep.h"
+#include "XYZ/Core/ThreadPool.h"
+#include "XYZ/ECS/ComponentStorage.h"
+
+namespace XYZ {
+
+	class Animation;
+	struct AnimatorComponent;
+
+	// Updates animations of all animators in three passes: advancing time and compiling clips,
+	// sampling of all channels into one flat buffer split across threads, writing values to components
+	class AnimationEvaluator
+	{
+	public:
+		void Update(ComponentStorage<AnimatorComponent>& storage, Timestep ts, ThreadPool* pool = nullptr);
+
+	private:
+		void evaluate(uint32_t begin, uint32_t end);
+
+	private:
+		std::vector<Animation*> m_Animations;
+		std::vector<uint32_t*>	m_Cursors;
+		std::vector<float>		m_Times;
+		std::vector<uint32_t>	m_OutputOffsets;
+		std::vector<float>		m_Output;
+
+		static constexpr uint32_t sc_AnimationsPerJob = 256;
+	};
+}
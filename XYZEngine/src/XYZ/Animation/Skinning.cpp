@@ -0,0 +1,280 @@
+#include "stdafx.h"
+#include "Skinning.h"
+
+#include "XYZ/Renderer/SkeletalMesh.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+	#define XYZ_SKINNING_X86
+	#include <immintrin.h>
+	#ifdef _MSC_VER
+		#include <intrin.h>
+		#define XYZ_TARGET_AVX2
+	#else
+		#define XYZ_TARGET_AVX2 __attribute__((target("avx2,fma")))
+	#endif
+#endif
+
+namespace XYZ {
+
+	void SkinningStreams::Resize(uint32_t count)
+	{
+		PositionX.resize(count);
+		PositionY.resize(count);
+		PositionZ.resize(count);
+		for (uint32_t i = 0; i < sc_MaxInfluences; ++i)
+		{
+			BoneIDs[i].resize(count, 0);
+			Weights[i].resize(count, 0.0f);
+		}
+	}
+
+	void SkinningStreams::SetVertex(uint32_t index, const glm::vec3& position, const uint32_t* boneIDs, const float* weights)
+	{
+		PositionX[index] = position.x;
+		PositionY[index] = position.y;
+		PositionZ[index] = position.z;
+		for (uint32_t i = 0; i < sc_MaxInfluences; ++i)
+		{
+			BoneIDs[i][index] = boneIDs[i];
+			Weights[i][index] = weights[i];
+		}
+	}
+
+	SkinningStreams SkinningStreams::FromVertices(const std::vector<AnimatedVertex>& vertices)
+	{
+		static_assert(VertexBoneData::sc_MaxBonesPerVertex == sc_MaxInfluences);
+
+		SkinningStreams streams;
+		streams.Resize((uint32_t)vertices.size());
+		for (uint32_t i = 0; i < (uint32_t)vertices.size(); ++i)
+		{
+			const AnimatedVertex& vertex = vertices[i];
+			streams.SetVertex(i, vertex.Position, vertex.BoneData.IDs, vertex.BoneData.Weights);
+		}
+		return streams;
+	}
+
+	void SkinnedPositions::Resize(uint32_t count)
+	{
+		X.resize(count);
+		Y.resize(count);
+		Z.resize(count);
+	}
+
+	static void SkinScalar(const glm::mat4* palette, const SkinningStreams& streams, SkinnedPositions& result, uint32_t begin, uint32_t end)
+	{
+		for (uint32_t i = begin; i < end; ++i)
+		{
+			const glm::vec4 position(streams.PositionX[i], streams.PositionY[i], streams.PositionZ[i], 1.0f);
+			glm::vec4 skinned(0.0f);
+			for (uint32_t k = 0; k < SkinningStreams::sc_MaxInfluences; ++k)
+				skinned += streams.Weights[k][i] * (palette[streams.BoneIDs[k][i]] * position);
+
+			result.X[i] = skinned.x;
+			result.Y[i] = skinned.y;
+			result.Z[i] = skinned.z;
+		}
+	}
+
+#ifdef XYZ_SKINNING_X86
+	// One vertex per iteration, weighted columns of bone matrices are blended first
+	static void SkinSSE(const glm::mat4* palette, const SkinningStreams& streams, SkinnedPositions& result, uint32_t begin, uint32_t end)
+	{
+		const float* bones = &palette[0][0][0];
+		for (uint32_t i = begin; i < end; ++i)
+		{
+			__m128 column0 = _mm_setzero_ps();
+			__m128 column1 = _mm_setzero_ps();
+			__m128 column2 = _mm_setzero_ps();
+			__m128 column3 = _mm_setzero_ps();
+			for (uint32_t k = 0; k < SkinningStreams::sc_MaxInfluences; ++k)
+			{
+				const __m128 weight = _mm_set1_ps(streams.Weights[k][i]);
+				const float* bone = bones + (size_t)streams.BoneIDs[k][i] * 16;
+				column0 = _mm_add_ps(column0, _mm_mul_ps(weight, _mm_loadu_ps(bone)));
+				column1 = _mm_add_ps(column1, _mm_mul_ps(weight, _mm_loadu_ps(bone + 4)));
+				column2 = _mm_add_ps(column2, _mm_mul_ps(weight, _mm_loadu_ps(bone + 8)));
+				column3 = _mm_add_ps(column3, _mm_mul_ps(weight, _mm_loadu_ps(bone + 12)));
+			}
+			__m128 skinned = _mm_add_ps(
+				_mm_add_ps(_mm_mul_ps(column0, _mm_set1_ps(streams.PositionX[i])), _mm_mul_ps(column1, _mm_set1_ps(streams.PositionY[i]))),
+				_mm_add_ps(_mm_mul_ps(column2, _mm_set1_ps(streams.PositionZ[i])), column3)
+			);
+
+			alignas(16) float values[4];
+			_mm_store_ps(values, skinned);
+			result.X[i] = values[0];
+			result.Y[i] = values[1];
+			result.Z[i] = values[2];
+		}
+	}
+
+	// Two vertices per iteration, each half of 256 bit register holds column of one vertex
+	XYZ_TARGET_AVX2 static void SkinAVX2(const glm::mat4* palette, const SkinningStreams& streams, SkinnedPositions& result, uint32_t begin, uint32_t end)
+	{
+		const float* bones = &palette[0][0][0];
+		uint32_t i = begin;
+		for (; i + 2 <= end; i += 2)
+		{
+			__m256 column0 = _mm256_setzero_ps();
+			__m256 column1 = _mm256_setzero_ps();
+			__m256 column2 = _mm256_setzero_ps();
+			__m256 column3 = _mm256_setzero_ps();
+			for (uint32_t k = 0; k < SkinningStreams::sc_MaxInfluences; ++k)
+			{
+				const __m256 weight = _mm256_set_m128(_mm_set1_ps(streams.Weights[k][i + 1]), _mm_set1_ps(streams.Weights[k][i]));
+				const float* first = bones + (size_t)streams.BoneIDs[k][i] * 16;
+				const float* second = bones + (size_t)streams.BoneIDs[k][i + 1] * 16;
+				column0 = _mm256_fmadd_ps(weight, _mm256_loadu2_m128(second, first), column0);
+				column1 = _mm256_fmadd_ps(weight, _mm256_loadu2_m128(second + 4, first + 4), column1);
+				column2 = _mm256_fmadd_ps(weight, _mm256_loadu2_m128(second + 8, first + 8), column2);
+				column3 = _mm256_fmadd_ps(weight, _mm256_loadu2_m128(second + 12, first + 12), column3);
+			}
+			const __m256 x = _mm256_set_m128(_mm_set1_ps(streams.PositionX[i + 1]), _mm_set1_ps(streams.PositionX[i]));
+			const __m256 y = _mm256_set_m128(_mm_set1_ps(streams.PositionY[i + 1]), _mm_set1_ps(streams.PositionY[i]));
+			const __m256 z = _mm256_set_m128(_mm_set1_ps(streams.PositionZ[i + 1]), _mm_set1_ps(streams.PositionZ[i]));
+			const __m256 skinned = _mm256_fmadd_ps(column0, x, _mm256_fmadd_ps(column1, y, _mm256_fmadd_ps(column2, z, column3)));
+
+			alignas(32) float values[8];
+			_mm256_store_ps(values, skinned);
+			result.X[i] = values[0];
+			result.Y[i] = values[1];
+			result.Z[i] = values[2];
+			result.X[i + 1] = values[4];
+			result.Y[i + 1] = values[5];
+			result.Z[i + 1] = values[6];
+		}
+		SkinSSE(palette, streams, result, i, end);
+	}
+
+	static bool CPUSupportsAVX2()
+	{
+	#ifdef _MSC_VER
+		int info[4];
+		__cpuid(info, 0);
+		if (info[0] < 7)
+			return false;
+
+		__cpuid(info, 1);
+		const bool osxsave = (info[2] & (1 << 27)) != 0;
+		const bool fma = (info[2] & (1 << 12)) != 0;
+		if (!osxsave || !fma)
+			return false;
+		// Operating system must save ymm registers
+		if ((_xgetbv(0) & 0x6) != 0x6)
+			return false;
+
+		__cpuidex(info, 7, 0);
+		return (info[1] & (1 << 5)) != 0;
+	#else
+		__builtin_cpu_init();
+		return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+	#endif
+	}
+#endif
+
+	void Skinning::Skin(const glm::mat4* palette, const SkinningStreams& streams, SkinnedPositions& result, SkinningBackend backend)
+	{
+		result.Resize(streams.GetCount());
+		Skin(palette, streams, result, 0, streams.GetCount(), backend);
+	}
+
+	void Skinning::Skin(const glm::mat4* palette, const SkinningStreams& streams, SkinnedPositions& result, uint32_t begin, uint32_t end, SkinningBackend backend)
+	{
+		XYZ_ASSERT(end <= streams.GetCount() && end <= result.GetCount(), "Skinning range out of bounds");
+		if (begin >= end)
+			return;
+
+		if (backend == SkinningBackend::Auto)
+			backend = GetBestBackend();
+		XYZ_ASSERT(IsBackendSupported(backend), "Skinning backend is not supported ", GetBackendName(backend));
+
+		switch (backend)
+		{
+	#ifdef XYZ_SKINNING_X86
+		case SkinningBackend::AVX2:
+			SkinAVX2(palette, streams, result, begin, end);
+			return;
+		case SkinningBackend::SSE:
+			SkinSSE(palette, streams, result, begin, end);
+			return;
+	#endif
+		default:
+			SkinScalar(palette, streams, result, begin, end);
+			return;
+		}
+	}
+
+	void Skinning::SkinParallel(const glm::mat4* palette, const SkinningStreams& streams, SkinnedPositions& result, ThreadPool& pool, uint32_t chunkSize)
+	{
+		const uint32_t count = streams.GetCount();
+		result.Resize(count);
+
+		// Output streams are cache line aligned, chunks of whole lines do not share them
+		constexpr uint32_t lineFloats = SkinnedPositions::sc_FloatsPerCacheLine;
+		chunkSize = std::max((chunkSize + lineFloats - 1) / lineFloats * lineFloats, lineFloats);
+		const uint32_t chunkCount = (count + chunkSize - 1) / chunkSize;
+		if (chunkCount <= 1)
+		{
+			Skin(palette, streams, result, 0, count);
+			return;
+		}
+
+		const SkinningBackend backend = GetBestBackend();
+		std::vector<std::future<void>> futures;
+		futures.reserve(chunkCount - 1);
+		for (uint32_t chunk = 1; chunk < chunkCount; ++chunk)
+		{
+			const uint32_t begin = chunk * chunkSize;
+			const uint32_t end = std::min(begin + chunkSize, count);
+			futures.push_back(pool.PushJob<void>([palette, &streams, &result, begin, end, backend]() {
+				Skin(palette, streams, result, begin, end, backend);
+			}));
+		}
+		Skin(palette, streams, result, 0, chunkSize, backend);
+
+		for (auto& future : futures)
+			future.wait();
+	}
+
+	SkinningBackend Skinning::GetBestBackend()
+	{
+		static const SkinningBackend s_Best = IsBackendSupported(SkinningBackend::AVX2) ? SkinningBackend::AVX2
+											: IsBackendSupported(SkinningBackend::SSE)  ? SkinningBackend::SSE
+											: SkinningBackend::Scalar;
+		return s_Best;
+	}
+
+	bool Skinning::IsBackendSupported(SkinningBackend backend)
+	{
+		switch (backend)
+		{
+		case SkinningBackend::Scalar:
+		case SkinningBackend::Auto:
+			return true;
+	#ifdef XYZ_SKINNING_X86
+		case SkinningBackend::SSE:
+			return true;
+		case SkinningBackend::AVX2:
+		{
+			static const bool s_Supported = CPUSupportsAVX2();
+			return s_Supported;
+		}
+	#endif
+		default:
+			return false;
+		}
+	}
+
+	const char* Skinning::GetBackendName(SkinningBackend backend)
+	{
+		switch (backend)
+		{
+		case SkinningBackend::Scalar: return "Scalar";
+		case SkinningBackend::SSE:	  return "SSE";
+		case SkinningBackend::AVX2:	  return "AVX2";
+		case SkinningBackend::Auto:	  return "Auto";
+		}
+		return "Unknown";
+	}
+}
@@ -0,0 +1,90 @@
+#pragma once
+#include "XYZ/Core/ThreadPool.h"
+
+#include <glm/glm.hpp>
+
+#include <vector>
+#include <new>
+#include <stdint.h>
+
+namespace XYZ {
+
+	struct AnimatedVertex;
+
+	// Vertex data split into separate streams so multiple vertices can be processed by one instruction
+	struct SkinningStreams
+	{
+		static constexpr uint32_t sc_MaxInfluences = 4;
+
+		void	 Resize(uint32_t count);
+		void	 SetVertex(uint32_t index, const glm::vec3& position, const uint32_t* boneIDs, const float* weights);
+		uint32_t GetCount() const { return (uint32_t)PositionX.size(); }
+
+		static SkinningStreams FromVertices(const std::vector<AnimatedVertex>& vertices);
+
+		std::vector<float>	  PositionX, PositionY, PositionZ;
+		// Unused influences must have valid bone id and zero weight
+		std::vector<uint32_t> BoneIDs[sc_MaxInfluences];
+		std::vector<float>	  Weights[sc_MaxInfluences];
+	};
+
+	// Allocates elements at the start of a cache line
+	template <typename T>
+	struct CacheLineAllocator
+	{
+		using value_type = T;
+		static constexpr size_t sc_CacheLineSize = 64;
+
+		CacheLineAllocator() = default;
+		template <typename U>
+		CacheLineAllocator(const CacheLineAllocator<U>&) {}
+
+		T* allocate(size_t count) { return static_cast<T*>(::operator new(count * sizeof(T), std::align_val_t(sc_CacheLineSize))); }
+		void deallocate(T* data, size_t) { ::operator delete(data, std::align_val_t(sc_CacheLineSize)); }
+
+		template <typename U>
+		bool operator==(const CacheLineAllocator<U>&) const { return true; }
+		template <typename U>
+		bool operator!=(const CacheLineAllocator<U>&) const { return false; }
+	};
+
+	struct SkinnedPositions
+	{
+		// Number of floats in one cache line of the streams
+		static constexpr uint32_t sc_FloatsPerCacheLine = CacheLineAllocator<float>::sc_CacheLineSize / sizeof(float);
+
+		void	  Resize(uint32_t count);
+		glm::vec3 Get(uint32_t index) const { return { X[index], Y[index], Z[index] }; }
+		uint32_t  GetCount() const { return (uint32_t)X.size(); }
+
+		// Streams are cache line aligned, chunks starting at multiple of sc_FloatsPerCacheLine do not share lines
+		std::vector<float, CacheLineAllocator<float>> X, Y, Z;
+	};
+
+	enum class SkinningBackend
+	{
+		Scalar,
+		SSE,
+		AVX2,
+		Auto
+	};
+
+	// Four influence linear blend skinning of positions on cpu
+	class Skinning
+	{
+	public:
+		// Palette is indexed by bone ids of the streams, result is resized to match streams
+		static void Skin(const glm::mat4* palette, const SkinningStreams& streams, SkinnedPositions& result, SkinningBackend backend = SkinningBackend::Auto);
+		// Skins vertices in range [begin, end), result must be already resized
+		static void Skin(const glm::mat4* palette, const SkinningStreams& streams, SkinnedPositions& result, uint32_t begin, uint32_t end, SkinningBackend backend = SkinningBackend::Auto);
+		// Splits vertices into chunks processed by pool and calling thread, blocks until all chunks are done.
+		// Must not be called from job of the same pool
+		static void SkinParallel(const glm::mat4* palette, const SkinningStreams& streams, SkinnedPositions& result, ThreadPool& pool, uint32_t chunkSize = sc_DefaultChunkSize);
+
+		static SkinningBackend GetBestBackend();
+		static bool			   IsBackendSupported(SkinningBackend backend);
+		static const char*	   GetBackendName(SkinningBackend backend);
+
+		static constexpr uint32_t sc_DefaultChunkSize = 4096;
+	};
+}
@@ -1,6 +1,7 @@
 #include "stdafx.h"
 #include "SpriteRendererTrack.h"
 
+#include "AnimationClip.h"
 #include "XYZ/Scene/Components.h"
 
 namespace XYZ {
@@ -27,12 +28,27 @@ namespace XYZ {
 		length = std::max(length, m_ColorProperty.Length());
 		return length;
 	}
+	void SpriteRendererTrack::Compile(AnimationClip& clip) const
+	{
+		const auto& spriteKeys = m_SpriteProperty.GetKeys();
+		std::vector<float> times(spriteKeys.size());
+		std::vector<Ref<SubTexture>> subTextures(spriteKeys.size());
+		for (size_t i = 0; i < spriteKeys.size(); ++i)
+		{
+			times[i] = spriteKeys[i].EndTime;
+			subTextures[i] = spriteKeys[i].Value;
+		}
+		clip.AddSubTextureChannel(times.data(), subTextures.data(), (uint32_t)spriteKeys.size());
+		clip.AddChannel(AnimationChannelType::Color, m_ColorProperty.GetKeys());
+	}
 	void SpriteRendererTrack::AddKeyFrame(const KeyFrame<Ref<SubTexture>>& spriteKey)
 	{
+		m_Version++;
 		m_SpriteProperty.AddKeyFrame(spriteKey);
 	}
 	void SpriteRendererTrack::AddKeyFrame(const KeyFrame<glm::vec4>& colorKey)
 	{
+		m_Version++;
 		m_ColorProperty.AddKeyFrame(colorKey);
 	}
 }
\ No newline at end of file
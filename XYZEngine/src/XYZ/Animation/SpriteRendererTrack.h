@@ -12,6 +12,7 @@ namespace XYZ {
 		virtual bool  Update(float time) override;
 		virtual void  Reset() override;
 		virtual float Length() override;
+		virtual void  Compile(AnimationClip& clip) const override;
 
 	
 		void AddKeyFrame(const KeyFrame<Ref<SubTexture>>& spriteKey);
@@ -12,92 +12,65 @@ namespace XYZ {
 		: m_Entity(entity)
 	{}
 
-	template <>
-	bool Property<float>::Update(float& val, float time)
+	template <typename T>
+	bool Property<T>::updateInterpolated(T& val, float time)
 	{
-		size_t& current = m_CurrentFrame;
-		if (current + 1 < m_Keys.size())
+		if (m_Keys.empty())
+			return true;
+		if (time >= m_Keys.back().EndTime)
 		{
-			const KeyFrame<float>& curr = m_Keys[current];
-			const KeyFrame<float>& next = m_Keys[current + 1];
-			float length = next.EndTime - curr.EndTime;
-			float passed = time - curr.EndTime;
-
-			val = glm::lerp(curr.Value, next.Value, passed / length);
-			if (time >= next.EndTime)
-				current++;
+			val = m_Keys.back().Value;
+			return true;
+		}
+		if (time <= m_Keys.front().EndTime)
+		{
+			val = m_Keys.front().Value;
 			return false;
 		}
-		return true;
+
+		const size_t current = findKey(time);
+		const KeyFrame<T>& curr = m_Keys[current];
+		const KeyFrame<T>& next = m_Keys[current + 1];
+		float length = next.EndTime - curr.EndTime;
+		float passed = time - curr.EndTime;
+
+		// Keys with equal end times step to the next value instead of dividing by zero
+		val = glm::lerp(curr.Value, next.Value, length > 0.0f ? glm::clamp(passed / length, 0.0f, 1.0f) : 1.0f);
+		return false;
+	}
+
+	template <>
+	bool Property<float>::Update(float& val, float time)
+	{
+		return updateInterpolated(val, time);
 	}
 	template <>
 	bool Property<glm::vec2>::Update(glm::vec2& val, float time)
 	{
-		size_t& current = m_CurrentFrame;
-		if (current + 1 < m_Keys.size())
-		{
-			const KeyFrame<glm::vec2>& curr = m_Keys[current];
-			const KeyFrame<glm::vec2>& next = m_Keys[current + 1];
-			float length = next.EndTime - curr.EndTime;
-			float passed = time - curr.EndTime;
-
-			val = glm::lerp(curr.Value, next.Value, passed / length);
-			if (time >= next.EndTime)
-				current++;
-			return false;
-		}
-		return true;
+		return updateInterpolated(val, time);
 	}
-
+	template <>
 	bool Property<glm::vec3>::Update(glm::vec3& val, float time)
 	{
-		size_t& current = m_CurrentFrame;
-		if (current + 1 < m_Keys.size())
-		{
-			const KeyFrame<glm::vec3>& curr = m_Keys[current];
-			const KeyFrame<glm::vec3>& next = m_Keys[current + 1];
-			float length = next.EndTime - curr.EndTime;
-			float passed = time - curr.EndTime;
-
-			val = glm::lerp(curr.Value, next.Value, passed / length);
-			if (time >= next.EndTime)
-				current++;
-			return false;
-		}
-		return true;
+		return updateInterpolated(val, time);
 	}
-
+	template <>
 	bool Property<glm::vec4>::Update(glm::vec4& val, float time)
 	{
-		size_t& current = m_CurrentFrame;
-		if (current + 1 < m_Keys.size())
-		{
-			const KeyFrame<glm::vec4>& curr = m_Keys[current];
-			const KeyFrame<glm::vec4>& next = m_Keys[current + 1];
-			float length = next.EndTime - curr.EndTime;
-			float passed = time - curr.EndTime;
-
-			val = glm::lerp(curr.Value, next.Value, passed / length);
-			if (time >= next.EndTime)
-				current++;
-			return false;
-		}
-		return true;
+		return updateInterpolated(val, time);
 	}
 
+	template <>
 	bool Property<Ref<SubTexture>>::Update(Ref<SubTexture>& val, float time)
 	{
-		size_t& current = m_CurrentFrame;
-		if (current + 1 < m_Keys.size())
-		{
-			const KeyFrame<Ref<SubTexture>>& curr = m_Keys[current];
-			if (time >= curr.EndTime)
-			{
-				val = m_Keys[current + 1].Value;
-				current++;
-			}
-			return false;
-		}
-		return true;
+		if (m_Keys.empty())
+			return true;
+
+		// Key is displayed until its end time, the first key also before its end time
+		size_t current = findKey(time);
+		if (time >= m_Keys[current].EndTime)
+			current = std::min(current + 1, m_Keys.size() - 1);
+		val = m_Keys[current].Value;
+		return time >= m_Keys.back().EndTime;
 	}
 }
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include "XYZ/Scene/SceneEntity.h"
 
 namespace XYZ {
+	class AnimationClip;
 	class Track : public RefCount
 	{
 	public:
@@ -12,9 +13,15 @@ namespace XYZ {
 		virtual bool  Update(float time) = 0;
 		virtual void  Reset() = 0;
 		virtual float Length() = 0;
+		// Appends channels of the track to the clip
+		virtual void  Compile(AnimationClip& clip) const = 0;
+
+		// Incremented whenever keys change, compiled clips compare it to detect changes
+		uint32_t GetVersion() const { return m_Version; }
 
 	protected:
 		SceneEntity m_Entity;
+		uint32_t	m_Version = 0;
 	};
 
 	template <typename T>
@@ -40,13 +47,21 @@ namespace XYZ {
 	public:
 		Property() = default;
 
+		// Time can be arbitrary, returns true when time is past the last key
 		bool  Update(T& val, float time);
 		void  Reset() { m_CurrentFrame = 0; }
 		void  AddKeyFrame(const KeyFrame<T>& key) { m_Keys.push_back(key); }
 		float Length() const;
 
+		const std::vector<KeyFrame<T>>& GetKeys() const { return m_Keys; }
+
+	private:
+		size_t findKey(float time);
+		bool   updateInterpolated(T& val, float time);
+
 	private:
 		std::vector<KeyFrame<T>> m_Keys;
+		// Hint for sequential playback, not required for correct result
 		size_t m_CurrentFrame = 0;
 	};
 
@@ -58,4 +73,24 @@ namespace XYZ {
 			return 0.0f;
 		return m_Keys.back().EndTime;
 	}
+
+	// Returns index of the last key with EndTime <= time, or zero if time is before the first key
+	template<typename T>
+	inline size_t Property<T>::findKey(float time)
+	{
+		size_t& cursor = m_CurrentFrame;
+		const size_t count = m_Keys.size();
+		if (cursor + 1 < count && m_Keys[cursor].EndTime <= time)
+		{
+			if (time < m_Keys[cursor + 1].EndTime)
+				return cursor;
+			if (cursor + 2 >= count || time < m_Keys[cursor + 2].EndTime)
+				return ++cursor;
+		}
+		auto it = std::upper_bound(m_Keys.begin(), m_Keys.end(), time, [](float t, const KeyFrame<T>& key) {
+			return t < key.EndTime;
+		});
+		cursor = (it == m_Keys.begin()) ? 0 : (size_t)(it - m_Keys.begin()) - 1;
+		return cursor;
+	}
 }
\ No newline at end of file
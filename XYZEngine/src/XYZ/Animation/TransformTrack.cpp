@@ -1,6 +1,7 @@
 #include "stdafx.h"
 #include "TransformTrack.h"
 
+#include "AnimationClip.h"
 #include "XYZ/Scene/Components.h"
 
 #include <glm/glm.hpp>
@@ -37,9 +38,17 @@ namespace XYZ {
 		return length;
 	}
 
+	void TransformTrack::Compile(AnimationClip& clip) const
+	{
+		clip.AddChannel(AnimationChannelType::Translation, m_TranslationProperty.GetKeys());
+		clip.AddChannel(AnimationChannelType::Rotation, m_RotationProperty.GetKeys());
+		clip.AddChannel(AnimationChannelType::Scale, m_ScaleProperty.GetKeys());
+	}
+
 
 	void TransformTrack::AddKeyFrame(const KeyFrame<glm::vec3>& key, PropertyType type)
 	{
+		m_Version++;
 		switch (type)
 		{
 		case XYZ::TransformTrack::PropertyType::Translation:
@@ -1,5 +1,6 @@
 #include "stdafx.h"
 #include "AssetManager.h"
+#include "XYZ/Renderer/TextureCooker.h"
 
 #include <filesystem>
 
@@ -14,8 +15,10 @@ namespace XYZ
 	std::unordered_map<GUID, Ref<Asset>> AssetManager::s_LoadedAssets;
 	std::unordered_map<GUID, AssetDirectory> AssetManager::s_Directories;
 	std::unordered_map<std::string, AssetType> AssetManager::s_AssetTypes;
+	AssetRegistry AssetManager::s_Registry;
+	AssetPack AssetManager::s_Pack;
 
-	void AssetManager::Init()
+	void AssetManager::Init(bool mountAssetPack)
 	{
 		s_AssetTypes["xyz"]    = AssetType::Scene;
 		s_AssetTypes["tex"]    = AssetType::Texture;
@@ -27,14 +30,29 @@ namespace XYZ
 		s_AssetTypes["skm"]    = AssetType::SkeletalMesh;
 
 		RefAllocator::Init(&s_Pool);
+		// Editor always works with loose files, only runtime applications read from the pack
+		if (mountAssetPack && std::filesystem::exists(sc_AssetPackPath) && s_Pack.Open(sc_AssetPackPath))
+		{
+			processAssetPack();
+			return;
+		}
+		s_Registry.LoadCache(sc_RegistryCachePath);
+
 		AssetDirectory newDirectory;
 		newDirectory.FilePath = "Assets";
 		s_Directories[newDirectory.Handle] = newDirectory;
-		processDirectory("Assets", newDirectory);
+		s_Registry.InsertDirectory(newDirectory);
+		processDirectory("Assets", s_Directories[newDirectory.Handle]);
+
+		if (s_Registry.IsCacheDirty())
+			s_Registry.SaveCache(sc_RegistryCachePath);
 	}
 	void AssetManager::Shutdown()
 	{
 		s_LoadedAssets.clear();
+		s_Registry.Clear();
+		s_Directories.clear();
+		s_Pack.Close();
 		RefAllocator::Shutdown();
 	}
 
@@ -48,11 +66,9 @@ namespace XYZ
 
 	GUID AssetManager::GetAssetHandle(const std::string& filepath)
 	{
-		for (auto& [id, asset] : s_LoadedAssets)
-		{
-			if (asset->FilePath == filepath)
-				return id;
-		}
+		GUID handle;
+		if (s_Registry.FindHandle(filepath, handle))
+			return handle;
 
 		XYZ_ASSERT(false, "");
 		return GUID();
@@ -60,11 +76,9 @@ namespace XYZ
 
 	GUID AssetManager::GetDirectoryHandle(const std::string& filepath)
 	{
-		for (auto& [id, dir] : s_Directories)
-		{
-			if (dir.FilePath == filepath)
-				return id;
-		}
+		GUID handle;
+		if (s_Registry.FindDirectoryHandle(filepath, handle))
+			return handle;
 
 		XYZ_ASSERT(false, "");
 		return GUID();
@@ -72,11 +86,14 @@ namespace XYZ
 
 	std::vector<Ref<Asset>> AssetManager::FindAssetsByType(AssetType type)
 	{
+		const auto& handles = s_Registry.GetHandlesByType(type);
 		std::vector<Ref<Asset>> assets;
-		for (auto& [id, asset] : s_LoadedAssets)
+		assets.reserve(handles.size());
+		for (const GUID& handle : handles)
 		{
-			if (asset->Type == type)
-				assets.push_back(asset);
+			auto it = s_LoadedAssets.find(handle);
+			if (it != s_LoadedAssets.end())
+				assets.push_back(it->second);
 		}
 		return assets;
 	}
@@ -97,6 +114,113 @@ namespace XYZ
 	}
 
 
+	bool AssetManager::FileExists(const std::string& filepath)
+	{
+		if (s_Pack.IsOpen() && s_Pack.Exists(filepath))
+			return true;
+		return std::filesystem::exists(filepath);
+	}
+
+	bool AssetManager::ReadFile(const std::string& filepath, std::string& result)
+	{
+		// Files missing from the pack are read from disk
+		if (s_Pack.IsOpen() && s_Pack.Read(filepath, result))
+			return true;
+
+		std::ifstream in(filepath, std::ios::in | std::ios::binary);
+		if (!in)
+			return false;
+
+		in.seekg(0, std::ios::end);
+		result.resize((size_t)in.tellg());
+		in.seekg(0, std::ios::beg);
+		in.read(result.data(), result.size());
+		return true;
+	}
+
+	bool AssetManager::ReadFile(const std::string& filepath, AssetPackData& data)
+	{
+		if (s_Pack.IsOpen() && s_Pack.Read(filepath, data))
+			return true;
+
+		std::ifstream in(filepath, std::ios::in | std::ios::binary);
+		if (!in)
+			return false;
+
+		in.seekg(0, std::ios::end);
+		data.Storage.resize((size_t)in.tellg());
+		in.seekg(0, std::ios::beg);
+		in.read((char*)data.Storage.data(), data.Storage.size());
+		data.Data = data.Storage.data();
+		data.Size = data.Storage.size();
+		return true;
+	}
+
+	bool AssetManager::BuildAssetPack(const std::string& outputPath, const AssetPackBuilder::Options& options)
+	{
+		XYZ_ASSERT(!s_Pack.IsOpen(), "Can not build asset pack from mounted asset pack");
+		// Ship cooked textures so runtime skips decoding and mip generation
+		uint32_t cookedCount = TextureCooker::CookDirectory("Assets");
+		XYZ_LOG_INFO("Cooked ", cookedCount, " textures");
+
+		AssetPackBuilder builder(options);
+		for (auto& it : std::filesystem::recursive_directory_iterator("Assets"))
+		{
+			if (it.is_directory())
+				continue;
+
+			std::string path = it.path().string();
+			std::replace(path.begin(), path.end(), '\\', '/');
+			// Meta data are stored in the pack index
+			if (Utils::GetExtension(path) == "meta")
+				continue;
+
+			GUID handle;
+			if (s_Registry.FindHandle(path, handle))
+				builder.AddFile(path, path, &handle, s_LoadedAssets[handle]->Type);
+			else
+				builder.AddFile(path, path);
+		}
+		XYZ_LOG_INFO("Packing ", builder.GetNumEntries(), " files to ", outputPath);
+		return builder.Write(outputPath);
+	}
+
+	void AssetManager::processAssetPack()
+	{
+		for (auto& entry : s_Pack.GetAssetEntries())
+		{
+			Ref<Asset> asset = Ref<Asset>::Create();
+			asset->Handle = entry.Handle;
+			asset->Type = entry.Type;
+			asset->FilePath = entry.Path;
+			asset->FileExtension = Utils::GetExtension(entry.Path);
+			asset->FileName = Utils::RemoveExtension(Utils::GetFilename(entry.Path));
+			asset->DirectoryHandle = getOrCreateDirectory(Utils::GetDirectoryPath(entry.Path));
+			asset->IsLoaded = false;
+			s_LoadedAssets[asset->Handle] = asset;
+			s_Registry.Insert(asset);
+		}
+	}
+
+	GUID AssetManager::getOrCreateDirectory(const std::string& path)
+	{
+		GUID handle;
+		if (s_Registry.FindDirectoryHandle(path, handle))
+			return handle;
+
+		AssetDirectory newDirectory;
+		newDirectory.FilePath = path;
+		auto lastSlash = path.find_last_of('/');
+		if (lastSlash != std::string::npos)
+		{
+			newDirectory.ParentHandle = getOrCreateDirectory(path.substr(0, lastSlash));
+			s_Directories[newDirectory.ParentHandle].SubDirectoryHandles.push_back(newDirectory.Handle);
+		}
+		s_Directories[newDirectory.Handle] = newDirectory;
+		s_Registry.InsertDirectory(newDirectory);
+		return newDirectory.Handle;
+	}
+
 	void AssetManager::processDirectory(const std::string& path, AssetDirectory& directory)
 	{
 		for (auto it : std::filesystem::directory_iterator(path))
@@ -109,32 +233,70 @@ namespace XYZ
 				newDirectory.ParentHandle = directory.ParentHandle;
 				directory.SubDirectoryHandles.push_back(newDirectory.Handle);
 				s_Directories[newDirectory.Handle] = newDirectory;
+				s_Registry.InsertDirectory(newDirectory);
 
 				processDirectory(it.path().string(), s_Directories[newDirectory.Handle]);
 			}
 			else
 			{
-				importAsset(it.path().string());
+				importAsset(it.path().string(), directory.Handle);
 			}
 		}
 	}
-	void AssetManager::importAsset(const std::string& path)
+	void AssetManager::importAsset(const std::string& path, const GUID& directoryHandle)
 	{
 		std::string extension = Utils::GetExtension(path);
 		if (extension == "meta")
 			return;
-		if (s_AssetTypes.find(extension) == s_AssetTypes.end())
+		auto typeIt = s_AssetTypes.find(extension);
+		if (typeIt == s_AssetTypes.end())
 			return;
 
-		AssetType type = s_AssetTypes[extension];
-		Ref<Asset> asset = AssetSerializer::LoadAssetMeta(path, GUID(), type);
-		if (s_LoadedAssets.find(asset->Handle) != s_LoadedAssets.end())
+		AssetType type = typeIt->second;
+		std::string metaPath = path + ".meta";
+		std::replace(metaPath.begin(), metaPath.end(), '\\', '/');
+
+		Ref<Asset> asset;
+		AssetMetaRecord record;
+		bool hasStats = AssetRegistry::GetFileStats(metaPath, record.WriteTime, record.Size);
+		const AssetMetaRecord* cached = hasStats ? s_Registry.FindMetaRecord(metaPath, record.WriteTime, record.Size) : nullptr;
+		if (cached)
+		{
+			// Meta file did not change since the last scan, skip parsing it
+			asset = Ref<Asset>::Create();
+			asset->Handle = cached->Handle;
+			asset->Type = cached->Type;
+			asset->FilePath = cached->FilePath;
+			asset->FileExtension = extension;
+			asset->FileName = Utils::RemoveExtension(Utils::GetFilename(path));
+			asset->DirectoryHandle = directoryHandle;
+			asset->IsLoaded = false;
+		}
+		else
+		{
+			asset = AssetSerializer::LoadAssetMeta(path, directoryHandle, type);
+			// Meta file might have been created just now
+			hasStats = AssetRegistry::GetFileStats(metaPath, record.WriteTime, record.Size);
+		}
+
+		if (hasStats)
+		{
+			record.Handle = asset->Handle;
+			record.Type = asset->Type;
+			record.FilePath = asset->FilePath;
+			s_Registry.RecordMeta(metaPath, record);
+		}
+
+		auto loadedIt = s_LoadedAssets.find(asset->Handle);
+		if (loadedIt != s_LoadedAssets.end())
 		{
-			if (s_LoadedAssets[asset->Handle]->IsLoaded)
+			s_Registry.Remove(loadedIt->second);
+			if (loadedIt->second->IsLoaded)
 			{
 				asset = AssetSerializer::LoadAsset(asset);
 			}
 		}
 		s_LoadedAssets[asset->Handle] = asset;
+		s_Registry.Insert(asset);
 	}
 }
\ No newline at end of file
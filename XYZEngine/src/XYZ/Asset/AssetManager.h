@@ -6,6 +6,8 @@
 #include "XYZ/Renderer/Texture.h"
 #include "XYZ/Renderer/SkeletalMesh.h"
 #include "AssetSerializer.h"
+#include "AssetRegistry.h"
+#include "AssetPack.h"
 #include "Asset.h"
 
 namespace XYZ {
@@ -42,7 +44,7 @@ namespace XYZ {
 	class AssetManager
 	{
 	public:
-		static void Init();
+		static void Init(bool mountAssetPack = false);
 		static void Shutdown();
 
 
@@ -53,13 +55,31 @@ namespace XYZ {
 		static bool	     IsValidExtension(const std::string& extension);
 		static void		 LoadAsset(const GUID& assetHandle);
 
+		// Reads from the mounted asset pack if there is one, otherwise from disk
+		static bool		 FileExists(const std::string& filepath);
+		static bool		 ReadFile(const std::string& filepath, std::string& result);
+		static bool		 ReadFile(const std::string& filepath, AssetPackData& data);
+		static bool		 BuildAssetPack(const std::string& outputPath, const AssetPackBuilder::Options& options = AssetPackBuilder::Options());
+		static bool		 IsAssetPackMounted() { return s_Pack.IsOpen(); }
+		static const char* GetAssetPackPath() { return sc_AssetPackPath; }
+
 		template<typename T, typename... Args>
 		static Ref<T> CreateAsset(const std::string& filename, AssetType type, const GUID& directoryHandle, Args&&... args)
 		{
 			static_assert(std::is_base_of<Asset, T>::value, "CreateAsset only works for types derived from Asset");
 
-			auto& directory = s_Directories[directoryHandle];
 			Ref<T> asset = Helper::CreateRef<T>(std::forward<Args>(args)...);
+			RegisterAsset(asset, filename, type, directoryHandle);
+			return asset;
+		}
+
+		// Registers and serializes asset created outside of the asset manager, for example by a factory function
+		template<typename T>
+		static void RegisterAsset(Ref<T> asset, const std::string& filename, AssetType type, const GUID& directoryHandle)
+		{
+			static_assert(std::is_base_of<Asset, T>::value, "RegisterAsset only works for types derived from Asset");
+
+			auto& directory = s_Directories[directoryHandle];
 			asset->Type = type;
 			asset->FilePath = directory.FilePath + "/" + filename;
 			asset->FileName = Utils::RemoveExtension(Utils::GetFilename(asset->FilePath));
@@ -68,8 +88,8 @@ namespace XYZ {
 			asset->Handle = GUID();
 			asset->IsLoaded = true;
 			s_LoadedAssets[asset->Handle] = asset;
+			s_Registry.Insert(asset);
 			AssetSerializer::SerializeAsset(asset);
-			return asset;
 		}
 		
 		template<typename T>
@@ -89,7 +109,9 @@ namespace XYZ {
 
 	private:
 		static void processDirectory(const std::string& path, AssetDirectory& directory);
-		static void importAsset(const std::string& path);
+		static void processAssetPack();
+		static GUID getOrCreateDirectory(const std::string& path);
+		static void importAsset(const std::string& path, const GUID& directoryHandle);
 
 		
 
@@ -98,5 +120,10 @@ namespace XYZ {
 		static std::unordered_map<GUID, Ref<Asset>> s_LoadedAssets;
 		static std::unordered_map<GUID, AssetDirectory> s_Directories;
 		static std::unordered_map<std::string, AssetType> s_AssetTypes;
+		static AssetRegistry s_Registry;
+		static AssetPack s_Pack;
+
+		static constexpr const char* sc_RegistryCachePath = "AssetRegistry.cache";
+		static constexpr const char* sc_AssetPackPath = "Assets.xyzpak";
 	};
 }
\ No newline at end of file
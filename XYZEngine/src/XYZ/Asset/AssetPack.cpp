@@ -0,0 +1,271 @@
+#include "stdafx.h"
+#include "AssetPack.h"
+
+#include "XYZ/Utils/Compression.h"
+
+namespace XYZ {
+
+	static uint64_t AlignOffset(uint64_t offset, uint32_t alignment)
+	{
+		return (offset + alignment - 1) / alignment * alignment;
+	}
+
+	static void WritePadding(std::ofstream& stream, uint64_t& offset, uint32_t alignment)
+	{
+		static const char s_Zeros[256] = { 0 };
+		uint64_t aligned = AlignOffset(offset, alignment);
+		while (offset < aligned)
+		{
+			uint64_t count = std::min<uint64_t>(aligned - offset, sizeof(s_Zeros));
+			stream.write(s_Zeros, count);
+			offset += count;
+		}
+	}
+
+	// Checks without overflow that [offset, offset + length) lies inside of size
+	static bool IsRangeValid(uint64_t offset, uint64_t length, uint64_t size)
+	{
+		return offset <= size && length <= size - offset;
+	}
+
+	bool AssetPack::Open(const std::string& filepath)
+	{
+		Close();
+		if (!m_File.Open(filepath))
+		{
+			XYZ_LOG_ERR("Could not open asset pack ", filepath);
+			return false;
+		}
+
+		const uint8_t* data = m_File.GetData();
+		const size_t size = m_File.GetSize();
+		if (size < sizeof(AssetPackHeader))
+		{
+			XYZ_LOG_ERR("Invalid asset pack ", filepath);
+			Close();
+			return false;
+		}
+
+		m_Header = (const AssetPackHeader*)data;
+		if (m_Header->Magic != sc_Magic || m_Header->Version != sc_Version
+			|| !IsRangeValid(m_Header->EntryTableOffset, (uint64_t)m_Header->EntryCount * sizeof(AssetPackEntry), size)
+			|| !IsRangeValid(m_Header->StringTableOffset, m_Header->StringTableSize, size))
+		{
+			XYZ_LOG_ERR("Invalid asset pack ", filepath);
+			Close();
+			return false;
+		}
+
+		m_Entries = (const AssetPackEntry*)(data + m_Header->EntryTableOffset);
+		m_Strings = (const char*)(data + m_Header->StringTableOffset);
+		m_EntryMap.reserve(m_Header->EntryCount);
+		for (uint32_t i = 0; i < m_Header->EntryCount; ++i)
+		{
+			const AssetPackEntry& entry = m_Entries[i];
+			if (!IsRangeValid(entry.PathOffset, entry.PathLength, m_Header->StringTableSize)
+				|| !IsRangeValid(entry.HandleOffset, entry.HandleLength, m_Header->StringTableSize)
+				|| !IsRangeValid(entry.Offset, entry.Size, size)
+				|| (entry.Compression == AssetPackCompression::None && entry.UncompressedSize != entry.Size)
+				|| (entry.Compression != AssetPackCompression::None && entry.Compression != AssetPackCompression::LZ))
+			{
+				XYZ_LOG_ERR("Invalid asset pack ", filepath, " entry ", i);
+				Close();
+				return false;
+			}
+			m_EntryMap[std::string_view(m_Strings + entry.PathOffset, entry.PathLength)] = i;
+		}
+		return true;
+	}
+
+	void AssetPack::Close()
+	{
+		m_EntryMap.clear();
+		m_Header = nullptr;
+		m_Entries = nullptr;
+		m_Strings = nullptr;
+		m_File.Close();
+	}
+
+	bool AssetPack::Exists(const std::string& filepath) const
+	{
+		return findEntry(filepath) != nullptr;
+	}
+
+	bool AssetPack::Read(const std::string& filepath, AssetPackData& data) const
+	{
+		const AssetPackEntry* entry = findEntry(filepath);
+		if (!entry)
+			return false;
+		if (entry->Offset + entry->Size > m_File.GetSize())
+		{
+			XYZ_LOG_ERR("Corrupted asset pack entry ", filepath);
+			return false;
+		}
+
+		const uint8_t* payload = m_File.GetData() + entry->Offset;
+		if (entry->Compression == AssetPackCompression::None)
+		{
+			data.Data = payload;
+			data.Size = (size_t)entry->Size;
+			data.Storage.clear();
+			return true;
+		}
+
+		data.Storage.resize((size_t)entry->UncompressedSize);
+		if (!Utils::Decompress(payload, (size_t)entry->Size, data.Storage.data(), data.Storage.size()))
+		{
+			XYZ_LOG_ERR("Corrupted asset pack entry ", filepath);
+			data.Storage.clear();
+			return false;
+		}
+		data.Data = data.Storage.data();
+		data.Size = data.Storage.size();
+		return true;
+	}
+
+	bool AssetPack::Read(const std::string& filepath, std::string& result) const
+	{
+		AssetPackData data;
+		if (!Read(filepath, data))
+			return false;
+
+		result.assign((const char*)data.Data, data.Size);
+		return true;
+	}
+
+	std::vector<AssetPack::EntryInfo> AssetPack::GetAssetEntries() const
+	{
+		std::vector<EntryInfo> result;
+		if (!m_Header)
+			return result;
+
+		for (uint32_t i = 0; i < m_Header->EntryCount; ++i)
+		{
+			const AssetPackEntry& entry = m_Entries[i];
+			if (!entry.HandleLength)
+				continue;
+
+			EntryInfo info;
+			info.Path = std::string(m_Strings + entry.PathOffset, entry.PathLength);
+			info.Handle = GUID(std::string(m_Strings + entry.HandleOffset, entry.HandleLength));
+			info.Type = (AssetType)entry.Type;
+			result.push_back(std::move(info));
+		}
+		return result;
+	}
+
+	const AssetPackEntry* AssetPack::findEntry(const std::string& filepath) const
+	{
+		auto it = m_EntryMap.find(std::string_view(filepath));
+		if (it != m_EntryMap.end())
+			return &m_Entries[it->second];
+		return nullptr;
+	}
+
+
+	AssetPackBuilder::AssetPackBuilder(const Options& options)
+		: m_Options(options)
+	{
+		XYZ_ASSERT(m_Options.Alignment && !(m_Options.Alignment & (m_Options.Alignment - 1)), "Alignment must be power of two");
+	}
+
+	AssetPackBuilder::AssetPackBuilder()
+		: AssetPackBuilder(Options())
+	{
+	}
+
+	bool AssetPackBuilder::AddFile(const std::string& filepath, const std::string& packPath, const GUID* handle, AssetType type)
+	{
+		std::ifstream in(filepath, std::ios::in | std::ios::binary);
+		if (!in)
+		{
+			XYZ_LOG_WARN("Could not pack file ", filepath);
+			return false;
+		}
+		in.seekg(0, std::ios::end);
+		size_t size = (size_t)in.tellg();
+		in.seekg(0, std::ios::beg);
+
+		Entry entry;
+		entry.Path = packPath;
+		entry.Handle = handle ? (std::string)*handle : std::string();
+		entry.Type = type;
+		entry.Compression = AssetPackCompression::None;
+		entry.UncompressedSize = size;
+		entry.Data.resize(size);
+		in.read((char*)entry.Data.data(), size);
+
+		if (m_Options.Compress && size)
+		{
+			std::vector<uint8_t> compressed;
+			size_t compressedSize = Utils::Compress(entry.Data.data(), size, compressed);
+			if ((float)compressedSize < (float)size * m_Options.MinCompressionRatio)
+			{
+				entry.Data = std::move(compressed);
+				entry.Compression = AssetPackCompression::LZ;
+			}
+		}
+		m_Entries.push_back(std::move(entry));
+		return true;
+	}
+
+	bool AssetPackBuilder::Write(const std::string& filepath) const
+	{
+		std::ofstream out(filepath, std::ios::out | std::ios::binary | std::ios::trunc);
+		if (!out)
+		{
+			XYZ_LOG_ERR("Could not create asset pack ", filepath);
+			return false;
+		}
+
+		AssetPackHeader header = {};
+		header.Magic = AssetPack::sc_Magic;
+		header.Version = AssetPack::sc_Version;
+		header.EntryCount = (uint32_t)m_Entries.size();
+		header.Alignment = m_Options.Alignment;
+		// Patched after payloads are written
+		header.EntryTableOffset = 0;
+		header.StringTableOffset = 0;
+		header.StringTableSize = 0;
+		out.write((const char*)&header, sizeof(AssetPackHeader));
+
+		uint64_t offset = sizeof(AssetPackHeader);
+		std::string strings;
+		std::vector<AssetPackEntry> table;
+		table.reserve(m_Entries.size());
+		for (const Entry& entry : m_Entries)
+		{
+			WritePadding(out, offset, m_Options.Alignment);
+
+			AssetPackEntry packEntry = {};
+			packEntry.Offset = offset;
+			packEntry.Size = entry.Data.size();
+			packEntry.UncompressedSize = entry.UncompressedSize;
+			packEntry.PathOffset = (uint32_t)strings.size();
+			packEntry.PathLength = (uint32_t)entry.Path.size();
+			strings += entry.Path;
+			packEntry.HandleOffset = (uint32_t)strings.size();
+			packEntry.HandleLength = (uint32_t)entry.Handle.size();
+			strings += entry.Handle;
+			packEntry.Type = (int32_t)entry.Type;
+			packEntry.Compression = entry.Compression;
+			table.push_back(packEntry);
+
+			out.write((const char*)entry.Data.data(), entry.Data.size());
+			offset += entry.Data.size();
+		}
+
+		WritePadding(out, offset, alignof(AssetPackEntry));
+		header.EntryTableOffset = offset;
+		out.write((const char*)table.data(), table.size() * sizeof(AssetPackEntry));
+		offset += table.size() * sizeof(AssetPackEntry);
+
+		header.StringTableOffset = offset;
+		header.StringTableSize = strings.size();
+		out.write(strings.data(), strings.size());
+
+		out.seekp(0, std::ios::beg);
+		out.write((const char*)&header, sizeof(AssetPackHeader));
+		return (bool)out;
+	}
+}
@@ -0,0 +1,115 @@
+#pragma once
+#include "Asset.h"
+#include "XYZ/Utils/MemoryMappedFile.h"
+
+#include <unordered_map>
+
+namespace XYZ {
+
+	enum class AssetPackCompression : uint32_t
+	{
+		None,
+		LZ
+	};
+
+	// On disk layout: AssetPackHeader, aligned payloads, AssetPackEntry table, string table
+	struct AssetPackHeader
+	{
+		uint32_t Magic;
+		uint32_t Version;
+		uint32_t EntryCount;
+		uint32_t Alignment;
+		uint64_t EntryTableOffset;
+		uint64_t StringTableOffset;
+		uint64_t StringTableSize;
+	};
+
+	struct AssetPackEntry
+	{
+		uint64_t Offset;
+		uint64_t Size;
+		uint64_t UncompressedSize;
+		uint32_t PathOffset;
+		uint32_t PathLength;
+		// Asset handle string, empty for raw files ( images, shader sources ... )
+		uint32_t HandleOffset;
+		uint32_t HandleLength;
+		int32_t  Type;
+		AssetPackCompression Compression;
+	};
+
+	struct AssetPackData
+	{
+		const uint8_t* Data = nullptr;
+		size_t		   Size = 0;
+		// Owns the payload of compressed entries, uncompressed ones point directly to the mapped file
+		std::vector<uint8_t> Storage;
+	};
+
+	class AssetPack
+	{
+	public:
+		struct EntryInfo
+		{
+			std::string Path;
+			GUID		Handle;
+			AssetType	Type;
+		};
+
+		bool Open(const std::string& filepath);
+		void Close();
+
+		bool IsOpen() const { return m_File.IsOpen(); }
+		bool Exists(const std::string& filepath) const;
+		bool Read(const std::string& filepath, AssetPackData& data) const;
+		bool Read(const std::string& filepath, std::string& result) const;
+
+		// Entries that carry asset metadata
+		std::vector<EntryInfo> GetAssetEntries() const;
+
+		static constexpr uint32_t sc_Magic = 0x4B505A58; // "XZPK"
+		static constexpr uint32_t sc_Version = 1;
+	private:
+		const AssetPackEntry* findEntry(const std::string& filepath) const;
+
+	private:
+		MemoryMappedFile m_File;
+		const AssetPackHeader* m_Header = nullptr;
+		const AssetPackEntry*  m_Entries = nullptr;
+		const char*			   m_Strings = nullptr;
+		std::unordered_map<std::string_view, uint32_t> m_EntryMap;
+	};
+
+	class AssetPackBuilder
+	{
+	public:
+		struct Options
+		{
+			uint32_t Alignment = 16;
+			bool	 Compress = true;
+			// Entry is stored compressed only if it shrinks below this ratio
+			float	 MinCompressionRatio = 0.9f;
+		};
+
+		AssetPackBuilder(const Options& options);
+		AssetPackBuilder();
+
+		bool AddFile(const std::string& filepath, const std::string& packPath, const GUID* handle = nullptr, AssetType type = AssetType::None);
+		bool Write(const std::string& filepath) const;
+
+		size_t GetNumEntries() const { return m_Entries.size(); }
+	private:
+		struct Entry
+		{
+			std::string			 Path;
+			std::string			 Handle;
+			AssetType			 Type;
+			AssetPackCompression Compression;
+			uint64_t			 UncompressedSize;
+			std::vector<uint8_t> Data;
+		};
+
+		Options			   m_Options;
+		std::vector<Entry> m_Entries;
+	};
+}
@@ -0,0 +1,197 @@
+#include "stdafx.h"
+#include "AssetRegistry.h"
+
+#include <filesystem>
+
+namespace XYZ {
+
+	template <typename T>
+	static void WriteValue(std::ofstream& stream, const T& value)
+	{
+		static_assert(std::is_trivially_copyable<T>::value, "Value must be trivially copyable");
+		stream.write((const char*)&value, sizeof(T));
+	}
+
+	template <typename T>
+	static bool ReadValue(std::ifstream& stream, T& value)
+	{
+		static_assert(std::is_trivially_copyable<T>::value, "Value must be trivially copyable");
+		stream.read((char*)&value, sizeof(T));
+		return (bool)stream;
+	}
+
+	static void WriteString(std::ofstream& stream, const std::string& value)
+	{
+		WriteValue(stream, (uint32_t)value.size());
+		stream.write(value.data(), value.size());
+	}
+
+	static bool ReadString(std::ifstream& stream, std::string& value)
+	{
+		uint32_t size = 0;
+		if (!ReadValue(stream, size))
+			return false;
+		value.resize(size);
+		stream.read(value.data(), size);
+		return (bool)stream;
+	}
+
+	void AssetRegistry::Insert(const Ref<Asset>& asset)
+	{
+		m_HandleMap[asset->FilePath] = asset->Handle;
+		m_TypeMap[asset->Type].push_back(asset->Handle);
+	}
+
+	void AssetRegistry::Remove(const Ref<Asset>& asset)
+	{
+		m_HandleMap.erase(asset->FilePath);
+		auto it = m_TypeMap.find(asset->Type);
+		if (it != m_TypeMap.end())
+		{
+			auto& handles = it->second;
+			auto handleIt = std::find(handles.begin(), handles.end(), asset->Handle);
+			if (handleIt != handles.end())
+			{
+				*handleIt = handles.back();
+				handles.pop_back();
+			}
+		}
+	}
+
+	void AssetRegistry::InsertDirectory(const AssetDirectory& directory)
+	{
+		m_DirectoryHandleMap[directory.FilePath] = directory.Handle;
+	}
+
+	void AssetRegistry::Clear()
+	{
+		m_HandleMap.clear();
+		m_DirectoryHandleMap.clear();
+		m_TypeMap.clear();
+		m_CachedRecords.clear();
+		m_CurrentRecords.clear();
+		m_CacheDirty = false;
+	}
+
+	bool AssetRegistry::FindHandle(const std::string& filepath, GUID& handle) const
+	{
+		auto it = m_HandleMap.find(filepath);
+		if (it != m_HandleMap.end())
+		{
+			handle = it->second;
+			return true;
+		}
+		return false;
+	}
+
+	bool AssetRegistry::FindDirectoryHandle(const std::string& filepath, GUID& handle) const
+	{
+		auto it = m_DirectoryHandleMap.find(filepath);
+		if (it != m_DirectoryHandleMap.end())
+		{
+			handle = it->second;
+			return true;
+		}
+		return false;
+	}
+
+	const std::vector<GUID>& AssetRegistry::GetHandlesByType(AssetType type) const
+	{
+		static const std::vector<GUID> s_Empty;
+		auto it = m_TypeMap.find(type);
+		if (it != m_TypeMap.end())
+			return it->second;
+		return s_Empty;
+	}
+
+	bool AssetRegistry::LoadCache(const std::string& filepath)
+	{
+		std::ifstream stream(filepath, std::ios::in | std::ios::binary);
+		if (!stream)
+			return false;
+
+		uint32_t magic = 0, version = 0, count = 0;
+		if (!ReadValue(stream, magic) || magic != sc_CacheMagic)
+			return false;
+		if (!ReadValue(stream, version) || version != sc_CacheVersion)
+			return false;
+		if (!ReadValue(stream, count))
+			return false;
+
+		m_CachedRecords.reserve(count);
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			std::string metaPath, handle;
+			AssetMetaRecord record;
+			int32_t type = 0;
+			if (!ReadString(stream, metaPath)
+			 || !ReadString(stream, record.FilePath)
+			 || !ReadString(stream, handle)
+			 || !ReadValue(stream, type)
+			 || !ReadValue(stream, record.WriteTime)
+			 || !ReadValue(stream, record.Size))
+			{
+				XYZ_LOG_WARN("Asset registry cache ", filepath, " is corrupted, rebuilding");
+				m_CachedRecords.clear();
+				return false;
+			}
+			record.Handle = GUID(handle);
+			record.Type = (AssetType)type;
+			m_CachedRecords[std::move(metaPath)] = std::move(record);
+		}
+		return true;
+	}
+
+	void AssetRegistry::SaveCache(const std::string& filepath) const
+	{
+		std::ofstream stream(filepath, std::ios::out | std::ios::binary | std::ios::trunc);
+		if (!stream)
+		{
+			XYZ_LOG_WARN("Could not write asset registry cache ", filepath);
+			return;
+		}
+		WriteValue(stream, sc_CacheMagic);
+		WriteValue(stream, sc_CacheVersion);
+		WriteValue(stream, (uint32_t)m_CurrentRecords.size());
+		for (auto& [metaPath, record] : m_CurrentRecords)
+		{
+			WriteString(stream, metaPath);
+			WriteString(stream, record.FilePath);
+			WriteString(stream, (std::string)record.Handle);
+			WriteValue(stream, (int32_t)record.Type);
+			WriteValue(stream, record.WriteTime);
+			WriteValue(stream, record.Size);
+		}
+	}
+
+	const AssetMetaRecord* AssetRegistry::FindMetaRecord(const std::string& metaPath, int64_t writeTime, uint64_t size) const
+	{
+		auto it = m_CachedRecords.find(metaPath);
+		if (it != m_CachedRecords.end()
+			&& it->second.WriteTime == writeTime
+			&& it->second.Size == size)
+			return &it->second;
+
+		return nullptr;
+	}
+
+	void AssetRegistry::RecordMeta(const std::string& metaPath, const AssetMetaRecord& record)
+	{
+		if (!FindMetaRecord(metaPath, record.WriteTime, record.Size))
+			m_CacheDirty = true;
+		m_CurrentRecords[metaPath] = record;
+	}
+
+	bool AssetRegistry::GetFileStats(const std::string& filepath, int64_t& writeTime, uint64_t& size)
+	{
+		std::error_code error;
+		auto time = std::filesystem::last_write_time(filepath, error);
+		if (error)
+			return false;
+		size = (uint64_t)std::filesystem::file_size(filepath, error);
+		if (error)
+			return false;
+		writeTime = (int64_t)time.time_since_epoch().count();
+		return true;
+	}
+}
@@ -0,0 +1,54 @@
+#pragma once
+#include "Asset.h"
+
+#include <unordered_map>
+
+namespace XYZ {
+
+	// Cached content of a .meta file, valid as long as the meta file
+	// has the same write time and size as when it was recorded
+	struct AssetMetaRecord
+	{
+		GUID		Handle;
+		AssetType	Type = AssetType::None;
+		std::string FilePath;
+		int64_t		WriteTime = 0;
+		uint64_t	Size = 0;
+	};
+
+	class AssetRegistry
+	{
+	public:
+		void Insert(const Ref<Asset>& asset);
+		void Remove(const Ref<Asset>& asset);
+		void InsertDirectory(const AssetDirectory& directory);
+		void Clear();
+
+		bool FindHandle(const std::string& filepath, GUID& handle) const;
+		bool FindDirectoryHandle(const std::string& filepath, GUID& handle) const;
+		const std::vector<GUID>& GetHandlesByType(AssetType type) const;
+
+		bool LoadCache(const std::string& filepath);
+		void SaveCache(const std::string& filepath) const;
+
+		const AssetMetaRecord* FindMetaRecord(const std::string& metaPath, int64_t writeTime, uint64_t size) const;
+		void RecordMeta(const std::string& metaPath, const AssetMetaRecord& record);
+
+		bool IsCacheDirty() const { return m_CacheDirty || m_CurrentRecords.size() != m_CachedRecords.size(); }
+
+		static bool GetFileStats(const std::string& filepath, int64_t& writeTime, uint64_t& size);
+	private:
+		std::unordered_map<std::string, GUID> m_HandleMap;
+		std::unordered_map<std::string, GUID> m_DirectoryHandleMap;
+		std::unordered_map<AssetType, std::vector<GUID>> m_TypeMap;
+
+		// Records loaded from the cache file, keyed by meta file path
+		std::unordered_map<std::string, AssetMetaRecord> m_CachedRecords;
+		// Records seen during the current scan, written back on save
+		std::unordered_map<std::string, AssetMetaRecord> m_CurrentRecords;
+		bool m_CacheDirty = false;
+
+		static constexpr uint32_t sc_CacheMagic = 0x52475941; // "AYGR"
+		static constexpr uint32_t sc_CacheVersion = 1;
+	};
+}
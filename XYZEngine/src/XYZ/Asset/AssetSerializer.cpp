@@ -141,6 +141,14 @@ namespace XYZ {
 		return out;
 	}
 
+	static std::string ReadAssetFile(const std::string& filepath)
+	{
+		std::string result;
+		if (!AssetManager::ReadFile(filepath, result))
+			XYZ_LOG_ERR("Could not read asset file ", filepath);
+		return result;
+	}
+
 	// TODO: Temporary
 	static void CopyAsset(Ref<Asset>& target, const Ref<Asset>& source)
 	{
@@ -438,12 +446,8 @@ namespace XYZ {
 	template <>
 	Ref<Asset> AssetSerializer::deserialize<Texture2D>(const Ref<Asset>& asset)
 	{
-		std::ifstream stream(asset->FilePath);
 		TextureSpecs specs;
-		
-		std::stringstream strStream;
-		strStream << stream.rdbuf();
-		YAML::Node data = YAML::Load(strStream.str());
+		YAML::Node data = YAML::Load(ReadAssetFile(asset->FilePath));
 	
 		XYZ_ASSERT(data["Texture"], "Incorrect file format");
 
@@ -472,10 +476,7 @@ namespace XYZ {
 	template <>
 	Ref<Asset> AssetSerializer::deserialize<SubTexture>(const Ref<Asset>& asset)
 	{
-		std::ifstream stream(asset->FilePath);
-		std::stringstream strStream;
-		strStream << stream.rdbuf();
-		YAML::Node data = YAML::Load(strStream.str());
+		YAML::Node data = YAML::Load(ReadAssetFile(asset->FilePath));
 
 		XYZ_ASSERT(data["SubTexture"], "Incorrect file format ");
 		GUID textureHandle(data["TextureAsset"].as<std::string>());
@@ -491,10 +492,7 @@ namespace XYZ {
 	template <>
 	Ref<Asset> AssetSerializer::deserialize<Shader>(const Ref<Asset>& asset)
 	{
-		std::ifstream stream(asset->FilePath);
-		std::stringstream strStream;
-		strStream << stream.rdbuf();
-		YAML::Node data = YAML::Load(strStream.str());
+		YAML::Node data = YAML::Load(ReadAssetFile(asset->FilePath));
 
 		Ref<Shader> shader =Shader::Create(data["ShaderFilePath"].as<std::string>());
 		CopyAsset(shader.As<Asset>(), asset);
@@ -504,10 +502,7 @@ namespace XYZ {
 	template <>
 	Ref<Asset> AssetSerializer::deserialize<Material>(const Ref<Asset>& asset)
 	{
-		std::ifstream stream(asset->FilePath);
-		std::stringstream strStream;
-		strStream << stream.rdbuf();
-		YAML::Node data = YAML::Load(strStream.str());
+		YAML::Node data = YAML::Load(ReadAssetFile(asset->FilePath));
 
 		GUID shaderHandle(data["ShaderAsset"].as<std::string>());
 		auto shader = AssetManager::GetAsset<Shader>(shaderHandle);
@@ -554,10 +549,7 @@ namespace XYZ {
 	template <>
 	Ref<Asset> AssetSerializer::deserialize<Font>(const Ref<Asset>& asset)
 	{
-		std::ifstream stream(asset->FilePath);
-		std::stringstream strStream;
-		strStream << stream.rdbuf();
-		YAML::Node data = YAML::Load(strStream.str());
+		YAML::Node data = YAML::Load(ReadAssetFile(asset->FilePath));
 
 		XYZ_ASSERT(data["Font"], "Incorrect file format");
 		uint32_t pixelSize = data["PixelSize"].as<uint32_t>();
@@ -602,10 +594,7 @@ namespace XYZ {
 	template <>
 	Ref<Asset> AssetSerializer::deserialize<SkeletalMesh>(const Ref<Asset>& asset)
 	{
-		std::ifstream stream(asset->FilePath);
-		std::stringstream strStream;
-		strStream << stream.rdbuf();
-		YAML::Node data = YAML::Load(strStream.str());
+		YAML::Node data = YAML::Load(ReadAssetFile(asset->FilePath));
 
 		GUID materialHandle(data["MaterialAsset"].as<std::string>());
 		Ref<Material> material = AssetManager::GetAsset<Material>(materialHandle);
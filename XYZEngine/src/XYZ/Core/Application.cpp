@@ -16,10 +16,10 @@ namespace XYZ {
 
 	ThreadPool Application::s_ThreadPool(12);
 
-	Application::Application()
+	Application::Application(const ApplicationSpecification& specification)
 	{
 		Logger::Get().SetLogLevel(LogLevel::INFO | LogLevel::WARNING | LogLevel::ERR | LogLevel::API);
-		AssetManager::Init();
+		AssetManager::Init(specification.MountAssetPack);
 		Renderer::Init();
 		s_Application = this;
 		m_Running = true;
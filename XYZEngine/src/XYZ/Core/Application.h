@@ -6,10 +6,15 @@
 #include "XYZ/ImGui/ImGuiLayer.h"
 
 namespace XYZ {
+	struct ApplicationSpecification
+	{
+		bool MountAssetPack = false;
+	};
+
 	class Application
 	{
 	public:
-		Application();
+		Application(const ApplicationSpecification& specification = ApplicationSpecification());
 		virtual ~Application();
 
 		void Run();
@@ -10,12 +10,12 @@
 
 #ifdef _WIN64
 	#define XYZ_PLATFORM_WINDOWS
-#elif __linux__
-	#define XYZ_PLATFORM_LINUX
 #else
 	#error "x86 Builds are not supported!"
 #endif
 
+#elif defined(__linux__)
+	#define XYZ_PLATFORM_LINUX
 #endif
 
 #ifdef XYZ_DEBUG
@@ -0,0 +1,159 @@
+#include "stdafx.h"
+#include "GUID.h"
+
+#include <chrono>
+#include <random>
+#include <thread>
+
+namespace XYZ {
+
+	static uint64_t SplitMix64(uint64_t& state)
+	{
+		uint64_t z = (state += 0x9e3779b97f4a7c15ull);
+		z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+		z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+		return z ^ (z >> 31);
+	}
+
+	static inline uint64_t RotateLeft(uint64_t x, int k)
+	{
+		return (x << k) | (x >> (64 - k));
+	}
+
+	// xoshiro256**, one generator per thread so no locking is required
+	class GUIDGenerator
+	{
+	public:
+		GUIDGenerator()
+		{
+			std::random_device device;
+			uint64_t seed = ((uint64_t)device() << 32) ^ (uint64_t)device();
+			seed ^= (uint64_t)std::chrono::high_resolution_clock::now().time_since_epoch().count();
+			seed ^= (uint64_t)std::hash<std::thread::id>()(std::this_thread::get_id()) << 1;
+			for (uint64_t& s : m_State)
+				s = SplitMix64(seed);
+		}
+
+		uint64_t Next()
+		{
+			const uint64_t result = RotateLeft(m_State[1] * 5, 7) * 9;
+			const uint64_t t = m_State[1] << 17;
+			m_State[2] ^= m_State[0];
+			m_State[3] ^= m_State[1];
+			m_State[1] ^= m_State[2];
+			m_State[0] ^= m_State[3];
+			m_State[2] ^= t;
+			m_State[3] = RotateLeft(m_State[3], 45);
+			return result;
+		}
+
+	private:
+		uint64_t m_State[4];
+	};
+
+	static const char sc_HexDigits[] = "0123456789abcdef";
+	static constexpr size_t sc_StringLength = 36;
+
+	static inline int HexValue(char c)
+	{
+		if (c >= '0' && c <= '9') return c - '0';
+		if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+		if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+		return -1;
+	}
+
+	static inline bool IsDashPosition(size_t index)
+	{
+		return index == 8 || index == 13 || index == 18 || index == 23;
+	}
+
+	GUID::GUID()
+	{
+		thread_local GUIDGenerator s_Generator;
+		m_High = s_Generator.Next();
+		m_Low = s_Generator.Next();
+		// Version 4 and RFC 4122 variant
+		m_High = (m_High & ~0x000000000000f000ull) | 0x0000000000004000ull;
+		m_Low  = (m_Low  & ~0xc000000000000000ull) | 0x8000000000000000ull;
+	}
+	GUID::GUID(const std::string& str)
+		: m_High(0), m_Low(0)
+	{
+		const bool result = Parse(str.c_str(), str.size(), *this);
+		XYZ_ASSERT(result, "Invalid GUID ", str);
+	}
+	GUID::GUID(uint64_t high, uint64_t low)
+		: m_High(high), m_Low(low)
+	{
+	}
+
+	GUID& GUID::operator=(const std::string& str)
+	{
+		m_High = 0;
+		m_Low = 0;
+		const bool result = Parse(str.c_str(), str.size(), *this);
+		XYZ_ASSERT(result, "Invalid GUID ", str);
+		return *this;
+	}
+
+	GUID::operator std::string() const
+	{
+		std::string result(sc_StringLength, '\0');
+		ToChars(result.data());
+		return result;
+	}
+
+	GUID::operator std::string()
+	{
+		return static_cast<const GUID&>(*this);
+	}
+
+	void GUID::ToChars(char* dest) const
+	{
+		size_t index = 0;
+		for (int shift = 60; shift >= 0; shift -= 4)
+		{
+			if (IsDashPosition(index))
+				dest[index++] = '-';
+			dest[index++] = sc_HexDigits[(m_High >> shift) & 0xf];
+		}
+		for (int shift = 60; shift >= 0; shift -= 4)
+		{
+			if (IsDashPosition(index))
+				dest[index++] = '-';
+			dest[index++] = sc_HexDigits[(m_Low >> shift) & 0xf];
+		}
+	}
+
+	bool GUID::Parse(const char* str, size_t length, GUID& result)
+	{
+		if (length == sc_StringLength + 2 && str[0] == '{' && str[length - 1] == '}')
+		{
+			str++;
+			length -= 2;
+		}
+		if (length != sc_StringLength)
+			return false;
+
+		uint64_t words[2] = { 0, 0 };
+		uint32_t digit = 0;
+		for (size_t i = 0; i < sc_StringLength; ++i)
+		{
+			if (IsDashPosition(i))
+			{
+				if (str[i] != '-')
+					return false;
+				continue;
+			}
+			const int value = HexValue(str[i]);
+			if (value < 0)
+				return false;
+			uint64_t& word = words[digit / 16];
+			word = (word << 4) | (uint64_t)value;
+			digit++;
+		}
+		result.m_High = words[0];
+		result.m_Low = words[1];
+		return true;
+	}
+}
@@ -1,56 +1,54 @@
 #pragma once
 
-#include <array>
 #include <functional>
 #include <string>
+#include <stdint.h>
 
 namespace XYZ {
 
+	// 128 bit random (version 4) identifier, string form is 8-4-4-4-12 lower case hex digits
 	class GUID
 	{
 	public:
 		GUID();
 		GUID(const std::string& str);
-		GUID(const GUID& other);
+		GUID(uint64_t high, uint64_t low);
 
 		GUID& operator=(const std::string& str);
 
 		bool operator==(const GUID& other) const
 		{
-			return m_Data1 == other.m_Data1
-				&& m_Data2 == other.m_Data2
-				&& m_Data3 == other.m_Data3
-				&& m_Data4[0] == other.m_Data4[0]
-				&& m_Data4[1] == other.m_Data4[1]
-				&& m_Data4[2] == other.m_Data4[2]
-				&& m_Data4[3] == other.m_Data4[3]
-				&& m_Data4[4] == other.m_Data4[4]
-				&& m_Data4[5] == other.m_Data4[5]
-				&& m_Data4[6] == other.m_Data4[6]
-				&& m_Data4[7] == other.m_Data4[7];
+			return ((m_High ^ other.m_High) | (m_Low ^ other.m_Low)) == 0;
+		}
+		bool operator!=(const GUID& other) const
+		{
+			return !(*this == other);
 		}
 
 		operator std::string() const;
 		operator std::string();
 
+		// Writes 36 characters, dest is not null terminated
+		void ToChars(char* dest) const;
+		// Accepts 8-4-4-4-12 form optionally surrounded by braces
+		static bool Parse(const char* str, size_t length, GUID& result);
+
 		inline size_t Hash() const
 		{
-			size_t seed = 0;
-			std::hash<size_t> hasher;
-			seed ^= hasher(m_Data1) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
-			seed ^= hasher(m_Data2) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
-			seed ^= hasher(m_Data3) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
-			for (uint32_t i = 0; i < 8; ++i)
-				seed ^= hasher(m_Data4[i]) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
-
-			return hasher(seed);
+			// Bits are already random, one multiply mixes both halves
+			uint64_t hash = (m_High ^ (m_Low * 0x9e3779b97f4a7c15ull));
+			hash ^= hash >> 32;
+			hash *= 0xd6e8feb86659fd93ull;
+			hash ^= hash >> 32;
+			return (size_t)hash;
 		}
 
+		uint64_t GetHigh() const { return m_High; }
+		uint64_t GetLow()  const { return m_Low; }
+
 	private:
-		uint32_t m_Data1;
-		uint16_t m_Data2;
-		uint16_t m_Data3;
-		uint8_t  m_Data4[8];
+		uint64_t m_High;
+		uint64_t m_Low;
 	};
 }
 
@@ -66,4 +64,4 @@ namespace std {
 		}
 	};
 
-}
\ No newline at end of file
+}
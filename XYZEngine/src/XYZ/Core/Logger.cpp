@@ -3,21 +3,425 @@
 
 
 #include <time.h>
+#include <chrono>
+#include <cstring>
 
 
 namespace XYZ {
 	Logger Logger::s_Instance;
 
-	std::string Logger::currentDateTime()
+	// Record layout: size, level, timestamp, arguments
+	static constexpr uint32_t sc_RecordHeaderSize = sizeof(uint32_t) + sizeof(int32_t) + sizeof(int64_t);
+
+	// Set when logger is destroyed, static destructors running later write synchronously to console
+	static std::atomic<bool> s_ShutDown = false;
+
+	// Per thread state is trivially destructible, thread local destructors running later may still log
+	static thread_local LogRingBuffer*		  s_ThreadBuffer = nullptr;
+	static thread_local std::vector<uint8_t>* s_ThreadRecord = nullptr;
+	static thread_local bool				  s_ThreadExited = false;
+
+	// Releases per thread state when the thread exits. Ring buffer is only retired,
+	// writer thread frees it after its records are written
+	struct ThreadStateGuard
+	{
+		void Register() {}
+		~ThreadStateGuard()
+		{
+			if (s_ThreadBuffer && !s_ShutDown)
+				s_ThreadBuffer->Retire();
+			delete s_ThreadRecord;
+			s_ThreadBuffer = nullptr;
+			s_ThreadRecord = nullptr;
+			s_ThreadExited = true;
+		}
+	};
+	static thread_local ThreadStateGuard s_ThreadStateGuard;
+
+	LogRingBuffer::LogRingBuffer(uint32_t capacity)
+		: m_Data(capacity)
 	{
-		time_t     now = time(NULL);
-		struct tm  tstruct;
-		char       buf[80];
-		localtime_s(&tstruct, &now);
-		strftime(buf, sizeof(buf), "%Y-%m-%d %X", &tstruct);
-		return buf;
 	}
 
-}
+	bool LogRingBuffer::Push(const uint8_t* data, uint32_t size)
+	{
+		const uint64_t head = m_Head.load(std::memory_order_relaxed);
+		const uint64_t tail = m_Tail.load(std::memory_order_acquire);
+		const uint64_t capacity = m_Data.size();
+		if (capacity - (head - tail) < size)
+			return false;
+
+		const size_t offset = (size_t)(head % capacity);
+		const size_t firstPart = std::min<size_t>(size, (size_t)capacity - offset);
+		memcpy(&m_Data[offset], data, firstPart);
+		if (firstPart < size)
+			memcpy(&m_Data[0], data + firstPart, size - firstPart);
+
+		m_Head.store(head + size, std::memory_order_release);
+		return true;
+	}
+
+	void LogRingBuffer::Pop(std::vector<uint8_t>& result)
+	{
+		const uint64_t tail = m_Tail.load(std::memory_order_relaxed);
+		const uint64_t head = m_Head.load(std::memory_order_acquire);
+		const uint64_t capacity = m_Data.size();
+		const size_t size = (size_t)(head - tail);
+		if (!size)
+			return;
+
+		const size_t offset = (size_t)(tail % capacity);
+		const size_t firstPart = std::min<size_t>(size, (size_t)capacity - offset);
+		result.insert(result.end(), m_Data.begin() + offset, m_Data.begin() + offset + firstPart);
+		if (firstPart < size)
+			result.insert(result.end(), m_Data.begin(), m_Data.begin() + (size - firstPart));
+
+		m_Tail.store(head, std::memory_order_release);
+	}
+
+	Logger::~Logger()
+	{
+		if (m_WriterThread.joinable())
+		{
+			{
+				std::scoped_lock<std::mutex> lock(m_WriterMutex);
+				m_Running = false;
+			}
+			m_WriterCondition.notify_one();
+			m_WriterThread.join();
+
+			// Records pushed after the last pass of writer thread
+			std::vector<uint8_t> batch;
+			writePending(batch);
+		}
+		s_ShutDown = true;
+	}
+
+	void Logger::Flush()
+	{
+		if (s_ShutDown)
+			return;
+
+		std::unique_lock<std::mutex> lock(m_WriterMutex);
+		if (!m_Running)
+			return;
+
+		// Pass that starts after this point sees all records pushed so far
+		const uint64_t target = m_PassStarted + 1;
+		m_WakeRequested = true;
+		m_WriterCondition.notify_one();
+		m_FlushedCondition.wait(lock, [&]() { return m_PassCompleted >= target || !m_Running; });
+	}
+
+	void Logger::encodeValue(std::vector<uint8_t>& record, ArgType type, const void* data, size_t size)
+	{
+		const size_t offset = record.size();
+		record.resize(offset + 1 + size);
+		record[offset] = (uint8_t)type;
+		memcpy(&record[offset + 1], data, size);
+	}
+
+	void Logger::encodeString(std::vector<uint8_t>& record, std::string_view value)
+	{
+		const uint32_t length = (uint32_t)value.size();
+		const size_t offset = record.size();
+		record.resize(offset + 1 + sizeof(uint32_t) + length);
+		record[offset] = (uint8_t)ArgType::String;
+		memcpy(&record[offset + 1], &length, sizeof(uint32_t));
+		memcpy(&record[offset + 1 + sizeof(uint32_t)], value.data(), length);
+	}
+
+	std::vector<uint8_t>& Logger::beginRecord(LogLevel::LogLevel level)
+	{
+		if (!s_ThreadRecord)
+		{
+			// Record of exiting thread is released right after it is written
+			if (!s_ThreadExited)
+				s_ThreadStateGuard.Register();
+			s_ThreadRecord = new std::vector<uint8_t>();
+		}
+		std::vector<uint8_t>& record = *s_ThreadRecord;
+
+		const int32_t recordLevel = level;
+		const int64_t timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::system_clock::now().time_since_epoch()
+		).count();
+
+		record.resize(sc_RecordHeaderSize);
+		memcpy(&record[sizeof(uint32_t)], &recordLevel, sizeof(int32_t));
+		memcpy(&record[sizeof(uint32_t) + sizeof(int32_t)], &timestamp, sizeof(int64_t));
+		return record;
+	}
+
+	void Logger::submit(std::vector<uint8_t>& record)
+	{
+		const uint32_t size = (uint32_t)record.size();
+		memcpy(&record[0], &size, sizeof(uint32_t));
+		// Thread local destructors of the exiting thread and static destructors after logger shutdown
+		if (s_ThreadExited || s_ShutDown)
+		{
+			writeImmediate(record);
+			if (s_ThreadExited)
+			{
+				delete s_ThreadRecord;
+				s_ThreadRecord = nullptr;
+			}
+			return;
+		}
 
+		std::call_once(m_WriterStarted, [this]() {
+			{
+				std::scoped_lock<std::mutex> lock(m_WriterMutex);
+				m_Running = true;
+			}
+			m_WriterThread = std::thread(&Logger::writerLoop, this);
+		});
 
+		LogRingBuffer* buffer = getThreadBuffer();
+		if (size > buffer->GetCapacity())
+		{
+			// Never fits into the ring, written after the records already pushed by this thread
+			Flush();
+			writeImmediate(record);
+			return;
+		}
+		while (!buffer->Push(record.data(), size))
+		{
+			if (m_OverflowPolicy == LogOverflowPolicy::Drop)
+			{
+				m_Dropped++;
+				return;
+			}
+			{
+				std::scoped_lock<std::mutex> lock(m_WriterMutex);
+				m_WakeRequested = true;
+			}
+			m_WriterCondition.notify_one();
+			std::this_thread::yield();
+		}
+	}
+
+	LogRingBuffer* Logger::getThreadBuffer()
+	{
+		if (!s_ThreadBuffer)
+		{
+			// Buffers are owned by logger, records of finished threads are still written
+			std::scoped_lock<std::mutex> lock(m_BuffersMutex);
+			m_Buffers.push_back(std::make_unique<LogRingBuffer>(sc_BufferCapacity));
+			s_ThreadBuffer = m_Buffers.back().get();
+		}
+		return s_ThreadBuffer;
+	}
+
+	void Logger::writerLoop()
+	{
+		std::vector<uint8_t> batch;
+		bool running = true;
+		while (running)
+		{
+			{
+				std::unique_lock<std::mutex> lock(m_WriterMutex);
+				m_WriterCondition.wait_for(lock, std::chrono::milliseconds(sc_WriteIntervalMs), [this]() {
+					return m_WakeRequested || !m_Running;
+				});
+				m_WakeRequested = false;
+				running = m_Running;
+				m_PassStarted++;
+			}
+
+			writePending(batch);
+
+			{
+				std::scoped_lock<std::mutex> lock(m_WriterMutex);
+				m_PassCompleted = m_PassStarted;
+			}
+			m_FlushedCondition.notify_all();
+		}
+	}
+
+	void Logger::writePending(std::vector<uint8_t>& batch)
+	{
+		std::vector<LogRingBuffer*> buffers;
+		{
+			std::scoped_lock<std::mutex> lock(m_BuffersMutex);
+			buffers.reserve(m_Buffers.size());
+			for (auto& buffer : m_Buffers)
+				buffers.push_back(buffer.get());
+		}
+
+		std::scoped_lock<std::mutex> lock(m_OutputMutex);
+		bool written = false;
+		std::vector<LogRingBuffer*> retired;
+		for (LogRingBuffer* buffer : buffers)
+		{
+			// Retired before pop means pop takes the last records of the buffer
+			if (buffer->IsRetired())
+				retired.push_back(buffer);
+
+			batch.clear();
+			buffer->Pop(batch);
+
+			size_t offset = 0;
+			while (offset + sc_RecordHeaderSize <= batch.size())
+			{
+				uint32_t size = 0;
+				memcpy(&size, &batch[offset], sizeof(uint32_t));
+				writeRecord(&batch[offset], size);
+				offset += size;
+				written = true;
+			}
+		}
+
+		if (!retired.empty())
+		{
+			std::scoped_lock<std::mutex> buffersLock(m_BuffersMutex);
+			for (LogRingBuffer* buffer : retired)
+			{
+				auto it = std::find_if(m_Buffers.begin(), m_Buffers.end(), [buffer](const auto& owned) { return owned.get() == buffer; });
+				m_Buffers.erase(it);
+			}
+		}
+
+		const uint32_t dropped = m_Dropped.exchange(0);
+		if (dropped)
+		{
+			SetColor(m_YellowColor);
+			std::cout << "Logger: " << dropped << " messages dropped\n";
+			m_LogFile << "Logger: " << dropped << " messages dropped\n";
+			SetColor(m_WhiteColor);
+			written = true;
+		}
+		if (written)
+		{
+			std::cout.flush();
+			m_LogFile.flush();
+		}
+	}
+
+	void Logger::writeImmediate(const std::vector<uint8_t>& record)
+	{
+		const uint8_t* data = record.data();
+		const uint32_t size = (uint32_t)record.size();
+		if (s_ShutDown)
+		{
+			// Members of logger are destroyed, only console is still available
+			int32_t level = 0;
+			memcpy(&level, data + sizeof(uint32_t), sizeof(int32_t));
+			SetColor(levelColor(level));
+			formatArgs(data, size, std::cout);
+			std::cout << std::endl;
+			SetColor(m_WhiteColor);
+			return;
+		}
+		std::scoped_lock<std::mutex> lock(m_OutputMutex);
+		writeRecord(data, size);
+		std::cout.flush();
+		m_LogFile.flush();
+	}
+
+	void Logger::writeRecord(const uint8_t* data, uint32_t size)
+	{
+		int32_t level = 0;
+		int64_t timestamp = 0;
+		memcpy(&level, data + sizeof(uint32_t), sizeof(int32_t));
+		memcpy(&timestamp, data + sizeof(uint32_t) + sizeof(int32_t), sizeof(int64_t));
+
+		m_Line.str(std::string());
+		formatArgs(data, size, m_Line);
+		m_Line << '\n';
+		const std::string line = m_Line.str();
+
+		SetColor(levelColor(level));
+		std::cout << formatTime(timestamp) << " " << line;
+		m_LogFile << line;
+		SetColor(m_WhiteColor);
+	}
+
+	void Logger::formatArgs(const uint8_t* data, uint32_t size, std::ostream& stream)
+	{
+		size_t offset = sc_RecordHeaderSize;
+		while (offset < size)
+		{
+			ArgType type = (ArgType)data[offset++];
+			switch (type)
+			{
+			case ArgType::Int:
+			{
+				int64_t value;
+				memcpy(&value, data + offset, sizeof(int64_t));
+				stream << value;
+				offset += sizeof(int64_t);
+				break;
+			}
+			case ArgType::UInt:
+			{
+				uint64_t value;
+				memcpy(&value, data + offset, sizeof(uint64_t));
+				stream << value;
+				offset += sizeof(uint64_t);
+				break;
+			}
+			case ArgType::Double:
+			{
+				double value;
+				memcpy(&value, data + offset, sizeof(double));
+				stream << value;
+				offset += sizeof(double);
+				break;
+			}
+			case ArgType::Char:
+			{
+				stream << (char)data[offset];
+				offset += sizeof(char);
+				break;
+			}
+			case ArgType::String:
+			{
+				uint32_t length;
+				memcpy(&length, data + offset, sizeof(uint32_t));
+				offset += sizeof(uint32_t);
+				stream << std::string_view((const char*)data + offset, length);
+				offset += length;
+				break;
+			}
+			default:
+				// Corrupted record, asserting here would deadlock on flush
+				offset = size;
+				break;
+			}
+		}
+	}
+
+	int Logger::levelColor(int level) const
+	{
+		switch (level)
+		{
+		case LogLevel::INFO:	return m_GreenColor;
+		case LogLevel::WARNING: return m_YellowColor;
+		case LogLevel::ERR:		return m_RedColor;
+		case LogLevel::API:		return m_PurpleColor;
+		}
+		return m_WhiteColor;
+	}
+
+	const std::string& Logger::formatTime(int64_t timestamp)
+	{
+		const int64_t second = timestamp / 1000000000;
+		if (second != m_CachedSecond)
+		{
+			time_t	   now = (time_t)second;
+			struct tm  tstruct;
+			char	   buf[80];
+#ifdef XYZ_PLATFORM_WINDOWS
+			localtime_s(&tstruct, &now);
+#else
+			localtime_r(&now, &tstruct);
+#endif
+			strftime(buf, sizeof(buf), "%Y-%m-%d %X", &tstruct);
+			m_CachedTime = buf;
+			m_CachedSecond = second;
+		}
+		return m_CachedTime;
+	}
+
+}
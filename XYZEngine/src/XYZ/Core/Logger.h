@@ -3,6 +3,13 @@
 
 #include <fstream>
 #include <iostream>
+#include <sstream>
+#include <string_view>
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 
 namespace XYZ {
 
@@ -17,71 +24,82 @@ namespace XYZ {
 			TRACE = API | ERR | WARNING | INFO
 		};
 	}
+
+	// What happens when thread logs faster than the records are written
+	enum class LogOverflowPolicy
+	{
+		Drop,
+		Block
+	};
+
+	// Single producer single consumer ring of log records
+	class LogRingBuffer
+	{
+	public:
+		LogRingBuffer(uint32_t capacity);
+
+		bool Push(const uint8_t* data, uint32_t size);
+		// Appends all pending bytes to result
+		void Pop(std::vector<uint8_t>& result);
+		// Producer thread exited, no more records will be pushed
+		void Retire() { m_Retired.store(true, std::memory_order_release); }
+
+		uint32_t GetCapacity() const { return (uint32_t)m_Data.size(); }
+		bool	 IsRetired() const { return m_Retired.load(std::memory_order_acquire); }
+	private:
+		std::vector<uint8_t>  m_Data;
+		std::atomic<uint64_t> m_Head = 0;
+		std::atomic<uint64_t> m_Tail = 0;
+		std::atomic<bool>	  m_Retired = false;
+	};
+
+	// Callers only encode arguments into per thread ring buffer,
+	// formatting and writing is done in batches on background thread
 	class Logger
 	{
 	public:
 		Logger();
 		Logger(const Logger&) = delete;
+		~Logger();
 		static void Init();
 
 		template <typename... Args>
 		void Info(Args... args)
 		{
-			if ((m_LogLevel & LogLevel::INFO))
-			{
-				SetColor(m_GreenColor);
-				std::cout << currentDateTime() << " ";
-				(std::cout << ... << args) << std::endl;
-				(m_LogFile << ... << args) << std::endl;
-				SetColor(m_WhiteColor);
-			}
+			log(LogLevel::INFO, args...);
 		}
 
 		template <typename... Args>
 		void Warn(Args... args)
 		{
-			if ((m_LogLevel & LogLevel::WARNING))
-			{
-				SetColor(m_YellowColor);
-				std::cout << currentDateTime() << " ";
-				(std::cout << ... << args) << std::endl;
-				(m_LogFile << ... << args) << std::endl;
-				SetColor(m_WhiteColor);
-			}
+			log(LogLevel::WARNING, args...);
 		}
 
 		template <typename... Args>
 		void Error(Args... args)
 		{
-			if ((m_LogLevel & LogLevel::ERR))
-			{
-				SetColor(m_RedColor);
-				std::cout << currentDateTime() << " ";
-				(std::cout << ... << args) << std::endl;
-				(m_LogFile << ... << args) << std::endl;
-				SetColor(m_WhiteColor);
-			}
+			if (!(m_LogLevel & LogLevel::ERR))
+				return;
+			log(LogLevel::ERR, args...);
+			// Errors are usually followed by assert, make sure they are visible
+			Flush();
 		}
 
 		template <typename... Args>
 		void API(Args... args)
 		{
-			if ((m_LogLevel & LogLevel::API))
-			{
-				SetColor(m_PurpleColor);
-				std::cout << currentDateTime() << " ";
-				(std::cout << ... << args) << std::endl;
-				(m_LogFile << ... << args) << std::endl;
-				SetColor(m_WhiteColor);
-			}
+			log(LogLevel::API, args...);
 		}
 
+		// Blocks until all records logged before the call are written
+		void Flush();
 
 		inline void SetLogLevel(int level) { m_LogLevel = level; };
 		inline void SetLogFile(const std::string& logfile) { m_FileName = logfile; };
+		inline void SetOverflowPolicy(LogOverflowPolicy policy) { m_OverflowPolicy = policy; }
 
 		static Logger& Get() { return s_Instance; };
-		
+
 	protected:
 		void SetColor(const int color);
 
@@ -95,15 +113,109 @@ namespace XYZ {
 		std::ofstream m_LogFile;
 		std::string m_FileName;
 
+	private:
+		enum class ArgType : uint8_t
+		{
+			Int, UInt, Double, Char, String
+		};
+
+		template <typename... Args>
+		void log(LogLevel::LogLevel level, const Args&... args)
+		{
+			if (!(m_LogLevel & level))
+				return;
+
+			std::vector<uint8_t>& record = beginRecord(level);
+			(encodeArg(record, args), ...);
+			submit(record);
+		}
+
+		template <typename T>
+		static void encodeArg(std::vector<uint8_t>& record, const T& value)
+		{
+			if constexpr (std::is_same_v<T, char> || std::is_same_v<T, signed char> || std::is_same_v<T, unsigned char>)
+			{
+				char c = (char)value;
+				encodeValue(record, ArgType::Char, &c, sizeof(char));
+			}
+			else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>)
+			{
+				int64_t v = value;
+				encodeValue(record, ArgType::Int, &v, sizeof(int64_t));
+			}
+			else if constexpr (std::is_integral_v<T>)
+			{
+				uint64_t v = value;
+				encodeValue(record, ArgType::UInt, &v, sizeof(uint64_t));
+			}
+			else if constexpr (std::is_floating_point_v<T>)
+			{
+				double v = value;
+				encodeValue(record, ArgType::Double, &v, sizeof(double));
+			}
+			else if constexpr (std::is_convertible_v<const T&, std::string_view>)
+			{
+				encodeString(record, std::string_view(value));
+			}
+			else
+			{
+				// Types without compact encoding are formatted on calling thread
+				std::ostringstream stream;
+				stream << value;
+				encodeString(record, stream.str());
+			}
+		}
+
+		static void encodeValue(std::vector<uint8_t>& record, ArgType type, const void* data, size_t size);
+		static void encodeString(std::vector<uint8_t>& record, std::string_view value);
+
+		std::vector<uint8_t>& beginRecord(LogLevel::LogLevel level);
+		void submit(std::vector<uint8_t>& record);
+		LogRingBuffer* getThreadBuffer();
+
+		void writerLoop();
+		void writePending(std::vector<uint8_t>& batch);
+		// Used when thread buffer is not available, during thread exit or after logger shutdown
+		void writeImmediate(const std::vector<uint8_t>& record);
+		void writeRecord(const uint8_t* data, uint32_t size);
+		int  levelColor(int level) const;
+
+		static void formatArgs(const uint8_t* data, uint32_t size, std::ostream& stream);
+
+		const std::string& formatTime(int64_t timestamp);
 
 	private:
-		std::string currentDateTime();
+		LogOverflowPolicy  m_OverflowPolicy = LogOverflowPolicy::Block;
+
+		std::mutex		   m_BuffersMutex;
+		std::vector<std::unique_ptr<LogRingBuffer>> m_Buffers;
+
+		// Console and log file are written by writer thread and by immediate writes
+		std::mutex		   m_OutputMutex;
+		std::ostringstream m_Line;
+
+		std::thread			    m_WriterThread;
+		std::once_flag			m_WriterStarted;
+		std::mutex				m_WriterMutex;
+		std::condition_variable m_WriterCondition;
+		std::condition_variable m_FlushedCondition;
+		bool					m_Running = false;
+		bool					m_WakeRequested = false;
+		uint64_t				m_PassStarted = 0;
+		uint64_t				m_PassCompleted = 0;
+		std::atomic<uint32_t>   m_Dropped = 0;
+
+		int64_t					m_CachedSecond = -1;
+		std::string				m_CachedTime;
+
 		static Logger s_Instance;
 
+		static constexpr uint32_t sc_BufferCapacity = 64 * 1024;
+		static constexpr uint32_t sc_WriteIntervalMs = 10;
 	};
 
 #define XYZ_LOG_INFO(...)  Logger::Get().Info(__FUNCTION__,": ", __VA_ARGS__)
 #define XYZ_LOG_WARN(...) Logger::Get().Warn(__FUNCTION__,": ",__VA_ARGS__)
 #define XYZ_LOG_ERR(...)  Logger::Get().Error(__FUNCTION__,": ",__VA_ARGS__)
 #define XYZ_LOG_API(...)  Logger::Get().API(__FUNCTION__,": ",__VA_ARGS__)
-}
\ No newline at end of file
+}
@@ -0,0 +1,395 @@
+#include "stdafx.h"
+#include "BaselineDynamicTree.h"
+
+// Dynamic tree as it was before fat leaves, refit and batched queries, kept unchanged as benchmark baseline
+
+namespace XYZ {
+	bool BaselineDynamicTree::RayCast(const Ray& ray, uint32_t& result)
+	{
+		if (m_RootIndex == NULL_NODE)
+			return false;
+
+		float closest = std::numeric_limits<float>::max();
+		bool hit = false;
+
+		// Nodes are stored with their entry distance, subtrees farther than closest hit are skipped
+		std::stack<std::pair<int32_t, float>> stack;
+		float distance;
+		if (ray.IntersectsAABB(m_Nodes[m_RootIndex].Box, distance))
+			stack.push({ m_RootIndex, distance });
+
+		while (!stack.empty())
+		{
+			auto [index, entry] = stack.top();
+			stack.pop();
+			if (entry >= closest)
+				continue;
+
+			const BaselineNode& node = m_Nodes[index];
+			if (node.IsLeaf())
+			{
+				closest = entry;
+				result = node.DataIndex;
+				hit = true;
+				continue;
+			}
+
+			float firstDistance, secondDistance;
+			const bool first = ray.IntersectsAABB(m_Nodes[node.FirstChild].Box, firstDistance) && firstDistance < closest;
+			const bool second = ray.IntersectsAABB(m_Nodes[node.SecondChild].Box, secondDistance) && secondDistance < closest;
+			// Nearer child is pushed last so it is visited first
+			if (first && second)
+			{
+				if (firstDistance < secondDistance)
+				{
+					stack.push({ node.SecondChild, secondDistance });
+					stack.push({ node.FirstChild, firstDistance });
+				}
+				else
+				{
+					stack.push({ node.FirstChild, firstDistance });
+					stack.push({ node.SecondChild, secondDistance });
+				}
+			}
+			else if (first)
+				stack.push({ node.FirstChild, firstDistance });
+			else if (second)
+				stack.push({ node.SecondChild, secondDistance });
+		}
+		return hit;
+	}
+	void BaselineDynamicTree::Query(const CollisionCallback& callback, const AABB& aabb)
+	{
+		std::stack<int32_t> stack;
+		stack.push(m_RootIndex);
+		while (!stack.empty())
+		{
+			int32_t index = stack.top();
+			stack.pop();
+			if (index == NULL_NODE)
+				continue;
+
+			const BaselineNode& node = m_Nodes[index];
+			if (node.Box.Intersect(aabb))
+			{
+				if (node.IsLeaf())
+				{
+					bool proceed = callback(index);
+					if (proceed)
+						return;
+				}
+				else
+				{
+					stack.push(node.FirstChild);
+					stack.push(node.SecondChild);
+				}
+			}
+		}
+	}
+	int32_t BaselineDynamicTree::Insert(uint32_t objectIndex, const AABB& box)
+	{
+		int32_t leaf = m_Nodes.Insert({ box , objectIndex });
+		
+		if (m_MovedNodes.size() < m_Nodes.Range())
+			m_MovedNodes.resize(m_Nodes.Range());
+		insertLeaf(leaf);
+		return leaf;
+	}
+	void BaselineDynamicTree::Move(int32_t index, const AABB& box)
+	{
+		removeLeaf(index);
+
+		m_Nodes[index].Box = box;
+
+		m_MovedNodes[index] = true;
+		insertLeaf(index);
+	}
+	void BaselineDynamicTree::insertLeaf(int32_t leaf)
+	{
+		if (m_RootIndex == NULL_NODE)
+		{
+			m_RootIndex = leaf;
+			return;
+		}
+
+		AABB leafAABB = m_Nodes[leaf].Box;
+		int32_t index = m_RootIndex;
+		while (!m_Nodes[index].IsLeaf())
+		{
+			int32_t firstChild = m_Nodes[index].FirstChild;
+			int32_t secondChild = m_Nodes[index].SecondChild;
+
+			float area = m_Nodes[index].Box.GetPerimeter();
+
+			AABB combinedAABB = AABB::Union(m_Nodes[index].Box, leafAABB);
+			float combinedArea = combinedAABB.GetPerimeter();
+
+			// Cost of creating a new parent for this node and the new leaf
+			float cost = 2.0f * combinedArea;
+
+			// Minimum cost of pushing the leaf further down the tree
+			float inheritanceCost = 2.0f * (combinedArea - area);
+
+			// Cost of descending into child1
+			float cost1;
+			if (m_Nodes[firstChild].IsLeaf())
+			{
+				AABB aabb = AABB::Union(leafAABB, m_Nodes[firstChild].Box);
+				cost1 = aabb.GetPerimeter() + inheritanceCost;
+			}
+			else
+			{
+				AABB aabb = AABB::Union(leafAABB, m_Nodes[firstChild].Box);
+				float oldArea = m_Nodes[firstChild].Box.GetPerimeter();
+				float newArea = aabb.GetPerimeter();
+				cost1 = (newArea - oldArea) + inheritanceCost;
+			}
+
+			// Cost of descending into child2
+			float cost2;
+			if (m_Nodes[secondChild].IsLeaf())
+			{
+				AABB aabb = AABB::Union(leafAABB, m_Nodes[secondChild].Box);
+				cost2 = aabb.GetPerimeter() + inheritanceCost;
+			}
+			else
+			{
+				AABB aabb = AABB::Union(leafAABB, m_Nodes[secondChild].Box);
+				float oldArea = m_Nodes[secondChild].Box.GetPerimeter();
+				float newArea = aabb.GetPerimeter();
+				cost2 = newArea - oldArea + inheritanceCost;
+			}
+
+			// Descend according to the minimum cost.
+			if (cost < cost1 && cost < cost2)
+			{
+				break;
+			}
+
+			// Descend
+			if (cost1 < cost2)
+			{
+				index = firstChild;
+			}
+			else
+			{
+				index = secondChild;
+			}
+		}
+		int32_t sibling = index;
+
+		// Create a new parent.
+		int32_t oldParent = m_Nodes[sibling].ParentIndex;
+		int32_t newParent = m_Nodes.Insert({ AABB::Union(leafAABB, m_Nodes[sibling].Box), 0, oldParent });
+		m_Nodes[newParent].Height = m_Nodes[sibling].Height + 1;
+
+		if (oldParent != NULL_NODE)
+		{
+			// The sibling was not the root.
+			if (m_Nodes[oldParent].FirstChild == sibling)
+			{
+				m_Nodes[oldParent].FirstChild = newParent;
+			}
+			else
+			{
+				m_Nodes[oldParent].SecondChild = newParent;
+			}
+
+			m_Nodes[newParent].FirstChild = sibling;
+			m_Nodes[newParent].SecondChild = leaf;
+			m_Nodes[sibling].ParentIndex = newParent;
+			m_Nodes[leaf].ParentIndex = newParent;
+		}
+		else
+		{
+			// The sibling was the root.
+			m_Nodes[newParent].FirstChild = sibling;
+			m_Nodes[newParent].SecondChild = leaf;
+			m_Nodes[sibling].ParentIndex = newParent;
+			m_Nodes[leaf].ParentIndex = newParent;
+			m_RootIndex = newParent;
+		}
+
+		// Walk back up the tree fixing heights and AABBs
+		index = m_Nodes[leaf].ParentIndex;
+		while (index != NULL_NODE)
+		{
+			index = balance(index);
+
+			int32_t child1 = m_Nodes[index].FirstChild;
+			int32_t child2 = m_Nodes[index].SecondChild;
+
+			m_Nodes[index].Height = 1 + std::max(m_Nodes[child1].Height, m_Nodes[child2].Height);
+			m_Nodes[index].Box = AABB::Union(m_Nodes[child1].Box, m_Nodes[child2].Box);
+
+			index = m_Nodes[index].ParentIndex;
+		}
+	}
+
+	void BaselineDynamicTree::removeLeaf(int32_t index)
+	{
+		if (index == m_RootIndex)
+		{
+			m_RootIndex = NULL_NODE;
+			return;
+		}
+		int32_t parent = m_Nodes[index].ParentIndex;
+		int32_t grandParent = m_Nodes[parent].ParentIndex;
+		int32_t sibling;
+		if (m_Nodes[parent].FirstChild == index)
+		{
+			sibling = m_Nodes[parent].SecondChild;
+		}
+		else
+		{
+			sibling = m_Nodes[parent].FirstChild;
+		}
+		if (grandParent != NULL_NODE)
+		{
+			if (m_Nodes[grandParent].FirstChild == parent)
+				m_Nodes[grandParent].FirstChild = sibling;
+			else
+				m_Nodes[grandParent].SecondChild = sibling;
+
+			m_Nodes[sibling].ParentIndex = grandParent;
+			m_Nodes.Erase(parent);
+
+			int32_t tmpIndex = grandParent;
+			while (tmpIndex != NULL_NODE)
+			{
+				tmpIndex = balance(tmpIndex);
+				int32_t firstChild = m_Nodes[tmpIndex].FirstChild;
+				int32_t secondChild = m_Nodes[tmpIndex].SecondChild;
+			
+				m_Nodes[tmpIndex].Box = AABB::Union(m_Nodes[firstChild].Box, m_Nodes[secondChild].Box);
+				m_Nodes[tmpIndex].Height = 1 + std::max(m_Nodes[firstChild].Height, m_Nodes[secondChild].Height);
+						
+				tmpIndex = m_Nodes[tmpIndex].ParentIndex;
+			}
+		}
+		else
+		{
+			m_RootIndex = sibling;
+			m_Nodes[sibling].ParentIndex = NULL_NODE;
+			m_Nodes.Erase(parent);
+		}
+	}
+
+	int32_t BaselineDynamicTree::balance(int32_t iA)
+	{
+		BaselineNode* A = &m_Nodes[iA];
+		if (A->IsLeaf() || A->Height < 2)
+		{
+			return iA;
+		}
+		int32_t iB = A->FirstChild;
+		int32_t iC = A->SecondChild;
+
+		BaselineNode* B = &m_Nodes[iB];
+		BaselineNode* C = &m_Nodes[iC];
+
+		int32_t bal = C->Height - B->Height;
+		// Rotate C up
+		if (bal > 1)
+		{
+			int32_t iF = C->FirstChild;
+			int32_t iG = C->SecondChild;
+			BaselineNode* F = &m_Nodes[iF];
+			BaselineNode* G = &m_Nodes[iG];
+
+			C->FirstChild = iA;
+			C->ParentIndex = A->ParentIndex;
+			A->ParentIndex = iC;
+			if (C->ParentIndex != NULL_NODE)
+			{
+				if (m_Nodes[C->ParentIndex].FirstChild == iA)
+					m_Nodes[C->ParentIndex].FirstChild = iC;
+				else
+					m_Nodes[C->ParentIndex].SecondChild = iC;
+			}
+			else
+				m_RootIndex = iC;
+
+			if (F->Height > G->Height)
+			{
+				C->SecondChild = iF;
+				A->SecondChild = iG;
+				G->ParentIndex = iA;
+				A->Box = AABB::Union(B->Box, G->Box);
+				C->Box = AABB::Union(A->Box, F->Box);
+
+				A->Height = 1 + std::max(B->Height, G->Height);
+				C->Height = 1 + std::max(A->Height, F->Height);
+			}
+			else
+			{
+				C->SecondChild = iG;
+				A->SecondChild = iF;
+				F->ParentIndex = iA;
+				A->Box = AABB::Union(B->Box, F->Box);
+				C->Box = AABB::Union(A->Box, G->Box);
+
+				A->Height = 1 + std::max(B->Height, F->Height);
+				C->Height = 1 + std::max(A->Height, G->Height);
+			}
+			return iC;
+		}
+		
+		if (bal < -1)
+		{
+			int32_t iD = B->FirstChild;
+			int32_t iE = B->SecondChild;
+			BaselineNode* D = &m_Nodes[iD];
+			BaselineNode* E = &m_Nodes[iE];
+		
+			// Swap A and B
+			B->FirstChild = iA;
+			B->ParentIndex = A->ParentIndex;
+			A->ParentIndex = iB;
+
+			// A's old parent should point to B
+			if (B->ParentIndex != NULL_NODE)
+			{
+				if (m_Nodes[B->ParentIndex].FirstChild == iA)
+				{
+					m_Nodes[B->ParentIndex].FirstChild = iB;
+				}
+				else
+				{
+					m_Nodes[B->ParentIndex].SecondChild = iB;
+				}
+			}
+			else
+			{
+				m_RootIndex = iB;
+			}
+
+			// Rotate
+			if (D->Height > E->Height)
+			{
+				B->SecondChild = iD;
+				A->FirstChild = iE;
+				E->ParentIndex = iA;
+				A->Box = AABB::Union(C->Box, E->Box);
+				B->Box = AABB::Union(A->Box, D->Box);
+
+				A->Height = 1 + std::max(C->Height, E->Height);
+				B->Height = 1 + std::max(A->Height, D->Height);
+			}
+			else
+			{
+				B->SecondChild = iE;
+				A->FirstChild = iD;
+				D->ParentIndex = iA;
+				A->Box = AABB::Union(C->Box, D->Box);
+				B->Box = AABB::Union(A->Box, E->Box);
+
+				A->Height = 1 + std::max(C->Height, D->Height);
+				B->Height = 1 + std::max(A->Height, E->Height);
+			}
+
+			return iB;
+		}
+		return iA;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,43 @@
+#pragma once
+#include "XYZ/Utils/DataStructures/DynamicTree.h"
+
+#include <stack>
+
+namespace XYZ {
+
+	struct BaselineNode
+	{
+		AABB	 Box;
+		uint32_t DataIndex;
+
+		int32_t ParentIndex = NULL_NODE;
+		int32_t FirstChild = NULL_NODE;
+		int32_t SecondChild = NULL_NODE;
+		int32_t Height = 0;
+
+		bool IsLeaf() const { return FirstChild == NULL_NODE; }
+	};
+
+	// Copy of the dynamic tree before fat leaves, refit and batched queries.
+	// Every move reinserts the leaf and traversal uses std::stack, used only as benchmark baseline
+	class BaselineDynamicTree
+	{
+	public:
+		bool RayCast(const Ray& ray, uint32_t& result);
+		void Query(const CollisionCallback& callback, const AABB& aabb);
+
+		int32_t Insert(uint32_t objectIndex, const AABB& box);
+		void Move(int32_t index, const AABB& box);
+
+	private:
+		void insertLeaf(int32_t index);
+		void removeLeaf(int32_t leaf);
+		int32_t balance(int32_t index);
+
+	private:
+		FreeList<BaselineNode> m_Nodes;
+
+		std::vector<bool> m_MovedNodes;
+		int32_t m_RootIndex = NULL_NODE;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,142 @@
+#include "stdafx.h"
+#include "DynamicTreeBenchmark.h"
+#include "BaselineDynamicTree.h"
+
+#include <chrono>
+#include <random>
+
+namespace XYZ {
+
+	template <typename Func>
+	static double MeasureMs(Func&& func)
+	{
+		auto start = std::chrono::high_resolution_clock::now();
+		func();
+		auto end = std::chrono::high_resolution_clock::now();
+		return std::chrono::duration<double, std::milli>(end - start).count();
+	}
+
+	static AABB RandomBox(std::mt19937& generator, float worldSize, float maxSize)
+	{
+		std::uniform_real_distribution<float> position(-worldSize, worldSize);
+		std::uniform_real_distribution<float> size(0.1f, maxSize);
+		const glm::vec3 center(position(generator), position(generator), 0.0f);
+		const glm::vec3 extents(size(generator), size(generator), 0.0f);
+		return AABB(center - extents, center + extents);
+	}
+
+	template <typename Tree>
+	static void MoveAll(Tree& tree, const std::vector<int32_t>& leaves, std::vector<AABB>& boxes, std::mt19937& generator)
+	{
+		std::uniform_real_distribution<float> displacement(-0.02f, 0.02f);
+		for (size_t i = 0; i < leaves.size(); ++i)
+		{
+			const glm::vec2 offset(displacement(generator), displacement(generator));
+			boxes[i] = boxes[i] + offset;
+			tree.Move(leaves[i], boxes[i]);
+		}
+	}
+
+	DynamicTreeBenchmarkResult RunDynamicTreeBenchmark(uint32_t leafCount, uint32_t queryCount)
+	{
+		const float worldSize = 1000.0f;
+		std::mt19937 generator(1337);
+
+		DynamicTreeBenchmarkResult result;
+		result.LeafCount = leafCount;
+		result.QueryCount = queryCount;
+
+		std::vector<AABB> boxes(leafCount);
+		for (AABB& box : boxes)
+			box = RandomBox(generator, worldSize, 2.0f);
+
+		BaselineDynamicTree baselineTree;
+		DynamicTree tree;
+		std::vector<int32_t> baselineLeaves(leafCount), leaves(leafCount);
+		for (uint32_t i = 0; i < leafCount; ++i)
+		{
+			baselineLeaves[i] = baselineTree.Insert(i, boxes[i]);
+			leaves[i] = tree.Insert(i, boxes[i]);
+		}
+
+		// Both trees receive the same moves and end with the same boxes
+		std::vector<AABB> baselineBoxes = boxes;
+		std::mt19937 moveGenerator(7);
+		result.MoveBaselineMs = MeasureMs([&]() { MoveAll(baselineTree, baselineLeaves, baselineBoxes, moveGenerator); });
+		moveGenerator.seed(7);
+		result.MoveFatMs = MeasureMs([&]() { MoveAll(tree, leaves, boxes, moveGenerator); });
+		result.RefitMs = MeasureMs([&]() {
+			for (uint32_t i = 0; i < leafCount; ++i)
+				tree.SetAABB(leaves[i], boxes[i]);
+			tree.Refit();
+		});
+
+		// Queries of screen sized areas
+		std::vector<AABB> queries(queryCount);
+		for (AABB& query : queries)
+			query = RandomBox(generator, worldSize, 50.0f);
+
+		std::vector<uint32_t> baselineCounts(queryCount, 0), counts(queryCount, 0), batchCounts(queryCount, 0);
+		result.QueryBaselineMs = MeasureMs([&]() {
+			for (uint32_t i = 0; i < queryCount; ++i)
+				baselineTree.Query([&](int32_t) { baselineCounts[i]++; return false; }, queries[i]);
+		});
+		result.QueryMs = MeasureMs([&]() {
+			for (uint32_t i = 0; i < queryCount; ++i)
+				tree.Query([&](int32_t) { counts[i]++; return false; }, queries[i]);
+		});
+		std::vector<QueryHit> queryHits;
+		result.QueryBatchMs = MeasureMs([&]() {
+			tree.QueryBatch(queries.data(), queryCount, queryHits);
+		});
+		for (const QueryHit& hit : queryHits)
+			batchCounts[hit.QueryIndex]++;
+
+		// Rays from the camera towards the plane
+		std::uniform_real_distribution<float> position(-worldSize, worldSize);
+		std::vector<Ray> rays;
+		rays.reserve(queryCount);
+		for (uint32_t i = 0; i < queryCount; ++i)
+			rays.emplace_back(glm::vec3(position(generator), position(generator), 10.0f), glm::vec3(0.001f, 0.001f, -1.0f));
+
+		std::vector<uint32_t> baselineRayHits(queryCount, 0), rayHits(queryCount, 0);
+		std::vector<bool> baselineRayHitFound(queryCount, false), rayHitFound(queryCount, false);
+		result.RayCastBaselineMs = MeasureMs([&]() {
+			for (uint32_t i = 0; i < queryCount; ++i)
+				baselineRayHitFound[i] = baselineTree.RayCast(rays[i], baselineRayHits[i]);
+		});
+		result.RayCastMs = MeasureMs([&]() {
+			for (uint32_t i = 0; i < queryCount; ++i)
+				rayHitFound[i] = tree.RayCast(rays[i], rayHits[i]);
+		});
+		std::vector<RayCastHit> batchRayHits;
+		result.RayCastBatchMs = MeasureMs([&]() {
+			tree.RayCastBatch(rays.data(), queryCount, batchRayHits);
+		});
+
+		for (uint32_t i = 0; i < queryCount; ++i)
+		{
+			if (baselineCounts[i] != counts[i] || counts[i] != batchCounts[i])
+				result.Mismatches++;
+			const bool batchHit = batchRayHits[i].Distance != std::numeric_limits<float>::infinity();
+			if (baselineRayHitFound[i] != rayHitFound[i] || rayHitFound[i] != batchHit)
+				result.Mismatches++;
+			else if (batchHit)
+			{
+				// Closest leaf can differ only if more leaves are hit at equal distance
+				float baselineDistance, distance;
+				rays[i].IntersectsAABB(boxes[baselineRayHits[i]], baselineDistance);
+				rays[i].IntersectsAABB(boxes[rayHits[i]], distance);
+				if (baselineDistance != batchRayHits[i].Distance || distance != batchRayHits[i].Distance)
+					result.Mismatches++;
+			}
+		}
+
+		XYZ_LOG_INFO("Dynamic tree ", leafCount, " leaves, ", queryCount, " queries: move baseline ", result.MoveBaselineMs,
+			"ms, move fat ", result.MoveFatMs, "ms, refit ", result.RefitMs,
+			"ms, query baseline ", result.QueryBaselineMs, "ms, query ", result.QueryMs, "ms, query batch ", result.QueryBatchMs,
+			"ms, ray cast baseline ", result.RayCastBaselineMs, "ms, ray cast ", result.RayCastMs, "ms, ray cast batch ", result.RayCastBatchMs,
+			"ms, mismatches ", result.Mismatches);
+		return result;
+	}
+}
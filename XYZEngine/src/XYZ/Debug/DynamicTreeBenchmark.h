@@ -0,0 +1,28 @@
+#pragma once
+#include "XYZ/Utils/DataStructures/DynamicTree.h"
+
+namespace XYZ {
+
+	struct DynamicTreeBenchmarkResult
+	{
+		uint32_t LeafCount = 0;
+		uint32_t QueryCount = 0;
+		// Milliseconds of moving every leaf by small displacement.
+		// Baselines run BaselineDynamicTree, copy of the tree before fat leaves and batched queries
+		double MoveBaselineMs = 0.0;
+		double MoveFatMs = 0.0;
+		double RefitMs = 0.0;
+		// Milliseconds of all queries
+		double QueryBaselineMs = 0.0;
+		double QueryMs = 0.0;
+		double QueryBatchMs = 0.0;
+		double RayCastBaselineMs = 0.0;
+		double RayCastMs = 0.0;
+		double RayCastBatchMs = 0.0;
+		// Queries whose results differ between baseline, single and batched versions
+		uint32_t Mismatches = 0;
+	};
+
+	// Builds random trees and compares update and query strategies with the baseline, logs the timings
+	DynamicTreeBenchmarkResult RunDynamicTreeBenchmark(uint32_t leafCount, uint32_t queryCount);
+}
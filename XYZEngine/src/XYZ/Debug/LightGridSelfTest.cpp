@@ -0,0 +1,89 @@
+#include "stdafx.h"
+#include "LightGridSelfTest.h"
+
+#include "XYZ/Renderer/LightGrid.h"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+namespace XYZ {
+
+	// Viewport of 4x4 tiles, world units match pixels
+	static constexpr uint32_t sc_TileSize = 16;
+	static constexpr float    sc_ViewportSize = 64.0f;
+
+	static void BeginGrid(LightGrid& grid)
+	{
+		const glm::mat4 viewProjection = glm::ortho(0.0f, sc_ViewportSize, 0.0f, sc_ViewportSize);
+		grid.Begin(viewProjection, glm::vec2(sc_ViewportSize), sc_TileSize);
+	}
+
+	static bool TileContains(const LightGrid& grid, uint32_t x, uint32_t y, LightGrid::LightType type, uint32_t index)
+	{
+		const LightTile& tile = grid.GetTiles()[(size_t)y * grid.GetTileCount().x + x];
+		const uint32_t begin = tile.Offset + (type == LightGrid::Point ? 0 : tile.PointLightCount);
+		const uint32_t end = begin + (type == LightGrid::Point ? tile.PointLightCount : tile.SpotLightCount);
+		const auto& indices = grid.GetLightIndices();
+		return std::find(indices.begin() + begin, indices.begin() + end, index) != indices.begin() + end;
+	}
+
+	static uint32_t CountTilesWithLights(const LightGrid& grid)
+	{
+		uint32_t count = 0;
+		for (const LightTile& tile : grid.GetTiles())
+		{
+			if (tile.PointLightCount + tile.SpotLightCount != 0)
+				count++;
+		}
+		return count;
+	}
+
+#define LIGHT_GRID_CHECK(condition) if (!(condition)) { XYZ_LOG_ERR("Light grid self test failed: ", #condition); return false; }
+
+	bool RunLightGridSelfTest()
+	{
+		LightGrid grid;
+
+		// Light on the border of two tiles is binned to both of them
+		BeginGrid(grid);
+		grid.AddLight(LightGrid::Point, 0, glm::vec2(16.0f, 8.0f), 1.0f);
+		grid.End();
+		LIGHT_GRID_CHECK(grid.GetTileCount() == glm::uvec2(4, 4));
+		LIGHT_GRID_CHECK(TileContains(grid, 0, 0, LightGrid::Point, 0));
+		LIGHT_GRID_CHECK(TileContains(grid, 1, 0, LightGrid::Point, 0));
+		LIGHT_GRID_CHECK(CountTilesWithLights(grid) == 2);
+
+		// Light off the screen is culled
+		BeginGrid(grid);
+		grid.AddLight(LightGrid::Point, 0, glm::vec2(-100.0f, 32.0f), 10.0f);
+		grid.AddLight(LightGrid::Spot, 1, glm::vec2(32.0f, 200.0f), 10.0f);
+		grid.End();
+		LIGHT_GRID_CHECK(grid.GetVisibleLightCount() == 0);
+		LIGHT_GRID_CHECK(grid.GetLightIndices().empty());
+		LIGHT_GRID_CHECK(CountTilesWithLights(grid) == 0);
+
+		// Light partially off the screen is clamped to the edge tiles
+		BeginGrid(grid);
+		grid.AddLight(LightGrid::Spot, 3, glm::vec2(-2.0f, 70.0f), 8.0f);
+		grid.End();
+		LIGHT_GRID_CHECK(grid.GetVisibleLightCount() == 1);
+		LIGHT_GRID_CHECK(TileContains(grid, 0, 3, LightGrid::Spot, 3));
+		LIGHT_GRID_CHECK(CountTilesWithLights(grid) == 1);
+
+		// Tile lists have no fixed capacity, crowded tile keeps every light in order of submission
+		const uint32_t crowdedCount = 1024;
+		BeginGrid(grid);
+		for (uint32_t i = 0; i < crowdedCount; ++i)
+			grid.AddLight(i % 2 ? LightGrid::Spot : LightGrid::Point, i, glm::vec2(40.0f, 40.0f), 2.0f);
+		grid.End();
+		const LightTile& tile = grid.GetTiles()[2 * grid.GetTileCount().x + 2];
+		LIGHT_GRID_CHECK(tile.PointLightCount == crowdedCount / 2);
+		LIGHT_GRID_CHECK(tile.SpotLightCount == crowdedCount / 2);
+		LIGHT_GRID_CHECK(grid.GetLightIndices().size() == crowdedCount);
+		for (uint32_t i = 0; i < crowdedCount; ++i)
+		{
+			const uint32_t slot = tile.Offset + (i % 2 ? tile.PointLightCount : 0) + i / 2;
+			LIGHT_GRID_CHECK(grid.GetLightIndices()[slot] == i);
+		}
+		return true;
+	}
+}
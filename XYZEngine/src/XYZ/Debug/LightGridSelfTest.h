@@ -0,0 +1,7 @@
+#pragma once
+
+namespace XYZ {
+
+	// Headless checks of light binning, returns false and logs the first failed check
+	bool RunLightGridSelfTest();
+}
@@ -0,0 +1,107 @@
+#include "stdafx.h"
+#include "ShaderCacheSelfTest.h"
+
+#include "XYZ/API/OpenGL/OpenGLShaderCache.h"
+
+#include <filesystem>
+
+namespace XYZ {
+
+	static constexpr const char* sc_TestShaderPath = "SelfTest/ShaderCacheSelfTest.glsl";
+
+	static Uniform CreateUniform(const std::string& name, UniformDataType type, ShaderType shaderType, uint32_t offset, uint32_t size, uint32_t count)
+	{
+		// Location is resolved after link, cache must not depend on it
+		return Uniform{ name, type, shaderType, offset, size, count, 42 };
+	}
+
+	// Reflection the parser produces for a shader with a matrix, a uniform array, a struct member and two samplers
+	static OpenGLShaderCacheEntry CreateTestEntry(uint64_t sourceHash)
+	{
+		UniformList vsUniforms;
+		vsUniforms.Uniforms.push_back(CreateUniform("u_Transform", UniformDataType::Mat4, ShaderType::Vertex, 0, 64, 1));
+		vsUniforms.Uniforms.push_back(CreateUniform("u_Bones", UniformDataType::Mat4, ShaderType::Vertex, 64, 64 * 4, 4));
+		vsUniforms.Size = 64 + 64 * 4;
+
+		UniformList fsUniforms;
+		fsUniforms.Uniforms.push_back(CreateUniform("u_Light.Color", UniformDataType::Vec3, ShaderType::Fragment, 0, 12, 1));
+		fsUniforms.Uniforms.push_back(CreateUniform("u_Light.Intensity", UniformDataType::Float, ShaderType::Fragment, 12, 4, 1));
+		fsUniforms.Uniforms.push_back(CreateUniform("u_Tiling", UniformDataType::Vec2, ShaderType::Fragment, 16, 8, 1));
+		fsUniforms.Size = 24;
+
+		TextureUniformList textures;
+		textures.Textures.push_back({ "u_Texture", 0, 8 });
+		textures.Textures.push_back({ "u_Shadow", 8, 1 });
+		textures.Count = 9;
+
+		OpenGLShaderCacheEntry entry = OpenGLShaderCache::CreateEntry(sourceHash, false, vsUniforms, fsUniforms, textures);
+		entry.BinaryFormat = 0x8E7D;
+		entry.Binary = { 1, 2, 3, 4, 5, 6, 7, 8 };
+		return entry;
+	}
+
+#define SHADER_CACHE_CHECK(condition) if (!(condition)) { XYZ_LOG_ERR("Shader cache self test failed: ", #condition); return false; }
+
+	static bool RunShaderCacheChecks(const std::string& cachePath)
+	{
+		const uint64_t sourceHash = OpenGLShaderCache::HashSource("#type vertex\n#type fragment\n");
+		const OpenGLShaderCacheEntry original = CreateTestEntry(sourceHash);
+		SHADER_CACHE_CHECK(OpenGLShaderCache::IsReflectionEqual(original, CreateTestEntry(sourceHash)));
+
+		// Round trip keeps reflection and binary, locations are left for the linked program
+		SHADER_CACHE_CHECK(OpenGLShaderCache::Save(sc_TestShaderPath, original));
+		OpenGLShaderCacheEntry loaded;
+		SHADER_CACHE_CHECK(OpenGLShaderCache::Load(sc_TestShaderPath, sourceHash, loaded));
+		SHADER_CACHE_CHECK(OpenGLShaderCache::IsReflectionEqual(original, loaded));
+		SHADER_CACHE_CHECK(loaded.BinaryFormat == original.BinaryFormat);
+		SHADER_CACHE_CHECK(loaded.Binary == original.Binary);
+		for (const Uniform& uniform : loaded.VSUniformList.Uniforms)
+			SHADER_CACHE_CHECK(uniform.Location == 0);
+
+		// Edited source does not hit the cache
+		OpenGLShaderCacheEntry stale;
+		SHADER_CACHE_CHECK(!OpenGLShaderCache::Load(sc_TestShaderPath, sourceHash + 1, stale));
+
+		// Every reflected field takes part in the comparison
+		OpenGLShaderCacheEntry changed = original;
+		changed.FSUniformList.Uniforms[1].Offset = 16;
+		SHADER_CACHE_CHECK(!OpenGLShaderCache::IsReflectionEqual(original, changed));
+		changed = original;
+		changed.VSUniformList.Uniforms[1].Count = 3;
+		SHADER_CACHE_CHECK(!OpenGLShaderCache::IsReflectionEqual(original, changed));
+		changed = original;
+		changed.FSUniformList.Uniforms[0].Name = "u_Light.Colour";
+		SHADER_CACHE_CHECK(!OpenGLShaderCache::IsReflectionEqual(original, changed));
+		changed = original;
+		changed.TextureList.Textures[1].Slot = 9;
+		SHADER_CACHE_CHECK(!OpenGLShaderCache::IsReflectionEqual(original, changed));
+		changed = original;
+		changed.IsCompute = true;
+		SHADER_CACHE_CHECK(!OpenGLShaderCache::IsReflectionEqual(original, changed));
+		changed = original;
+		changed.VSUniformList.Uniforms[0].Location = 7;
+		changed.Binary.clear();
+		SHADER_CACHE_CHECK(OpenGLShaderCache::IsReflectionEqual(original, changed));
+
+		// Truncated cache is rejected instead of returning partial reflection
+		std::error_code error;
+		const uintmax_t fileSize = std::filesystem::file_size(cachePath, error);
+		SHADER_CACHE_CHECK(!error);
+		std::filesystem::resize_file(cachePath, fileSize - 3, error);
+		SHADER_CACHE_CHECK(!error);
+		OpenGLShaderCacheEntry truncated;
+		SHADER_CACHE_CHECK(!OpenGLShaderCache::Load(sc_TestShaderPath, sourceHash, truncated));
+		SHADER_CACHE_CHECK(truncated.VSUniformList.Uniforms.empty());
+		return true;
+	}
+
+	bool RunShaderCacheSelfTest()
+	{
+		const std::string cachePath = OpenGLShaderCache::GetCachePath(sc_TestShaderPath);
+		const bool result = RunShaderCacheChecks(cachePath);
+
+		std::error_code error;
+		std::filesystem::remove(cachePath, error);
+		return result;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,7 @@
+#pragma once
+
+namespace XYZ {
+
+	// Headless round trip of shader reflection through the shader cache, returns false and logs the first failed check
+	bool RunShaderCacheSelfTest();
+}
\ No newline at end of file
@@ -0,0 +1,102 @@
+#include "stdafx.h"
+#include "SkinningBenchmark.h"
+
+#include <glm/gtx/transform.hpp>
+
+#include <chrono>
+#include <random>
+
+namespace XYZ {
+
+	template <typename Func>
+	static double MeasureMs(uint32_t iterations, Func&& func)
+	{
+		func(); // Warm up caches
+		auto start = std::chrono::high_resolution_clock::now();
+		for (uint32_t i = 0; i < iterations; ++i)
+			func();
+		auto end = std::chrono::high_resolution_clock::now();
+		return std::chrono::duration<double, std::milli>(end - start).count() / (double)iterations;
+	}
+
+	static float MaxDifference(const SkinnedPositions& a, const SkinnedPositions& b)
+	{
+		float result = 0.0f;
+		for (uint32_t i = 0; i < a.GetCount(); ++i)
+		{
+			result = std::max(result, std::abs(a.X[i] - b.X[i]));
+			result = std::max(result, std::abs(a.Y[i] - b.Y[i]));
+			result = std::max(result, std::abs(a.Z[i] - b.Z[i]));
+		}
+		return result;
+	}
+
+	SkinningBenchmarkResult RunSkinningBenchmark(uint32_t vertexCount, uint32_t boneCount, uint32_t iterations, ThreadPool* pool)
+	{
+		std::mt19937 generator(1337);
+		std::uniform_real_distribution<float> position(-10.0f, 10.0f);
+		std::uniform_real_distribution<float> angle(-3.14f, 3.14f);
+		std::uniform_real_distribution<float> weight(0.0f, 1.0f);
+		std::uniform_int_distribution<uint32_t> bone(0, boneCount - 1);
+
+		std::vector<glm::mat4> palette(boneCount);
+		for (glm::mat4& transform : palette)
+		{
+			transform = glm::translate(glm::vec3(position(generator), position(generator), position(generator)))
+					  * glm::rotate(angle(generator), glm::vec3(0.0f, 0.0f, 1.0f));
+		}
+
+		SkinningStreams streams;
+		streams.Resize(vertexCount);
+		for (uint32_t i = 0; i < vertexCount; ++i)
+		{
+			uint32_t ids[SkinningStreams::sc_MaxInfluences];
+			float weights[SkinningStreams::sc_MaxInfluences];
+			float sum = 0.0f;
+			for (uint32_t k = 0; k < SkinningStreams::sc_MaxInfluences; ++k)
+			{
+				ids[k] = bone(generator);
+				weights[k] = weight(generator);
+				sum += weights[k];
+			}
+			for (float& w : weights)
+				w /= sum;
+			streams.SetVertex(i, glm::vec3(position(generator), position(generator), position(generator)), ids, weights);
+		}
+
+		SkinningBenchmarkResult result;
+		result.VertexCount = vertexCount;
+		result.Iterations = iterations;
+
+		SkinnedPositions reference, positions;
+		result.ScalarMs = MeasureMs(iterations, [&]() {
+			Skinning::Skin(palette.data(), streams, reference, SkinningBackend::Scalar);
+		});
+		if (Skinning::IsBackendSupported(SkinningBackend::SSE))
+		{
+			result.SSEMs = MeasureMs(iterations, [&]() {
+				Skinning::Skin(palette.data(), streams, positions, SkinningBackend::SSE);
+			});
+			result.MaxError = std::max(result.MaxError, MaxDifference(reference, positions));
+		}
+		if (Skinning::IsBackendSupported(SkinningBackend::AVX2))
+		{
+			result.AVX2Ms = MeasureMs(iterations, [&]() {
+				Skinning::Skin(palette.data(), streams, positions, SkinningBackend::AVX2);
+			});
+			result.MaxError = std::max(result.MaxError, MaxDifference(reference, positions));
+		}
+		if (pool)
+		{
+			result.ParallelMs = MeasureMs(iterations, [&]() {
+				Skinning::SkinParallel(palette.data(), streams, positions, *pool);
+			});
+			result.MaxError = std::max(result.MaxError, MaxDifference(reference, positions));
+		}
+
+		XYZ_LOG_INFO("Skinning ", vertexCount, " vertices, ", boneCount, " bones: scalar ", result.ScalarMs,
+			"ms, SSE ", result.SSEMs, "ms, AVX2 ", result.AVX2Ms, "ms, parallel ", result.ParallelMs,
+			"ms, max error ", result.MaxError);
+		return result;
+	}
+}
@@ -0,0 +1,21 @@
+#pragma once
+#include "XYZ/Animation/Skinning.h"
+
+namespace XYZ {
+
+	struct SkinningBenchmarkResult
+	{
+		uint32_t VertexCount = 0;
+		uint32_t Iterations = 0;
+		// Average milliseconds per skinning of all vertices
+		double ScalarMs = 0.0;
+		double SSEMs = 0.0;
+		double AVX2Ms = 0.0;
+		double ParallelMs = 0.0;
+		// Largest difference between scalar result and other backends
+		float  MaxError = 0.0f;
+	};
+
+	// Skins randomly generated mesh with every supported backend and logs the timings
+	SkinningBenchmarkResult RunSkinningBenchmark(uint32_t vertexCount, uint32_t boneCount, uint32_t iterations, ThreadPool* pool = nullptr);
+}
@@ -61,6 +61,7 @@ namespace XYZ {
 	void CallbackManager::Clear()
 	{
 		destroyStorages();
+		m_Storages.clear();
 	}
 	void CallbackManager::OnEntityDestroyed(uint32_t entity, const Signature& signature)
 	{
@@ -70,6 +71,14 @@ namespace XYZ {
 				storage->Execute(entity, CallbackType::EntityDestroy);
 		}
 	}
+	void CallbackManager::OnEntitiesDestroyed(const Entity* entities, size_t count)
+	{
+		for (auto storage : m_Storages)
+		{
+			if (storage)
+				storage->Execute(entities, count, CallbackType::EntityDestroy);
+		}
+	}
 	void CallbackManager::destroyStorages()
 	{
 		for (auto storage : m_Storages)
@@ -57,7 +57,16 @@ namespace XYZ {
 			storage.Execute(entity, CallbackType::ComponentRemove);
 		}
 
+		template <typename T>
+		void OnComponentsCreate(const Entity* entities, size_t count)
+		{
+			createStorage<T>();
+			CallbackStorage<T>& storage = GetStorage<T>();
+			storage.Execute(entities, count, CallbackType::ComponentCreate);
+		}
+
 		void OnEntityDestroyed(uint32_t entity, const Signature& signature);
+		void OnEntitiesDestroyed(const Entity* entities, size_t count);
 		
 		template <typename T>
 		CallbackStorage<T>& GetStorage()
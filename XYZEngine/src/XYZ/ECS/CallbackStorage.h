@@ -1,5 +1,6 @@
 #pragma once
 #include "XYZ/Utils/DataStructures/FreeList.h"
+#include "Entity.h"
 
 namespace XYZ {
 
@@ -28,6 +29,7 @@ namespace XYZ {
 		virtual ICallbackStorage* Copy(uint8_t* buffer) const = 0;
 		virtual ICallbackStorage* Copy() const = 0;
 		virtual void			  Execute(uint32_t entity, CallbackType type) = 0;
+		virtual void			  Execute(const Entity* entities, size_t count, CallbackType type) = 0;
 	};
 
 	template <typename T>
@@ -73,6 +75,14 @@ namespace XYZ {
 				listener.Callback(entity, type);
 			}
 		}
+		virtual void Execute(const Entity* entities, size_t count, CallbackType type) override
+		{
+			for (auto& listener : m_Listeners)
+			{
+				for (size_t i = 0; i < count; ++i)
+					listener.Callback(entities[i], type);
+			}
+		}
 
 		void AddListener(const std::function<void(uint32_t, CallbackType)>& callback, void* instance)
 		{
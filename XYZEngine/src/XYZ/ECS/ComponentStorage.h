@@ -19,6 +19,7 @@ namespace XYZ {
 		virtual void			   CopyComponentData(Entity entity, ByteStream& out) const = 0;
 		virtual void			   UpdateComponentData(Entity entity, const ByteStream& in) = 0;
 		virtual Entity			   EntityDestroyed(Entity entity) = 0;
+		virtual void			   EntitiesDestroyed(const Entity* entities, size_t count) = 0;
 		virtual uint32_t		   GetComponentIndex(Entity entity) const = 0;
 		virtual Entity			   GetEntityAtIndex(size_t index) const = 0;
 	
@@ -89,6 +90,11 @@ namespace XYZ {
 		{
 			return RemoveComponent(entity);
 		}
+		virtual void EntitiesDestroyed(const Entity* entities, size_t count) override
+		{
+			for (size_t i = 0; i < count; ++i)
+				RemoveComponent(entities[i]);
+		}
 		virtual uint32_t GetComponentIndex(Entity entity) const override
 		{
 			return m_EntityDataMap[(size_t)entity];
@@ -134,6 +140,33 @@ namespace XYZ {
 			return m_Data.back();
 		}
 
+		// Appends component constructed from the same args for every entity
+		template <typename ...Args>
+		void EmplaceComponents(const Entity* entities, size_t count, const Args& ... args)
+		{
+			const uint32_t first = (uint32_t)m_Data.size();
+			m_Data.reserve(m_Data.size() + count);
+			m_DataEntityMap.insert(m_DataEntityMap.end(), entities, entities + count);
+			for (size_t i = 0; i < count; ++i)
+			{
+				const uint32_t entity = entities[i];
+				if (m_EntityDataMap.size() <= entity)
+					m_EntityDataMap.resize((size_t)entity + 1);
+				m_EntityDataMap[entity] = first + (uint32_t)i;
+				m_Data.emplace_back(args...);
+			}
+		}
+
+		// Makes room for entities up to the entity range and additional components
+		void Reserve(size_t entityRange, size_t count)
+		{
+			if (m_EntityDataMap.size() < entityRange)
+				m_EntityDataMap.resize(entityRange);
+
+			m_Data.reserve(m_Data.size() + count);
+			m_DataEntityMap.reserve(m_DataEntityMap.size() + count);
+		}
+
 		T& GetComponent(Entity entity)
 		{
 			return m_Data[m_EntityDataMap[(size_t)entity]];
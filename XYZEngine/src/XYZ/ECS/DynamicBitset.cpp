@@ -30,13 +30,32 @@ namespace XYZ {
     {
         int32_t next = m_Signatures.Next();
         if (next == m_Signatures.Range())
-        {
-            for (uint8_t i = 0; i < m_BitCount; ++i)
-                m_Bitset.push_back(false);
-        }
+            m_Bitset.resize(m_Bitset.size() + m_BitCount, false);
+        
         return m_Signatures.Emplace(next, this);
     }
 
+    void DynamicBitset::CreateSignatures(uint32_t count, std::vector<int32_t>& result)
+    {
+        result.reserve(result.size() + count);
+        // Reuse free signatures first
+        uint32_t created = 0;
+        for (; created < count && m_Signatures.Next() != m_Signatures.Range(); ++created)
+            result.push_back(m_Signatures.Emplace(m_Signatures.Next(), this));
+
+        const uint32_t remaining = count - created;
+        m_Signatures.Reserve((size_t)m_Signatures.Range() + remaining);
+        m_Bitset.resize(m_Bitset.size() + (size_t)remaining * m_BitCount, false);
+        for (uint32_t i = 0; i < remaining; ++i)
+            result.push_back(m_Signatures.Emplace(m_Signatures.Range(), this));
+    }
+
+    void DynamicBitset::Reserve(size_t count)
+    {
+        m_Signatures.Reserve(count);
+        m_Bitset.reserve(count * m_BitCount);
+    }
+
     void DynamicBitset::DestroySignature(int32_t index)
     {
         m_Signatures[index].Reset();
@@ -80,6 +99,7 @@ namespace XYZ {
     }
     void DynamicBitset::Clear()
     {
+        m_Signatures.Clear();
         m_Bitset.clear();
         CreateSignature();
     }
@@ -14,7 +14,11 @@ namespace XYZ {
 		DynamicBitset& operator =(DynamicBitset&& other) noexcept;
 
 		int32_t CreateSignature();
+		// Appends indices of created signatures to the result, bits of new signatures are allocated at once
+		void CreateSignatures(uint32_t count, std::vector<int32_t>& result);
 		void DestroySignature(int32_t index);
+		// Reserves memory for the given number of signatures
+		void Reserve(size_t count);
 
 		Signature& GetSignature(int32_t index);
 		const Signature& GetSignature(int32_t index) const;
@@ -48,6 +48,31 @@ namespace XYZ {
 		m_ComponentManager.EntityDestroyed(entity, signature);
 		m_EntityManager.DestroyEntity(entity); 
 	}
+	void ECSManager::DestroyEntities(const Entity* entities, size_t count)
+	{
+		for (size_t i = 0; i < count; ++i)
+			XYZ_ASSERT(IsValid(entities[i]), "Entity is invalid");
+		m_CallbackManager.OnEntitiesDestroyed(entities, count);
+
+		// Remove components storage by storage, every storage gets its owners in one call
+		std::vector<Entity> owners;
+		owners.reserve(count);
+		for (auto storage : m_ComponentManager.m_Storages)
+		{
+			if (!storage)
+				continue;
+			const uint16_t id = storage->ID();
+			owners.clear();
+			for (size_t i = 0; i < count; ++i)
+			{
+				if (m_EntityManager.GetSignature(entities[i])[id])
+					owners.push_back(entities[i]);
+			}
+			if (!owners.empty())
+				storage->EntitiesDestroyed(owners.data(), owners.size());
+		}
+		m_EntityManager.DestroyEntities(entities, count);
+	}
 	void ECSManager::Clear()
 	{
 		m_ComponentManager.Clear();
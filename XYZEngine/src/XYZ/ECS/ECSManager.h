@@ -18,8 +18,18 @@ namespace XYZ {
 		Entity CopyEntity(Entity entity);
 		Entity CreateEntity();
 		void DestroyEntity(Entity entity);
+		// Entities must be unique, components are removed storage by storage
+		void DestroyEntities(const Entity* entities, size_t count);
 		void Clear();
 
+		// Appends created entities to the result, storages of Args are reserved for them
+		template <typename ...Args>
+		void CreateEntities(uint32_t count, std::vector<Entity>& result)
+		{
+			m_EntityManager.CreateEntities(count, result);
+			(reserveStorage<Args>(count), ...);
+		}
+
 		template <typename T>
 		void AddListener(const std::function<void(uint32_t, CallbackType)>& callback, void* instance)
 		{
@@ -49,6 +59,27 @@ namespace XYZ {
 			m_CallbackManager.OnComponentCreate<T>(entity);
 			return result;
 		}
+		// Emplaces component constructed from the same args to every entity.
+		// Signatures and storage are updated for all entities before the callbacks are executed
+		template <typename T, typename ...Args>
+		void EmplaceComponents(const Entity* entities, size_t count, const Args&... args)
+		{
+			// Make sure storage for component exists
+			m_ComponentManager.CreateStorage<T>();
+			// Update bitsets
+			m_EntityManager.SetNumberOfComponents(ComponentManager::s_NextComponentTypeID);
+			// Update signatures
+			for (size_t i = 0; i < count; ++i)
+			{
+				XYZ_ASSERT(IsValid(entities[i]), "Entity is invalid");
+				Signature& signature = m_EntityManager.GetSignature(entities[i]);
+				XYZ_ASSERT(!signature[Component<T>::ID()], "Entity already contains component");
+				signature.Set(Component<T>::ID(), true);
+			}
+			m_ComponentManager.GetStorage<T>().EmplaceComponents(entities, count, args...);
+			// Handle callbacks
+			m_CallbackManager.OnComponentsCreate<T>(entities, count);
+		}
 		template <typename T>
 		T& AddComponent(Entity entity, const T& component)
 		{
@@ -131,6 +162,17 @@ namespace XYZ {
 			return m_EntityManager.m_Valid.size() > (uint32_t)entity && m_EntityManager.m_Valid[(uint32_t)entity];
 		}
 
+		bool IsValid(const EntityHandle& handle) const
+		{
+			return IsValid(handle.ID) && m_EntityManager.GetGeneration(handle.ID) == handle.Generation;
+		}
+
+		EntityHandle GetHandle(Entity entity) const
+		{
+			XYZ_ASSERT(IsValid(entity), "Entity is invalid");
+			return { entity, m_EntityManager.GetGeneration(entity) };
+		}
+
 		template <typename ...Args>
 		void CreateStorage()
 		{
@@ -192,6 +234,14 @@ namespace XYZ {
 
 		uint16_t GetNumberOfCreatedStorages() const { return m_ComponentManager.GetNumberOfCreatedStorages(); }
 		static uint16_t GetNumberOfRegisteredComponents() { return ComponentManager::s_NextComponentTypeID; }
+	private:
+		template <typename T>
+		void reserveStorage(uint32_t count)
+		{
+			CreateStorage<T>();
+			GetStorage<T>().Reserve(m_EntityManager.m_Valid.size(), count);
+		}
+
 	private:
 		ComponentManager m_ComponentManager;
 		CallbackManager m_CallbackManager;
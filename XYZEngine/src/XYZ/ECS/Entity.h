@@ -19,4 +19,14 @@ namespace XYZ {
 		uint32_t m_ID;
 
 	};
+
+	// Entity with generation of its slot, it is no longer valid when the slot is reused
+	struct EntityHandle
+	{
+		Entity   ID;
+		uint32_t Generation = 0;
+
+		bool operator==(const EntityHandle& rhs) const { return ID == rhs.ID && Generation == rhs.Generation; }
+		bool operator!=(const EntityHandle& rhs) const { return !(*this == rhs); }
+	};
 }
\ No newline at end of file
@@ -13,6 +13,7 @@ namespace XYZ {
 		:
 		m_Bitset(other.m_Bitset),
 		m_Valid(other.m_Valid),
+		m_Generations(other.m_Generations),
 		m_EntitiesInUse(other.m_EntitiesInUse)
 	{
 	}
@@ -20,6 +21,7 @@ namespace XYZ {
 		:
 		m_Bitset(std::move(other.m_Bitset)),
 		m_Valid(std::move(other.m_Valid)),
+		m_Generations(std::move(other.m_Generations)),
 		m_EntitiesInUse(other.m_EntitiesInUse)
 	{
 	}
@@ -27,6 +29,7 @@ namespace XYZ {
 	{
 		m_Bitset = std::move(other.m_Bitset);
 		m_Valid = std::move(other.m_Valid);
+		m_Generations = std::move(other.m_Generations);
 		m_EntitiesInUse = other.m_EntitiesInUse;
 		return *this;
 	}
@@ -37,10 +40,33 @@ namespace XYZ {
 		uint32_t entity = (uint32_t)m_Bitset.CreateSignature();
 
 		if (m_Valid.size() <= entity)
+		{
 			m_Valid.resize((size_t)entity + 1);
+			m_Generations.resize((size_t)entity + 1);
+		}
 		m_Valid[entity] = true;
 		return entity;		
 	}
+	void EntityManager::CreateEntities(uint32_t count, std::vector<Entity>& result)
+	{
+		m_EntitiesInUse += count;
+		XYZ_ASSERT(m_EntitiesInUse < sc_MaxEntity, "Too many entities in existence.");
+		std::vector<int32_t> signatures;
+		m_Bitset.CreateSignatures(count, signatures);
+
+		const size_t range = m_Bitset.GetNumberOfSignatures();
+		if (m_Valid.size() < range)
+		{
+			m_Valid.resize(range);
+			m_Generations.resize(range);
+		}
+		result.reserve(result.size() + count);
+		for (int32_t signature : signatures)
+		{
+			m_Valid[signature] = true;
+			result.push_back((uint32_t)signature);
+		}
+	}
 	Signature& EntityManager::GetSignature(Entity entity)
 	{
 		XYZ_ASSERT(entity, "Invalid entity");
@@ -58,9 +84,22 @@ namespace XYZ {
 		// Put the destroyed ID at the back of the queue
 		//Restart bitset to zero;
 		m_Valid[entity] = false;
+		m_Generations[entity]++;
 		m_Bitset.DestroySignature(entity);
 		m_EntitiesInUse--;
 	}
+	void EntityManager::DestroyEntities(const Entity* entities, size_t count)
+	{
+		for (size_t i = 0; i < count; ++i)
+		{
+			const uint32_t entity = entities[i];
+			XYZ_ASSERT(entity, "Invalid entity.");
+			m_Valid[entity] = false;
+			m_Generations[entity]++;
+			m_Bitset.DestroySignature(entity);
+		}
+		m_EntitiesInUse -= (uint32_t)count;
+	}
 	void EntityManager::SetNumberOfComponents(uint16_t number)
 	{
 		m_Bitset.SetNumberBits(number);
@@ -72,6 +111,13 @@ namespace XYZ {
 	}
 	void EntityManager::Clear()
 	{
+		// Keep generations, handles of cleared entities must stay invalid
+		for (size_t i = 0; i < m_Valid.size(); ++i)
+		{
+			if (m_Valid[i])
+				m_Generations[i]++;
+		}
+		m_Valid.assign(m_Valid.size(), false);
 		m_Bitset.Clear();
 		m_EntitiesInUse = 0;
 	}
@@ -17,21 +17,27 @@ namespace XYZ {
 		EntityManager& operator=(EntityManager&& other) noexcept;
 
 		Entity CreateEntity();
+		// Appends created entities to the result, signatures are allocated in one pass
+		void CreateEntities(uint32_t count, std::vector<Entity>& result);
 
 		Signature& GetSignature(Entity entity);
 		const Signature& GetSignature(Entity entity)const;
 
 		void DestroyEntity(Entity entity);
+		void DestroyEntities(const Entity* entities, size_t count);
 		void SetNumberOfComponents(uint16_t number);
 		void SetSignature(Entity entity, Signature signature);
 		void Clear();
 
 		uint32_t GetNumEntities() const { return m_EntitiesInUse; }
+		uint32_t GetGeneration(Entity entity) const { return m_Generations[(uint32_t)entity]; }
 	private:
 		uint32_t m_EntitiesInUse;
 
 		DynamicBitset m_Bitset;
 		std::vector<bool> m_Valid;
+		// Incremented every time entity is destroyed
+		std::vector<uint32_t> m_Generations;
 
 		static constexpr uint32_t sc_MaxEntity = UINT32_MAX - 1;
 		friend class ECSManager;
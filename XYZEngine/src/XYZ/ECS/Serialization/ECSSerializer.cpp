@@ -96,10 +96,8 @@ namespace XYZ {
         if (header.EntitiesIncluded)
         {
             ecs.Clear();
-            for (uint32_t i = 0; i < header.NumEntities; ++i)
-            {
-                ecs.CreateEntity();
-            }
+            std::vector<Entity> entities;
+            ecs.CreateEntities(header.NumEntities, entities);
             if (header.Tight)
             {
                 uint32_t numBitsets = (uint32_t)std::ceil((double)header.NumEntities / (double)ECSHeader::TightPackLength);
@@ -0,0 +1,48 @@
+#include "stdafx.h"
+#include "AnimatorInspector.h"
+
+#include "XYZ/Editor/EditorHelper.h"
+#include "XYZ/Scene/Components.h"
+#include "XYZ/Animation/Animation.h"
+
+#include <filesystem>
+
+namespace XYZ {
+	bool AnimatorInspector::OnEditorRender()
+	{
+		return EditorHelper::DrawComponent<AnimatorComponent>("Animator", m_Context, [&](auto& component) {
+
+			Ref<Animation>& animation = component.Animation;
+			if (!animation.Raw())
+			{
+				ImGui::Text("No animation");
+				return;
+			}
+			const Ref<AnimationClip>& clip = animation->GetClip();
+			EditorHelper::BeginColumns("Channels");
+			ImGui::Text("%u", (uint32_t)clip->GetChannels().size());
+			EditorHelper::EndColumns();
+
+			EditorHelper::BeginColumns("Clip Memory");
+			ImGui::Text("%u B", (uint32_t)clip->GetMemorySize());
+			EditorHelper::EndColumns();
+
+			if (animation->IsBaked())
+			{
+				ImGui::Text("Baked");
+				return;
+			}
+			if (ImGui::Button("Bake Clip"))
+			{
+				// Saved next to other assets, so it is included in the asset pack. Named by entity GUID, tags are not unique
+				const std::string directory = "Assets/Animations";
+				std::filesystem::create_directories(directory);
+				const std::string filepath = directory + "/" + (std::string)m_Context.GetComponent<IDComponent>().ID + ".clip";
+				if (animation->BakeClip(filepath))
+					XYZ_LOG_INFO("Animation clip baked to ", filepath, ", save the scene to keep it");
+				else
+					XYZ_LOG_ERR("Could not bake animation clip ", filepath);
+			}
+		});
+	}
+}
\ No newline at end of file
@@ -0,0 +1,14 @@
+#pragma once
+#include "XYZ/Editor/Inspector/InspectorEditable.h"
+#include "XYZ/Scene/SceneEntity.h"
+
+namespace XYZ {
+	class AnimatorInspector : public InspectorEditable
+	{
+	public:
+		virtual bool OnEditorRender() override;
+
+
+		SceneEntity m_Context;
+	};
+}
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 
 
+#include "AnimatorInspector.h"
 #include "CameraInspector.h"
 #include "Lights2DInspector.h"
 #include "ParticleComponentGPUInspector.h"
@@ -13,7 +13,8 @@ namespace XYZ {
 
 			EditorHelper::DrawVec3ControlRGB("Color", component.Color);
 			EditorHelper::BeginColumns("Radius");
-			ImGui::DragFloat("##Radius", &component.Radius, 0.05f, 0.0f, 0.0f, "%.2f");
+			if (ImGui::DragFloat("##Radius", &component.Radius, 0.05f, 0.0f, 0.0f, "%.2f"))
+				m_Context.GetScene()->MarkBoundsDirty(m_Context);
 			EditorHelper::EndColumns();
 
 			EditorHelper::BeginColumns("Intensity");
@@ -27,7 +28,8 @@ namespace XYZ {
 
 			EditorHelper::DrawVec3ControlRGB("Color", component.Color);
 			EditorHelper::BeginColumns("Radius");
-			ImGui::DragFloat("##Radius", &component.Radius, 0.05f, 0.0f, 0.0f, "%.2f");
+			if (ImGui::DragFloat("##Radius", &component.Radius, 0.05f, 0.0f, 0.0f, "%.2f"))
+				m_Context.GetScene()->MarkBoundsDirty(m_Context);
 			EditorHelper::EndColumns();
 
 			EditorHelper::BeginColumns("Intensity");
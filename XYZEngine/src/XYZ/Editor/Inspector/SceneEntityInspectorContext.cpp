@@ -303,6 +303,11 @@ namespace XYZ {
 				m_InspectorEditables.push_back(&m_CameraInspector);
 				m_CameraInspector.m_Context = context;
 			}
+			if (m_Context.HasComponent<AnimatorComponent>())
+			{
+				m_InspectorEditables.push_back(&m_AnimatorInspector);
+				m_AnimatorInspector.m_Context = context;
+			}
 			if (m_Context.HasComponent<PointLight2D>())
 			{
 				m_InspectorEditables.push_back(&m_PointLight2DInspector);
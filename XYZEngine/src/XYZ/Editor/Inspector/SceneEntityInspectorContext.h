@@ -26,6 +26,7 @@ namespace XYZ {
 
 
 		private:
+			AnimatorInspector			  m_AnimatorInspector;
 			CameraInspector		          m_CameraInspector;
 			PointLight2DInspector         m_PointLight2DInspector;
 			SpotLight2DInspector          m_SpotLight2DInspector;
@@ -5,6 +5,8 @@
 #include "XYZ/Asset/AssetManager.h"
 #include "XYZ/Scene/Scene.h"
 #include "XYZ/Renderer/Font.h"
+#include "XYZ/Renderer/TextureAtlas.h"
+#include "XYZ/Renderer/TextureCooker.h"
 
 #include <imgui.h>
 #include <filesystem>
@@ -140,6 +142,21 @@ namespace XYZ {
 
 				processDirectory(m_Path);
 				ImGui::PopStyleColor();
+
+				if (ImGui::BeginPopupContextWindow(0, 1, false))
+				{
+					if (ImGui::MenuItem("Build Texture Atlas"))
+						TextureAtlasBuilder::PackSubTextures(m_Path, "Atlas");
+					if (ImGui::MenuItem("Cook Textures"))
+						XYZ_LOG_INFO("Cooked ", TextureCooker::CookDirectory(m_Path), " textures");
+					if (ImGui::MenuItem("Build Asset Pack"))
+					{
+						if (!AssetManager::BuildAssetPack(AssetManager::GetAssetPackPath()))
+							XYZ_LOG_ERR("Failed to build asset pack ", AssetManager::GetAssetPackPath());
+					}
+
+					ImGui::EndPopup();
+				}
 			}
 			ImGui::End();
 		}
@@ -54,16 +54,6 @@ namespace XYZ {
 			return { (mx / viewportWidth) * 2.0f - 1.0f, ((my / viewportHeight) * 2.0f - 1.0f) * -1.0f };
 		}
 
-		static AABB SceneEntityAABB(SceneEntity entity)
-		{
-			TransformComponent& transformComponent = entity.GetComponent<TransformComponent>();
-			auto [translation, rotation, scale] = transformComponent.GetWorldComponents();
-			return AABB(
-				translation - (scale / 2.0f),
-				translation + (scale / 2.0f)
-			);
-		}
-
 		void ScenePanel::handlePanelResize(const glm::vec2& newSize)
 		{
 			if (m_ViewportSize.x != newSize.x || m_ViewportSize.y != newSize.y)
@@ -91,8 +81,9 @@ namespace XYZ {
 				{
 					Entity first = m_Selection.front();
 					m_Selection.pop_front();
-					SceneEntity entity(first, m_Context.Raw());		
-					if (ray.IntersectsAABB(SceneEntityAABB(entity)))
+					// Same bounds as ray cast of the scene
+					AABB bounds;
+					if (m_Context->GetPickBounds(first, bounds) && ray.IntersectsAABB(bounds))
 					{
 						m_Context->SetSelectedEntity(first);
 						if (m_Callback)
@@ -101,26 +92,15 @@ namespace XYZ {
 					}
 				}
 
+				m_Context->RayCast(ray, m_Hits);
 				m_Selection.clear();
-				bool selected = false;
-				for (Entity entityID : m_Context->GetEntities())
+				if (!m_Hits.empty())
 				{
-					SceneEntity entity(entityID, m_Context.Raw());
-					if (ray.IntersectsAABB(SceneEntityAABB(entity)))
-					{
-						// Do not add first selected to the selection deque
-						if (selected)
-						{
-							m_Selection.push_back(entityID);
-						}
-						else
-						{
-							selected = true;
-							m_Context->SetSelectedEntity(entityID);
-							if (m_Callback)
-								m_Callback(m_Context->GetSelectedEntity());
-						}					
-					}
+					// Do not add first selected to the selection deque
+					m_Context->SetSelectedEntity(m_Hits.front());
+					if (m_Callback)
+						m_Callback(m_Context->GetSelectedEntity());
+					m_Selection.insert(m_Selection.end(), m_Hits.begin() + 1, m_Hits.end());
 				}
 			}
 		}
@@ -61,7 +61,8 @@ namespace XYZ {
 				Z	   = BIT(5)
 			};
 
-			std::deque<Entity> m_Selection;
+			std::deque<Entity>  m_Selection;
+			std::vector<Entity> m_Hits;
 			uint8_t			   m_ModifyFlags;
 			float			   m_MoveSpeed;
 			glm::vec2		   m_OldMousePosition;
@@ -152,13 +152,16 @@ namespace XYZ {
             m_PreviewVertices.clear();
             if (preview)
             {
+                skinVertices(hierarchy);
+                uint32_t skinnedIndex = 0;
                 for (auto& subMesh : m_Submeshes)
                 {
                     uint32_t counter = 0;
                     for (auto& vertex : subMesh.VerticesLocalToBones)
                     {
                         BoneVertex vertexLocalToBone = vertex;
-                        getPositionFromBones(vertexLocalToBone, hierarchy);
+                        const glm::vec3 skinned = m_SkinnedPositions.Get(skinnedIndex++);
+                        vertexLocalToBone.Position = glm::vec2(skinned.x, skinned.y);
                         if (weight)
                         {
                             getColorFromBoneWeights(vertexLocalToBone, hierarchy);
@@ -306,25 +309,50 @@ namespace XYZ {
                 vertex.Position.y = localToBone.y;
             }
         }
-        void SkinnedMesh::getPositionFromBones(BoneVertex& vertex, const Tree& hierarchy)
+        void SkinnedMesh::skinVertices(const Tree& hierarchy)
         {
-            bool hasBone = false;
-            glm::mat4 boneTransform = glm::mat4(0.0f);
-            for (uint32_t i = 0; i < 4; ++i)
+            // Last palette entry is identity for vertices without bones
+            const uint32_t identityIndex = (uint32_t)hierarchy.GetFlatNodes().Range();
+            m_BonePalette.resize((size_t)identityIndex + 1);
+            m_BonePalette[identityIndex] = glm::mat4(1.0f);
+
+            uint32_t vertexCount = 0;
+            for (auto& subMesh : m_Submeshes)
+                vertexCount += (uint32_t)subMesh.VerticesLocalToBones.size();
+            m_SkinningStreams.Resize(vertexCount);
+
+            uint32_t index = 0;
+            for (auto& subMesh : m_Submeshes)
             {
-                if (vertex.Data.IDs[i] != -1)
+                for (auto& vertex : subMesh.VerticesLocalToBones)
                 {
-                    const PreviewBone* bone = static_cast<const PreviewBone*>(hierarchy.GetData(vertex.Data.IDs[i]));
-                    boneTransform += bone->WorldTransform * vertex.Data.Weights[i];
-                    hasBone = true;
+                    uint32_t ids[BoneData::sc_MaxBonesPerVertex];
+                    float weights[BoneData::sc_MaxBonesPerVertex];
+                    bool hasBone = false;
+                    for (uint32_t i = 0; i < BoneData::sc_MaxBonesPerVertex; ++i)
+                    {
+                        const int32_t id = vertex.Data.IDs[i];
+                        if (id != -1)
+                        {
+                            const PreviewBone* bone = static_cast<const PreviewBone*>(hierarchy.GetData(id));
+                            m_BonePalette[id] = bone->WorldTransform;
+                            ids[i] = (uint32_t)id;
+                            weights[i] = vertex.Data.Weights[i];
+                            hasBone = true;
+                        }
+                        else
+                        {
+                            ids[i] = identityIndex;
+                            weights[i] = 0.0f;
+                        }
+                    }
+                    if (!hasBone)
+                        weights[0] = 1.0f;
+
+                    m_SkinningStreams.SetVertex(index++, glm::vec3(vertex.Position, 0.0f), ids, weights);
                 }
             }
-            if (hasBone)
-            {
-                glm::vec4 positionFromBone = boneTransform * glm::vec4(vertex.Position, 0.0f, 1.0f);
-                vertex.Position.x = positionFromBone.x;
-                vertex.Position.y = positionFromBone.y;
-            }
+            Skinning::Skin(m_BonePalette.data(), m_SkinningStreams, m_SkinnedPositions);
         }
         void SkinnedMesh::getColorFromBoneWeights(BoneVertex& vertex, const Tree& hierarchy)
         {
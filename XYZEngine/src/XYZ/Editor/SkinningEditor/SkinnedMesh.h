@@ -3,6 +3,7 @@
 #include "XYZ/Renderer/Shader.h"
 #include "XYZ/Renderer/VertexArray.h"
 #include "XYZ/Renderer/Buffer.h"
+#include "XYZ/Animation/Skinning.h"
 
 #include <glm/glm.hpp>
 
@@ -109,18 +110,22 @@ namespace XYZ {
 			static bool trianglesHaveIndex(const Submesh& subMesh, uint32_t index);
 			static void triangulateSubmesh(Submesh& subMesh);
 			static void eraseEmptyPoints(Submesh& subMesh);
-			static void getPositionFromBones(BoneVertex& vertex, const Tree& hierarchy);
 			static void getColorFromBoneWeights(BoneVertex& vertex, const Tree& hierarchy);		
 			
 
 			void updateBuffers();
 			void rebuildBuffers();
+			void skinVertices(const Tree& hierarchy);
 
 		private:
 			Ref<VertexArray> m_VertexArray;
 			Ref<VertexBuffer> m_VertexBuffer;
 
 			glm::vec2 m_ContextSize;
+
+			std::vector<glm::mat4> m_BonePalette;
+			SkinningStreams		   m_SkinningStreams;
+			SkinnedPositions	   m_SkinnedPositions;
 		};
 	}
 }
\ No newline at end of file
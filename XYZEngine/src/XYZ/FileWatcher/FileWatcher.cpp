@@ -3,34 +3,162 @@
 
 
 namespace XYZ {
+
+	void IFileWatcherListener::OnFileEvents(const std::vector<FileWatcherEvent>& events)
+	{
+		for (const FileWatcherEvent& event : events)
+		{
+			if (event.Flags & FileAdded)
+				OnFileAdded(event.Path);
+			if (event.Flags & FileChanged)
+				OnFileChange(event.Path);
+			if (event.Flags & FileRenamed)
+				OnFileRenamed(event.Path);
+			if (event.Flags & FileRemoved)
+				OnFileRemoved(event.Path);
+		}
+	}
+
+	// Merges new event into flags of path, so that burst of events ends as its final effect
+	static uint8_t CoalesceEvent(uint8_t flags, FileWatcherEventType type)
+	{
+		switch (type)
+		{
+		case FileChanged:
+			// Change of new file is part of adding it
+			return (flags & FileAdded) ? flags : (uint8_t)(flags | FileChanged);
+		case FileAdded:
+			// Removed and added again, for example saved through temporary file
+			if (flags & FileRemoved)
+				return (uint8_t)((flags & ~FileRemoved) | FileChanged);
+			return (uint8_t)(flags | FileAdded);
+		case FileRemoved:
+			// Temporary file that existed only during interval
+			if (flags & FileAdded)
+				return 0;
+			return (uint8_t)(FileRemoved | (flags & FileRenamed));
+		case FileRenamed:
+			return (uint8_t)(flags | FileRenamed);
+		}
+		return flags;
+	}
+
 	FileWatcher::FileWatcher(const std::wstring& dir)
 		:
 		m_Directory(dir)
 	{
 	}
+	FileWatcher::~FileWatcher()
+	{
+		stopDispatch();
+	}
 	void FileWatcher::AddListener(IFileWatcherListener* listener)
 	{
+		std::scoped_lock<std::mutex> lock(m_Mutex);
 		m_Listeners.push_back(listener);
 	}
+	void FileWatcher::SetDebounceInterval(std::chrono::milliseconds interval)
+	{
+		std::scoped_lock<std::mutex> lock(m_Mutex);
+		m_DebounceInterval = interval;
+	}
 	void FileWatcher::OnFileChange(const std::wstring& fileName)
 	{
-		for (auto listener : m_Listeners)
-			listener->OnFileChange(fileName);
+		pushEvent(fileName, FileChanged);
 	}
 	void FileWatcher::OnFileAdded(const std::wstring& fileName)
 	{
-		for (auto listener : m_Listeners)
-			listener->OnFileAdded(fileName);
+		pushEvent(fileName, FileAdded);
 	}
 	void FileWatcher::OnFileRemoved(const std::wstring& fileName)
 	{
-		for (auto listener : m_Listeners)
-			listener->OnFileRemoved(fileName);
+		pushEvent(fileName, FileRemoved);
 	}
 	void FileWatcher::OnFileRenamed(const std::wstring& fileName)
 	{
-		for (auto listener : m_Listeners)
-			listener->OnFileRenamed(fileName);
+		pushEvent(fileName, FileRenamed);
+	}
+	void FileWatcher::startDispatch()
+	{
+		std::scoped_lock<std::mutex> lock(m_Mutex);
+		if (m_Dispatching)
+			return;
+
+		m_Dispatching = true;
+		m_DispatchThread = std::thread(&FileWatcher::dispatchThread, this);
+	}
+	void FileWatcher::stopDispatch()
+	{
+		{
+			std::scoped_lock<std::mutex> lock(m_Mutex);
+			m_Dispatching = false;
+		}
+		m_Condition.notify_one();
+		if (m_DispatchThread.joinable() && m_DispatchThread.get_id() != std::this_thread::get_id())
+			m_DispatchThread.join();
+		else if (m_DispatchThread.joinable())
+			m_DispatchThread.detach();
+	}
+	void FileWatcher::pushEvent(const std::wstring& fileName, FileWatcherEventType type)
+	{
+		bool wake = false;
+		{
+			std::scoped_lock<std::mutex> lock(m_Mutex);
+			// Dispatch thread already waits for pending deadline, which only moves later
+			wake = m_PendingEvents.empty();
+			PendingEvent& pending = m_PendingEvents[fileName];
+			pending.Flags = CoalesceEvent(pending.Flags, type);
+			pending.LastTime = Clock::now();
+		}
+		if (wake)
+			m_Condition.notify_one();
+	}
+	void FileWatcher::dispatchThread()
+	{
+		std::vector<FileWatcherEvent> events;
+		std::vector<IFileWatcherListener*> listeners;
+
+		std::unique_lock<std::mutex> lock(m_Mutex);
+		while (m_Dispatching)
+		{
+			if (m_PendingEvents.empty())
+			{
+				m_Condition.wait(lock, [this]() { return !m_Dispatching || !m_PendingEvents.empty(); });
+				continue;
+			}
+
+			// Deliver paths that did not change for whole interval, wait for the oldest of the others
+			const Clock::time_point now = Clock::now();
+			Clock::time_point nextDeadline = Clock::time_point::max();
+			for (auto it = m_PendingEvents.begin(); it != m_PendingEvents.end();)
+			{
+				const Clock::time_point deadline = it->second.LastTime + m_DebounceInterval;
+				if (deadline <= now)
+				{
+					if (it->second.Flags)
+						events.push_back({ it->first, it->second.Flags });
+					it = m_PendingEvents.erase(it);
+				}
+				else
+				{
+					nextDeadline = std::min(nextDeadline, deadline);
+					++it;
+				}
+			}
+
+			if (!events.empty())
+			{
+				listeners = m_Listeners;
+				lock.unlock();
+				for (IFileWatcherListener* listener : listeners)
+					listener->OnFileEvents(events);
+				events.clear();
+				lock.lock();
+			}
+			else
+			{
+				m_Condition.wait_until(lock, nextDeadline);
+			}
+		}
 	}
-	
-}
\ No newline at end of file
+}
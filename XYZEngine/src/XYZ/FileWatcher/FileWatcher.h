@@ -2,20 +2,31 @@
 
 #include "FileWatcherListener.h"
 
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
 
 namespace XYZ {
 
+	// Platform backends report raw events, they are coalesced per path and delivered
+	// to listeners from dispatch thread when path did not change for debounce interval
 	class FileWatcher : public std::enable_shared_from_this<FileWatcher>
 	{
 	public:
 		FileWatcher(const std::wstring& dir);
+		virtual ~FileWatcher();
+
 		void AddListener(IFileWatcherListener* listener);
+		void SetDebounceInterval(std::chrono::milliseconds interval);
 
 		virtual void Start() = 0;
 		virtual void Stop() = 0;
 		virtual bool IsRunning() const = 0;
 
 		inline const std::wstring& GetDirectory() const { return m_Directory; }
+		inline std::chrono::milliseconds GetDebounceInterval() const { return m_DebounceInterval; }
 
 		void OnFileChange(const std::wstring& fileName);
 		void OnFileAdded(const std::wstring& fileName);
@@ -24,8 +35,34 @@ namespace XYZ {
 
 
 		static std::shared_ptr<FileWatcher> Create(const std::wstring& dir);
+	protected:
+		void startDispatch();
+		void stopDispatch();
+
+	private:
+		void pushEvent(const std::wstring& fileName, FileWatcherEventType type);
+		void dispatchThread();
+
+	private:
+		using Clock = std::chrono::steady_clock;
+
+		struct PendingEvent
+		{
+			uint8_t			  Flags = 0;
+			Clock::time_point LastTime;
+		};
+
 	protected:
 		std::wstring m_Directory;
 		std::vector<IFileWatcherListener*> m_Listeners;
+
+	private:
+		std::chrono::milliseconds m_DebounceInterval{ 100 };
+
+		std::unordered_map<std::wstring, PendingEvent> m_PendingEvents;
+		std::mutex				m_Mutex;
+		std::condition_variable m_Condition;
+		std::thread				m_DispatchThread;
+		bool					m_Dispatching = false;
 	};
-}
\ No newline at end of file
+}
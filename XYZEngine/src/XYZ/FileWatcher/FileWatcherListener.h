@@ -1,8 +1,26 @@
 #pragma once
 
+#include<cstdint>
 #include<string>
+#include<vector>
 
 namespace XYZ {
+
+	enum FileWatcherEventType : uint8_t
+	{
+		FileChanged = 1 << 0,
+		FileAdded	= 1 << 1,
+		FileRemoved = 1 << 2,
+		FileRenamed = 1 << 3
+	};
+
+	// All changes of one path during debounce interval
+	struct FileWatcherEvent
+	{
+		std::wstring Path;
+		uint8_t		 Flags = 0;
+	};
+
 	class IFileWatcherListener
 	{
 	protected:
@@ -11,6 +29,10 @@ namespace XYZ {
 		virtual void OnFileRemoved(const std::wstring& path) = 0;
 		virtual void OnFileRenamed(const std::wstring& path) = 0;
 
+		// Called from dispatch thread of FileWatcher once per interval,
+		// default implementation calls functions above once for every flag of event
+		virtual void OnFileEvents(const std::vector<FileWatcherEvent>& events);
+
 		friend class FileWatcher;
 	};
-}
\ No newline at end of file
+}
@@ -3,13 +3,20 @@
 #include "XYZ/Scene/SceneEntity.h"
 
 namespace XYZ {
+	ContactListener::ContactListener(uint32_t capacity)
+	{
+		m_Events.reserve(capacity);
+		m_DispatchEvents.reserve(capacity);
+		m_Groups.reserve(capacity);
+		m_SortKeys.reserve(capacity);
+	}
 	void ContactListener::BeginContact(b2Contact* contact)
 	{
-		SceneEntity* A = reinterpret_cast<SceneEntity*>(contact->GetFixtureA()->GetBody()->GetUserData().pointer);
-		SceneEntity* B = reinterpret_cast<SceneEntity*>(contact->GetFixtureB()->GetBody()->GetUserData().pointer);
+		record(contact, ContactEventType::Begin);
 	}
 	void ContactListener::EndContact(b2Contact* contact)
 	{
+		record(contact, ContactEventType::End);
 	}
 	void ContactListener::PreSolve(b2Contact* contact, const b2Manifold* oldManifold)
 	{
@@ -21,4 +28,49 @@ namespace XYZ {
 		B2_NOT_USED(contact);
 		B2_NOT_USED(impulse);
 	}
-}
\ No newline at end of file
+	void ContactListener::Flush()
+	{
+		std::swap(m_Events, m_DispatchEvents);
+		m_Events.clear();
+		m_Groups.clear();
+		if (m_DispatchEvents.empty())
+			return;
+
+		m_SortKeys.resize(m_DispatchEvents.size());
+		for (size_t i = 0; i < m_DispatchEvents.size(); ++i)
+			m_SortKeys[i] = ((uint64_t)(uint32_t)m_DispatchEvents[i].Owner << 32) | (uint64_t)i;
+		std::sort(m_SortKeys.begin(), m_SortKeys.end());
+
+		// Sorted events are written to the recording buffer and swapped back
+		m_Events.resize(m_DispatchEvents.size());
+		for (size_t i = 0; i < m_SortKeys.size(); ++i)
+		{
+			const ContactEvent& event = m_DispatchEvents[(uint32_t)m_SortKeys[i]];
+			m_Events[i] = event;
+			if (m_Groups.empty() || m_Groups.back().Owner != event.Owner)
+				m_Groups.push_back({ event.Owner, (uint32_t)i, 0 });
+			m_Groups.back().Count++;
+		}
+		std::swap(m_Events, m_DispatchEvents);
+		m_Events.clear();
+	}
+	void ContactListener::Clear()
+	{
+		m_Events.clear();
+		m_DispatchEvents.clear();
+		m_Groups.clear();
+	}
+	void ContactListener::record(b2Contact* contact, ContactEventType type)
+	{
+		// User data of bodies points to entities in physics entity buffer of the scene
+		const SceneEntity* a = reinterpret_cast<const SceneEntity*>(contact->GetFixtureA()->GetBody()->GetUserData().pointer);
+		const SceneEntity* b = reinterpret_cast<const SceneEntity*>(contact->GetFixtureB()->GetBody()->GetUserData().pointer);
+		if (!a || !b)
+			return;
+
+		const Entity entityA = *a;
+		const Entity entityB = *b;
+		m_Events.push_back({ entityA, entityB, type });
+		m_Events.push_back({ entityB, entityA, type });
+	}
+}
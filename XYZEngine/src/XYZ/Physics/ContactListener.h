@@ -1,13 +1,63 @@
 #pragma once
+#include "XYZ/ECS/Entity.h"
+
 #include <box2d/box2d.h>
 
 namespace XYZ {
+
+	enum class ContactEventType : uint8_t
+	{
+		Begin,
+		End
+	};
+
+	// Layout must match XYZ.ContactEvent
+	struct ContactEvent
+	{
+		Entity			 Owner;
+		Entity			 Other;
+		ContactEventType Type;
+	};
+
+	// Events of one entity are stored contiguously
+	struct ContactGroup
+	{
+		Entity	 Owner;
+		uint32_t Offset;
+		uint32_t Count;
+	};
+
+	// Only records contacts during world step, so callbacks do not stall the solver.
+	// Every contact is recorded once for each of both entities
 	class ContactListener : public b2ContactListener
 	{
 	public:
+		ContactListener(uint32_t capacity = sc_DefaultCapacity);
+
 		virtual void BeginContact(b2Contact* contact) override;
 		virtual void EndContact(b2Contact* contact) override;
 		virtual void PreSolve(b2Contact* contact, const b2Manifold* oldManifold) override;
 		virtual void PostSolve(b2Contact* contact, const b2ContactImpulse* impulse) override;
+
+		// Groups events recorded since last flush by entity, events of entity keep order of recording.
+		// Must not be called while world is stepping
+		void Flush();
+		// Drops recorded and dispatched events
+		void Clear();
+
+		// Valid until next flush
+		const std::vector<ContactEvent>& GetEvents() const { return m_DispatchEvents; }
+		const std::vector<ContactGroup>& GetGroups() const { return m_Groups; }
+
+		static constexpr uint32_t sc_DefaultCapacity = 1024;
+	private:
+		void record(b2Contact* contact, ContactEventType type);
+
+	private:
+		std::vector<ContactEvent> m_Events;
+		std::vector<ContactEvent> m_DispatchEvents;
+		std::vector<ContactGroup> m_Groups;
+		// Owner in high bits and index of event in low bits
+		std::vector<uint64_t>	  m_SortKeys;
 	};
-}
\ No newline at end of file
+}
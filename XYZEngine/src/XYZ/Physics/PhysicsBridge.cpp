@@ -0,0 +1,305 @@
+#include "stdafx.h"
+#include "PhysicsBridge.h"
+
+#include "XYZ/Scene/Components.h"
+#include "XYZ/Scene/SceneEntity.h"
+
+namespace XYZ {
+
+	void PhysicsBridge::Attach(ECSManager& ecs)
+	{
+		ecs.AddListener<RigidBody2DComponent>([this](uint32_t entity, CallbackType type) {
+			if (type == CallbackType::ComponentRemove || type == CallbackType::EntityDestroy)
+				removeBody(entity);
+		}, this);
+	}
+
+	void PhysicsBridge::Detach(ECSManager& ecs)
+	{
+		WaitStep();
+		ecs.RemoveListener<RigidBody2DComponent>(this);
+	}
+
+	void PhysicsBridge::CreateBodies(b2World& world, ECSManager& ecs, SceneEntity* userData)
+	{
+		XYZ_ASSERT(!m_World, "Bodies were already created");
+		m_World = &world;
+		m_Accumulator = 0.0f;
+
+		ecs.CreateStorage<RigidBody2DComponent>();
+		auto& storage = ecs.GetStorage<RigidBody2DComponent>();
+		auto& transformStorage = ecs.GetStorage<TransformComponent>();
+
+		const uint32_t count = (uint32_t)storage.Size();
+		m_Bodies.resize(count);
+		m_Entities.resize(count);
+		m_HasFixture.assign(count, false);
+		m_PreviousStates.resize(count);
+		m_CurrentStates.resize(count);
+		m_Awake.resize(count);
+		m_BodyIndices.assign((size_t)ecs.GetHighestID() + 1, -1);
+
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			RigidBody2DComponent& rigidBody = storage.GetComponentAtIndex(i);
+			const Entity entity = storage.GetEntityAtIndex(i);
+			const TransformComponent& transform = transformStorage.GetComponent(entity);
+
+			b2BodyDef bodyDef;
+			if (rigidBody.Type == RigidBody2DComponent::BodyType::Dynamic)
+				bodyDef.type = b2_dynamicBody;
+			else if (rigidBody.Type == RigidBody2DComponent::BodyType::Static)
+				bodyDef.type = b2_staticBody;
+			else if (rigidBody.Type == RigidBody2DComponent::BodyType::Kinematic)
+				bodyDef.type = b2_kinematicBody;
+
+			bodyDef.position.Set(transform.Translation.x, transform.Translation.y);
+			bodyDef.angle = transform.Rotation.z;
+			bodyDef.userData.pointer = reinterpret_cast<uintptr_t>(&userData[i]);
+
+			b2Body* body = world.CreateBody(&bodyDef);
+			rigidBody.RuntimeBody = body;
+
+			m_Bodies[i] = body;
+			m_Entities[i] = entity;
+			m_BodyIndices[(uint32_t)entity] = (int32_t)i;
+		}
+		readStates(m_CurrentStates, 0, count);
+		m_PreviousStates = m_CurrentStates;
+
+		// Body has only one fixture, collider types are resolved in order of priority
+		createFixtures<BoxCollider2DComponent>(ecs, [](b2Body* body, BoxCollider2DComponent& boxCollider) {
+			b2PolygonShape poly;
+			poly.SetAsBox(boxCollider.Size.x / 2.0f, boxCollider.Size.y / 2.0f,
+				b2Vec2{ boxCollider.Offset.x, boxCollider.Offset.y }, 0.0f);
+			b2FixtureDef fixture;
+			fixture.shape = &poly;
+			fixture.density = boxCollider.Density;
+			fixture.friction = boxCollider.Friction;
+			boxCollider.RuntimeFixture = body->CreateFixture(&fixture);
+		});
+		createFixtures<CircleCollider2DComponent>(ecs, [](b2Body* body, CircleCollider2DComponent& circleCollider) {
+			b2CircleShape circle;
+			circle.m_radius = circleCollider.Radius;
+			circle.m_p = b2Vec2(circleCollider.Offset.x, circleCollider.Offset.y);
+			b2FixtureDef fixture;
+			fixture.shape = &circle;
+			fixture.density = circleCollider.Density;
+			fixture.friction = circleCollider.Friction;
+			circleCollider.RuntimeFixture = body->CreateFixture(&fixture);
+		});
+		createFixtures<PolygonCollider2DComponent>(ecs, [](b2Body* body, PolygonCollider2DComponent& meshCollider) {
+			b2PolygonShape poly;
+			poly.Set((const b2Vec2*)meshCollider.Vertices.data(), (int32_t)meshCollider.Vertices.size());
+			b2FixtureDef fixture;
+			fixture.shape = &poly;
+			fixture.density = meshCollider.Density;
+			fixture.friction = meshCollider.Friction;
+			meshCollider.RuntimeFixture = body->CreateFixture(&fixture);
+		});
+		createFixtures<ChainCollider2DComponent>(ecs, [](b2Body* body, ChainCollider2DComponent& chainCollider) {
+			b2ChainShape chain;
+			chain.CreateChain((const b2Vec2*)chainCollider.Points.data(), (int32_t)chainCollider.Points.size(),
+				{ chainCollider.Points[0].x, chainCollider.Points[0].y },
+				{ chainCollider.Points.back().x, chainCollider.Points.back().y });
+			b2FixtureDef fixture;
+			fixture.shape = &chain;
+			fixture.density = chainCollider.Density;
+			fixture.friction = chainCollider.Friction;
+			chainCollider.RuntimeFixture = body->CreateFixture(&fixture);
+		});
+	}
+
+	void PhysicsBridge::DestroyBodies()
+	{
+		WaitStep();
+		if (m_World)
+		{
+			for (b2Body* body : m_Bodies)
+			{
+				// Destroying body reports end of its contacts, entities are not valid targets anymore
+				body->GetUserData().pointer = 0;
+				m_World->DestroyBody(body);
+			}
+		}
+		m_World = nullptr;
+		m_Bodies.clear();
+		m_Entities.clear();
+		m_HasFixture.clear();
+		m_PreviousStates.clear();
+		m_CurrentStates.clear();
+		m_Awake.clear();
+		m_BodyIndices.clear();
+	}
+
+	uint32_t PhysicsBridge::Step(b2World& world, float timestep, ThreadPool* pool)
+	{
+		const float fixedTimestep = m_Settings.FixedTimestep;
+		XYZ_ASSERT(fixedTimestep > 0.0f, "Fixed timestep must be positive");
+
+		m_Accumulator += timestep;
+		uint32_t steps = (uint32_t)(m_Accumulator / fixedTimestep);
+		if (steps > m_Settings.MaxSubsteps)
+		{
+			m_Accumulator = std::fmod(m_Accumulator, fixedTimestep);
+			steps = m_Settings.MaxSubsteps;
+		}
+		else
+		{
+			m_Accumulator -= (float)steps * fixedTimestep;
+		}
+		if (steps == 0)
+			return 0;
+
+		// Previous state is state before the last step, it is known already if there is only one step
+		if (steps == 1)
+			std::swap(m_PreviousStates, m_CurrentStates);
+
+		for (uint32_t i = 0; i < steps; ++i)
+		{
+			if (i != 0 && i + 1 == steps)
+			{
+				forEachRange(pool, [this](uint32_t begin, uint32_t end) {
+					readStates(m_PreviousStates, begin, end);
+				});
+			}
+			world.Step(fixedTimestep, m_Settings.VelocityIterations, m_Settings.PositionIterations);
+		}
+		forEachRange(pool, [this](uint32_t begin, uint32_t end) {
+			readStates(m_CurrentStates, begin, end);
+		});
+		return steps;
+	}
+
+	void PhysicsBridge::BeginStep(b2World& world, float timestep, ThreadPool& pool)
+	{
+		WaitStep();
+		// Reading of states is not split to jobs, worker would wait for jobs of its own pool
+		m_StepFuture = pool.PushJob<uint32_t>([this, &world, timestep]() {
+			return Step(world, timestep, nullptr);
+		});
+	}
+
+	uint32_t PhysicsBridge::WaitStep()
+	{
+		if (!m_StepFuture.valid())
+			return 0;
+		return m_StepFuture.get();
+	}
+
+	void PhysicsBridge::SyncTransforms(ECSManager& ecs, ThreadPool* pool)
+	{
+		auto& storage = ecs.GetStorage<TransformComponent>();
+		const float alpha = m_Settings.Interpolate ? GetInterpolationAlpha() : 1.0f;
+		forEachRange(pool, [this, &storage, alpha](uint32_t begin, uint32_t end) {
+			syncTransforms(storage, alpha, begin, end);
+		});
+	}
+
+	template <typename T, typename Func>
+	void PhysicsBridge::createFixtures(ECSManager& ecs, const Func& createFixture)
+	{
+		ecs.CreateStorage<T>();
+		auto& storage = ecs.GetStorage<T>();
+		for (size_t i = 0; i < storage.Size(); ++i)
+		{
+			const uint32_t entity = (uint32_t)storage.GetEntityAtIndex(i);
+			if (entity >= m_BodyIndices.size() || m_BodyIndices[entity] == -1)
+				continue;
+
+			const int32_t index = m_BodyIndices[entity];
+			if (m_HasFixture[index])
+				continue;
+
+			createFixture(m_Bodies[index], storage.GetComponentAtIndex(i));
+			m_HasFixture[index] = true;
+		}
+	}
+
+	template <typename Func>
+	void PhysicsBridge::forEachRange(ThreadPool* pool, const Func& func)
+	{
+		const uint32_t count = (uint32_t)m_Bodies.size();
+		if (pool && count > sc_BodiesPerJob)
+		{
+			std::vector<std::future<void>> futures;
+			for (uint32_t begin = sc_BodiesPerJob; begin < count; begin += sc_BodiesPerJob)
+			{
+				const uint32_t end = std::min(begin + sc_BodiesPerJob, count);
+				futures.push_back(pool->PushJob<void>([&func, begin, end]() {
+					func(begin, end);
+				}));
+			}
+			func(0, sc_BodiesPerJob);
+			for (auto& future : futures)
+				future.wait();
+		}
+		else
+		{
+			func(0, count);
+		}
+	}
+
+	void PhysicsBridge::removeBody(uint32_t entity)
+	{
+		if (!m_World || entity >= m_BodyIndices.size() || m_BodyIndices[entity] == -1)
+			return;
+
+		// World is locked while stepping
+		WaitStep();
+
+		const int32_t index = m_BodyIndices[entity];
+		// Entity is being destroyed, do not record its end contacts
+		m_Bodies[index]->GetUserData().pointer = 0;
+		m_World->DestroyBody(m_Bodies[index]);
+
+		// Move last body to the removed place
+		const int32_t last = (int32_t)m_Bodies.size() - 1;
+		m_Bodies[index] = m_Bodies[last];
+		m_Entities[index] = m_Entities[last];
+		m_HasFixture[index] = m_HasFixture[last];
+		m_PreviousStates[index] = m_PreviousStates[last];
+		m_CurrentStates[index] = m_CurrentStates[last];
+		m_Awake[index] = m_Awake[last];
+		m_BodyIndices[(uint32_t)m_Entities[index]] = index;
+		m_BodyIndices[entity] = -1;
+
+		m_Bodies.pop_back();
+		m_Entities.pop_back();
+		m_HasFixture.pop_back();
+		m_PreviousStates.pop_back();
+		m_CurrentStates.pop_back();
+		m_Awake.pop_back();
+	}
+
+	void PhysicsBridge::readStates(std::vector<BodyState>& states, uint32_t begin, uint32_t end)
+	{
+		for (uint32_t i = begin; i < end; ++i)
+		{
+			const b2Body* body = m_Bodies[i];
+			states[i].Position = body->GetPosition();
+			states[i].Angle = body->GetAngle();
+			m_Awake[i] = body->IsAwake();
+		}
+	}
+
+	void PhysicsBridge::syncTransforms(ComponentStorage<TransformComponent>& storage, float alpha, uint32_t begin, uint32_t end)
+	{
+		for (uint32_t i = begin; i < end; ++i)
+		{
+			const BodyState& previous = m_PreviousStates[i];
+			const BodyState& current = m_CurrentStates[i];
+			// Body that fell asleep is written until interpolation reaches its final state
+			const bool moved = previous.Position.x != current.Position.x
+							|| previous.Position.y != current.Position.y
+							|| previous.Angle != current.Angle;
+			if (!m_Awake[i] && !moved)
+				continue;
+
+			TransformComponent& transform = storage.GetComponent(m_Entities[i]);
+			transform.Translation.x = previous.Position.x + (current.Position.x - previous.Position.x) * alpha;
+			transform.Translation.y = previous.Position.y + (current.Position.y - previous.Position.y) * alpha;
+			transform.Rotation.z = previous.Angle + (current.Angle - previous.Angle) * alpha;
+		}
+	}
+}
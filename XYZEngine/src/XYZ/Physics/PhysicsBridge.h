@@ -0,0 +1,94 @@
+#pragma once
+#include "XYZ/ECS/ECSManager.h"
+#include "XYZ/Core/ThreadPool.h"
+
+#include <box2d/box2d.h>
+
+namespace XYZ {
+
+	class SceneEntity;
+	class TransformComponent;
+
+	struct PhysicsSettings
+	{
+		// World is always stepped by FixedTimestep, frame time is accumulated
+		float	 FixedTimestep = 1.0f / 60.0f;
+		// Accumulated time over MaxSubsteps steps is dropped, so long frames do not cause more long frames
+		uint32_t MaxSubsteps = 4;
+		int32_t  VelocityIterations = 6;
+		int32_t  PositionIterations = 2;
+		// Transforms are interpolated between two last steps by remaining accumulated time
+		bool	 Interpolate = true;
+		// World is stepped on worker thread while frame is rendered, results are applied next update
+		bool	 Asynchronous = false;
+	};
+
+	// Keeps bodies of rigid body components in dense arrays, so state of the world
+	// is copied to transforms without walking component views
+	class PhysicsBridge
+	{
+	public:
+		void Attach(ECSManager& ecs);
+		void Detach(ECSManager& ecs);
+
+		// Creates body for every rigid body in storage order, user data of body i points to userData[i].
+		// Fixtures are created by one pass over each collider storage
+		void CreateBodies(b2World& world, ECSManager& ecs, SceneEntity* userData);
+		void DestroyBodies();
+
+		// Advances world by fixed steps covering accumulated time, returns number of steps
+		uint32_t Step(b2World& world, float timestep, ThreadPool* pool = nullptr);
+		// Starts Step on worker thread, world must not be accessed until WaitStep
+		void BeginStep(b2World& world, float timestep, ThreadPool& pool);
+		// Sync point of asynchronous step, returns number of steps or zero if no step was started
+		uint32_t WaitStep();
+		// Copies position and angle of moving bodies to transforms, sleeping and static bodies are skipped
+		void SyncTransforms(ECSManager& ecs, ThreadPool* pool = nullptr);
+
+		void SetSettings(const PhysicsSettings& settings) { m_Settings = settings; }
+
+		PhysicsSettings& GetSettings() { return m_Settings; }
+		const PhysicsSettings& GetSettings() const { return m_Settings; }
+		// Fraction of fixed step accumulated after last step
+		float GetInterpolationAlpha() const { return m_Accumulator / m_Settings.FixedTimestep; }
+
+		uint32_t GetBodyCount() const { return (uint32_t)m_Bodies.size(); }
+		const std::vector<b2Body*>& GetBodies() const { return m_Bodies; }
+		const std::vector<Entity>& GetEntities() const { return m_Entities; }
+
+	private:
+		struct BodyState
+		{
+			b2Vec2 Position;
+			float  Angle;
+		};
+
+		template <typename T, typename Func>
+		void createFixtures(ECSManager& ecs, const Func& createFixture);
+		// Calls func with ranges of bodies, ranges are split between jobs if pool is provided
+		template <typename Func>
+		void forEachRange(ThreadPool* pool, const Func& func);
+
+		void removeBody(uint32_t entity);
+		void readStates(std::vector<BodyState>& states, uint32_t begin, uint32_t end);
+		void syncTransforms(ComponentStorage<TransformComponent>& storage, float alpha, uint32_t begin, uint32_t end);
+
+	private:
+		b2World*		m_World = nullptr;
+		PhysicsSettings m_Settings;
+		float			m_Accumulator = 0.0f;
+		std::future<uint32_t> m_StepFuture;
+
+		std::vector<b2Body*>   m_Bodies;
+		std::vector<Entity>	   m_Entities;
+		std::vector<bool>	   m_HasFixture;
+		// States after two last steps
+		std::vector<BodyState> m_PreviousStates;
+		std::vector<BodyState> m_CurrentStates;
+		std::vector<uint8_t>   m_Awake;
+		// Index of body of entity, indexed by entity id
+		std::vector<int32_t> m_BodyIndices;
+
+		static constexpr uint32_t sc_BodiesPerJob = 2048;
+	};
+}
@@ -0,0 +1,98 @@
+#include "stdafx.h"
+#include "LightGrid.h"
+
+namespace XYZ {
+
+	void LightGrid::Begin(const glm::mat4& viewProjection, const glm::vec2& viewportSize, uint32_t tileSize)
+	{
+		XYZ_ASSERT(tileSize != 0, "Tile size can not be zero");
+		m_ViewProjection = viewProjection;
+		m_ViewportSize = viewportSize;
+		m_TileSize = tileSize;
+		m_TileCount.x = ((uint32_t)viewportSize.x + tileSize - 1) / tileSize;
+		m_TileCount.y = ((uint32_t)viewportSize.y + tileSize - 1) / tileSize;
+
+		m_Lights.clear();
+		m_Tiles.assign((size_t)m_TileCount.x * m_TileCount.y, LightTile());
+		m_LightIndices.clear();
+	}
+
+	void LightGrid::AddLight(LightType type, uint32_t index, const glm::vec2& position, float radius)
+	{
+		if (m_Tiles.empty())
+			return;
+
+		// Screen rectangle of projected corners of the light bounds
+		glm::vec2 min(std::numeric_limits<float>::max());
+		glm::vec2 max(-std::numeric_limits<float>::max());
+		for (uint32_t corner = 0; corner < 4; ++corner)
+		{
+			const glm::vec2 offset((corner & 1) ? radius : -radius, (corner & 2) ? radius : -radius);
+			const glm::vec4 clip = m_ViewProjection * glm::vec4(position + offset, 0.0f, 1.0f);
+			if (clip.w <= 0.0f)
+			{
+				// Corner is behind the camera, light may cover whole screen
+				min = glm::vec2(-1.0f);
+				max = glm::vec2(1.0f);
+				break;
+			}
+			const glm::vec2 ndc = glm::vec2(clip) / clip.w;
+			min = glm::min(min, ndc);
+			max = glm::max(max, ndc);
+		}
+		if (max.x < -1.0f || max.y < -1.0f || min.x > 1.0f || min.y > 1.0f)
+			return;
+
+		// Same origin as gl_FragCoord, bottom left corner
+		const glm::vec2 tileScale = m_ViewportSize * 0.5f / (float)m_TileSize;
+		const glm::vec2 minTile = glm::clamp((min + 1.0f) * tileScale, glm::vec2(0.0f), glm::vec2(m_TileCount - 1u));
+		const glm::vec2 maxTile = glm::clamp((max + 1.0f) * tileScale, glm::vec2(0.0f), glm::vec2(m_TileCount - 1u));
+
+		BinnedLight light;
+		light.Type  = type;
+		light.Index = index;
+		light.MinX  = (uint32_t)minTile.x;
+		light.MinY  = (uint32_t)minTile.y;
+		light.MaxX  = (uint32_t)maxTile.x;
+		light.MaxY  = (uint32_t)maxTile.y;
+		m_Lights.push_back(light);
+
+		for (uint32_t y = light.MinY; y <= light.MaxY; ++y)
+		{
+			LightTile* row = &m_Tiles[(size_t)y * m_TileCount.x];
+			for (uint32_t x = light.MinX; x <= light.MaxX; ++x)
+			{
+				if (type == Point)
+					row[x].PointLightCount++;
+				else
+					row[x].SpotLightCount++;
+			}
+		}
+	}
+
+	void LightGrid::End()
+	{
+		uint32_t offset = 0;
+		for (LightTile& tile : m_Tiles)
+		{
+			tile.Offset = offset;
+			offset += tile.PointLightCount + tile.SpotLightCount;
+		}
+		m_LightIndices.resize(offset);
+
+		// Next free slot of point and spot lights in every tile, lights keep order of submission
+		m_Cursors.resize(m_Tiles.size());
+		for (size_t i = 0; i < m_Tiles.size(); ++i)
+			m_Cursors[i] = glm::uvec2(m_Tiles[i].Offset, m_Tiles[i].Offset + m_Tiles[i].PointLightCount);
+
+		for (const BinnedLight& light : m_Lights)
+		{
+			for (uint32_t y = light.MinY; y <= light.MaxY; ++y)
+			{
+				glm::uvec2* row = &m_Cursors[(size_t)y * m_TileCount.x];
+				for (uint32_t x = light.MinX; x <= light.MaxX; ++x)
+					m_LightIndices[row[x][light.Type]++] = light.Index;
+			}
+		}
+	}
+}
@@ -0,0 +1,63 @@
+#pragma once
+#include <glm/glm.hpp>
+
+namespace XYZ {
+
+	// Light lists of one screen tile, point light indices are followed by spot light indices
+	struct LightTile
+	{
+		uint32_t Offset = 0;
+		uint32_t PointLightCount = 0;
+		uint32_t SpotLightCount = 0;
+	private:
+		uint32_t Alignment = 0;
+	};
+
+	// Bins lights to screen space tiles so shading evaluates only lights overlapping the tile.
+	// Lights outside of the view are culled
+	class LightGrid
+	{
+	public:
+		enum LightType : uint32_t { Point, Spot, NumTypes };
+
+		void Begin(const glm::mat4& viewProjection, const glm::vec2& viewportSize, uint32_t tileSize);
+		// Light is binned by its circle of influence in world space
+		void AddLight(LightType type, uint32_t index, const glm::vec2& position, float radius);
+		// Requires members Position and Radius
+		template <typename T>
+		void AddLights(LightType type, const std::vector<T>& lights);
+		// Builds index lists of all tiles
+		void End();
+
+		const std::vector<LightTile>& GetTiles()	   const { return m_Tiles; }
+		const std::vector<uint32_t>&  GetLightIndices() const { return m_LightIndices; }
+		const glm::uvec2&			  GetTileCount()	   const { return m_TileCount; }
+		uint32_t					  GetTileSize()	   const { return m_TileSize; }
+		uint32_t					  GetVisibleLightCount() const { return (uint32_t)m_Lights.size(); }
+
+	private:
+		struct BinnedLight
+		{
+			LightType Type;
+			uint32_t  Index;
+			uint32_t  MinX, MinY, MaxX, MaxY; // Range of covered tiles, inclusive
+		};
+
+		glm::mat4 m_ViewProjection;
+		glm::vec2 m_ViewportSize;
+		glm::uvec2 m_TileCount = glm::uvec2(0);
+		uint32_t  m_TileSize = 0;
+
+		std::vector<BinnedLight> m_Lights;
+		std::vector<LightTile>	 m_Tiles;
+		std::vector<uint32_t>	 m_LightIndices;
+		std::vector<glm::uvec2>	 m_Cursors;
+	};
+
+	template <typename T>
+	inline void LightGrid::AddLights(LightType type, const std::vector<T>& lights)
+	{
+		for (uint32_t i = 0; i < (uint32_t)lights.size(); ++i)
+			AddLight(type, i, lights[i].Position, lights[i].Radius);
+	}
+}
@@ -16,6 +16,7 @@ namespace XYZ {
 
 		m_Shader->AddReloadCallback(std::bind(&Material::onShaderReload, this));
 		m_Flags = m_Shader->GetRendererID();
+		resolveUniformHandles();
 	}
 
 	Material::~Material()
@@ -33,10 +34,22 @@ namespace XYZ {
 				m_Textures[i]->Bind(i);
 		}
 
+		m_VSDirtyRange.Mark(m_VSExposedRange);
+		m_FSDirtyRange.Mark(m_FSExposedRange);
 		if (m_VSUniformBuffer)
-			m_Shader->SetVSUniforms(m_VSUniformBuffer);
+			m_Shader->SetVSUniforms(m_VSUniformBuffer, m_VSDirtyRange.Begin, m_VSDirtyRange.End);
 		if (m_FSUniformBuffer)
-			m_Shader->SetFSUniforms(m_FSUniformBuffer);
+			m_Shader->SetFSUniforms(m_FSUniformBuffer, m_FSDirtyRange.Begin, m_FSDirtyRange.End);
+		m_VSDirtyRange.Reset();
+		m_FSDirtyRange.Reset();
+	}
+
+	uint32_t Material::GetUniformHandle(const std::string& name) const
+	{
+		auto it = m_UniformHandles.find(name);
+		if (it != m_UniformHandles.end())
+			return it->second;
+		return sc_InvalidHandle;
 	}
 
 
@@ -59,11 +72,46 @@ namespace XYZ {
 		m_VSUniformBuffer.Allocate(m_Shader->GetVSUniformList().Size);
 		m_FSUniformBuffer.Allocate(m_Shader->GetFSUniformList().Size);
 		m_Flags = m_Shader->GetRendererID();
+		m_VSDirtyRange.MarkAll();
+		m_FSDirtyRange.MarkAll();
+		m_VSExposedRange.Reset();
+		m_FSExposedRange.Reset();
+		resolveUniformHandles();
 
 		for (auto& it : m_MaterialInstances)
 			it->onShaderReload();
 	}
 
+	void Material::resolveUniformHandles()
+	{
+		m_UniformHandles.clear();
+		uint32_t handle = 0;
+		for (auto& uni : m_Shader->GetVSUniformList().Uniforms)
+			m_UniformHandles.emplace(uni.Name, handle++);
+		for (auto& uni : m_Shader->GetFSUniformList().Uniforms)
+			m_UniformHandles.emplace(uni.Name, handle++);
+	}
+
+	void Material::writeUniform(uint32_t handle, const void* data, uint32_t size, uint32_t offset)
+	{
+		auto uni = getUniform(handle);
+		auto& buffer = getUniformBufferTarget(uni->ShaderType);
+		buffer.Write((void*)data, size, offset);
+		getDirtyRangeTarget(uni->ShaderType).Mark(offset, size);
+
+		for (auto& it : m_MaterialInstances)
+			it->updateMaterialValue(handle);
+	}
+
+	void Material::markDirty(uint32_t handle)
+	{
+		auto uni = getUniform(handle);
+		getDirtyRangeTarget(uni->ShaderType).Mark(uni->Offset, uni->Size * uni->Count);
+
+		for (auto& it : m_MaterialInstances)
+			it->updateMaterialValue(handle);
+	}
+
 	ByteBuffer& Material::getUniformBufferTarget(ShaderType type)
 	{
 		if (type == ShaderType::Vertex)
@@ -71,19 +119,29 @@ namespace XYZ {
 		return m_FSUniformBuffer;
 	}
 
-	const Uniform* Material::findUniform(const std::string& name) const
+	UniformDirtyRange& Material::getDirtyRangeTarget(ShaderType type)
 	{
-		for (auto& uni : m_Shader->GetVSUniformList().Uniforms)
-		{
-			if (uni.Name == name)
-				return &uni;
-		}
-		for (auto& uni : m_Shader->GetFSUniformList().Uniforms)
-		{
-			if (uni.Name == name)
-				return &uni;
-		}
-		return nullptr;
+		if (type == ShaderType::Vertex)
+			return m_VSDirtyRange;
+		return m_FSDirtyRange;
+	}
+
+	UniformDirtyRange& Material::getExposedRangeTarget(ShaderType type)
+	{
+		if (type == ShaderType::Vertex)
+			return m_VSExposedRange;
+		return m_FSExposedRange;
+	}
+
+	const Uniform* Material::getUniform(uint32_t handle) const
+	{
+		auto& vsUniforms = m_Shader->GetVSUniformList().Uniforms;
+		if (handle < vsUniforms.size())
+			return &vsUniforms[handle];
+
+		auto& fsUniforms = m_Shader->GetFSUniformList().Uniforms;
+		XYZ_ASSERT(handle - vsUniforms.size() < fsUniforms.size(), "Invalid uniform handle");
+		return &fsUniforms[handle - vsUniforms.size()];
 	}
 
 	const TextureUniform* Material::findTexture(const std::string& name) const
@@ -107,6 +165,7 @@ namespace XYZ {
 		m_Material->m_MaterialInstances.insert(this);
 		m_VSUniformBuffer = ByteBuffer::Copy(m_Material->m_VSUniformBuffer, m_Material->m_VSUniformBuffer.GetSize());
 		m_FSUniformBuffer = ByteBuffer::Copy(m_Material->m_FSUniformBuffer, m_Material->m_FSUniformBuffer.GetSize());
+		m_UpdatedValues.resize(m_Material->m_UniformHandles.size(), false);
 	}
 
 	MaterialInstance::~MaterialInstance()
@@ -119,10 +178,14 @@ namespace XYZ {
 
 	void MaterialInstance::Bind() const
 	{
+		m_VSDirtyRange.Mark(m_VSExposedRange);
+		m_FSDirtyRange.Mark(m_FSExposedRange);
 		if (m_VSUniformBuffer)
-			m_Material->m_Shader->SetVSUniforms(m_VSUniformBuffer);
+			m_Material->m_Shader->SetVSUniforms(m_VSUniformBuffer, m_VSDirtyRange.Begin, m_VSDirtyRange.End);
 		if (m_FSUniformBuffer)
-			m_Material->m_Shader->SetFSUniforms(m_FSUniformBuffer);
+			m_Material->m_Shader->SetFSUniforms(m_FSUniformBuffer, m_FSDirtyRange.Begin, m_FSDirtyRange.End);
+		m_VSDirtyRange.Reset();
+		m_FSDirtyRange.Reset();
 	}
 
 	Ref<MaterialInstance> MaterialInstance::Create(const Ref<Material>& material)
@@ -134,23 +197,39 @@ namespace XYZ {
 	{
 		m_VSUniformBuffer.Allocate(m_Material->m_Shader->GetVSUniformList().Size);
 		m_FSUniformBuffer.Allocate(m_Material->m_Shader->GetFSUniformList().Size);
+		m_VSDirtyRange.MarkAll();
+		m_FSDirtyRange.MarkAll();
+		m_VSExposedRange.Reset();
+		m_FSExposedRange.Reset();
+		m_UpdatedValues.assign(m_Material->m_UniformHandles.size(), false);
 	}
 
-	void MaterialInstance::updateMaterialValue(const Uniform* uni)
+	void MaterialInstance::updateMaterialValue(uint32_t handle)
 	{
-		if (m_UpdatedValues.find(uni->Name) == m_UpdatedValues.end())
-		{
-			if (uni->ShaderType == ShaderType::Vertex)
-			{
-				auto data = (uint8_t*)m_Material->m_VSUniformBuffer + uni->Offset;
-				m_VSUniformBuffer.Write(data, uni->Size, uni->Offset);
-			}
-			else
-			{
-				auto data = (uint8_t*)m_Material->m_FSUniformBuffer + uni->Offset;
-				m_FSUniformBuffer.Write(data, uni->Size, uni->Offset);
-			}
-		}
+		if (handle < m_UpdatedValues.size() && m_UpdatedValues[handle])
+			return;
+
+		auto uni = m_Material->getUniform(handle);
+		auto& source = m_Material->getUniformBufferTarget(uni->ShaderType);
+		auto& buffer = getUniformBufferTarget(uni->ShaderType);
+		buffer.Write((uint8_t*)source + uni->Offset, uni->Size, uni->Offset);
+		getDirtyRangeTarget(uni->ShaderType).Mark(uni->Offset, uni->Size);
+	}
+
+	void MaterialInstance::writeUniform(uint32_t handle, const void* data, uint32_t size, uint32_t offset)
+	{
+		auto uni = m_Material->getUniform(handle);
+		auto& buffer = getUniformBufferTarget(uni->ShaderType);
+		buffer.Write((void*)data, size, offset);
+		getDirtyRangeTarget(uni->ShaderType).Mark(offset, size);
+		markUpdated(handle);
+	}
+
+	void MaterialInstance::markUpdated(uint32_t handle)
+	{
+		if (handle >= m_UpdatedValues.size())
+			m_UpdatedValues.resize((size_t)handle + 1, false);
+		m_UpdatedValues[handle] = true;
 	}
 
 	ByteBuffer& MaterialInstance::getUniformBufferTarget(ShaderType type)
@@ -160,4 +239,18 @@ namespace XYZ {
 		return m_FSUniformBuffer;
 	}
 
+	UniformDirtyRange& MaterialInstance::getDirtyRangeTarget(ShaderType type)
+	{
+		if (type == ShaderType::Vertex)
+			return m_VSDirtyRange;
+		return m_FSDirtyRange;
+	}
+
+	UniformDirtyRange& MaterialInstance::getExposedRangeTarget(ShaderType type)
+	{
+		if (type == ShaderType::Vertex)
+			return m_VSExposedRange;
+		return m_FSExposedRange;
+	}
+
 }
\ No newline at end of file
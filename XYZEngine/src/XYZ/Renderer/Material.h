@@ -11,6 +11,26 @@
 
 namespace XYZ {
 
+	// Byte range of uniform buffer modified since the last upload
+	struct UniformDirtyRange
+	{
+		uint32_t Begin = 0;
+		uint32_t End = UINT32_MAX;
+
+		void Mark(uint32_t offset, uint32_t size)
+		{
+			Begin = std::min(Begin, offset);
+			End = std::max(End, offset + size);
+		}
+		void Mark(const UniformDirtyRange& other)
+		{
+			Begin = std::min(Begin, other.Begin);
+			End = std::max(End, other.End);
+		}
+		void MarkAll() { Begin = 0; End = UINT32_MAX; }
+		void Reset() { Begin = UINT32_MAX; End = 0; }
+	};
+
 	class Material : public Asset
 	{
 		friend class MaterialInstance;
@@ -18,30 +38,30 @@ namespace XYZ {
 		Material(const Ref<Shader>& shader);
 		~Material();
 
+		// Handle stays valid until the shader is reloaded
+		uint32_t GetUniformHandle(const std::string& name) const;
 
 		template<typename T>
 		void Set(const std::string& name, const T& val)
 		{
-			auto uni = findUniform(name);
-			XYZ_ASSERT(uni, "Material uniform does not exist ", name.c_str());
-			
-			auto& buffer = getUniformBufferTarget(uni->ShaderType);
-			buffer.Write((unsigned char*)&val, uni->Size, uni->Offset);
-
-			for (auto& it : m_MaterialInstances)
-				it->updateMaterialValue(uni);
+			uint32_t handle = GetUniformHandle(name);
+			XYZ_ASSERT(handle != sc_InvalidHandle, "Material uniform does not exist ", name.c_str());
+			Set(handle, val);
+		}
+		template<typename T>
+		void Set(uint32_t handle, const T& val)
+		{
+			auto uni = getUniform(handle);
+			writeUniform(handle, &val, uni->Size, uni->Offset);
 		}
 		template<typename T>
 		void Set(const std::string& name, const T& val, uint32_t size, uint32_t offset)
 		{
-			auto uni = findUniform(name);
-			XYZ_ASSERT(uni, "Material uniform does not exist ", name.c_str());
-			
-			auto& buffer = getUniformBufferTarget(uni->ShaderType);
-			buffer.Write((unsigned char*)&val, size, uni->Offset + offset);
-			
-			for (auto& it : m_MaterialInstances)
-				it->updateMaterialValue(uni);
+			uint32_t handle = GetUniformHandle(name);
+			XYZ_ASSERT(handle != sc_InvalidHandle, "Material uniform does not exist ", name.c_str());
+
+			auto uni = getUniform(handle);
+			writeUniform(handle, &val, size, uni->Offset + offset);
 		}
 
 		void Set(const std::string& name, const Ref<Texture2D>& texture, uint32_t index = 0)
@@ -65,19 +85,23 @@ namespace XYZ {
 			m_Textures[size_t(tex->Slot) + size_t(index)] = texture;
 		}
 
+		// Returned value may be modified later, uniform is uploaded on every bind from now on
 		template <typename T>
 		T* Get(const std::string& name)
 		{
-			auto uni = findUniform(name);
-			XYZ_ASSERT(uni, "Material uniform does not exist ", name.c_str());
+			uint32_t handle = GetUniformHandle(name);
+			XYZ_ASSERT(handle != sc_InvalidHandle, "Material uniform does not exist ", name.c_str());
+			auto uni = getUniform(handle);
+			markDirty(handle);
+			getExposedRangeTarget(uni->ShaderType).Mark(uni->Offset, uni->Size * uni->Count);
+
 			auto& buffer = getUniformBufferTarget(uni->ShaderType);
 			return (T*)&buffer[uni->Offset];
 		}
 
 		bool HasProperty(const std::string& name) const
 		{
-			auto uni = findUniform(name);
-			return uni;
+			return GetUniformHandle(name) != sc_InvalidHandle;
 		}
 
 		void Bind() const;
@@ -97,19 +121,32 @@ namespace XYZ {
 		bool operator ==(const Material& other) const;
 		bool operator != (const Material& other) const;
 		
+		static constexpr uint32_t sc_InvalidHandle = UINT32_MAX;
 	private:
 		void onShaderReload();
+		void resolveUniformHandles();
+		void writeUniform(uint32_t handle, const void* data, uint32_t size, uint32_t offset);
+		void markDirty(uint32_t handle);
 		ByteBuffer& getUniformBufferTarget(ShaderType type);
-		const Uniform* findUniform(const std::string& name) const;
+		UniformDirtyRange& getDirtyRangeTarget(ShaderType type);
+		UniformDirtyRange& getExposedRangeTarget(ShaderType type);
+		const Uniform* getUniform(uint32_t handle) const;
 		const TextureUniform* findTexture(const std::string& name) const;
 
 	private:
 		Ref<Shader> m_Shader;
 		std::vector<Ref<Texture>> m_Textures;
 		std::unordered_set<MaterialInstance*> m_MaterialInstances;
+		// Handle is index to vertex uniforms followed by fragment uniforms
+		std::unordered_map<std::string, uint32_t> m_UniformHandles;
 
 		ByteBuffer m_VSUniformBuffer;
 		ByteBuffer m_FSUniformBuffer;
+		mutable UniformDirtyRange m_VSDirtyRange;
+		mutable UniformDirtyRange m_FSDirtyRange;
+		// Uniforms returned by Get, they can be written through the pointer at any time
+		UniformDirtyRange m_VSExposedRange{ UINT32_MAX, 0 };
+		UniformDirtyRange m_FSExposedRange{ UINT32_MAX, 0 };
 		uint64_t   m_Flags;
 		uint8_t    m_RenderQueueID;
 	};
@@ -126,32 +163,41 @@ namespace XYZ {
 		template<typename T>
 		void Set(const std::string& name, const T& val)
 		{
-			auto uni = m_Material->findUniform(name);
-			XYZ_ASSERT(uni, "Material uniform does not exist ", name.c_str());
-			
-			auto& buffer = getUniformBufferTarget(uni->ShaderType);
-			buffer.Write((unsigned char*)&val, uni->Size, uni->Offset);
-			m_UpdatedValues.insert(name);
+			uint32_t handle = m_Material->GetUniformHandle(name);
+			XYZ_ASSERT(handle != Material::sc_InvalidHandle, "Material uniform does not exist ", name.c_str());
+			Set(handle, val);
+		}
+
+		template<typename T>
+		void Set(uint32_t handle, const T& val)
+		{
+			auto uni = m_Material->getUniform(handle);
+			writeUniform(handle, &val, uni->Size, uni->Offset);
 		}
 
 		template<typename T>
 		void Set(const std::string& name, const T& val, uint32_t size, uint32_t offset)
 		{
-			auto uni = m_Material->findUniform(name);
-			XYZ_ASSERT(uni, "Material uniform does not exist ", name.c_str());	
-			XYZ_ASSERT(size + Offset < uni->Size, "Material uniform out of range");
-			
-			auto& buffer = getUniformBufferTarget(uni->ShaderType);
-			buffer.Write((unsigned char*)&val, uni->Size, uni->Offset);
-			m_UpdatedValues.insert(name);
+			uint32_t handle = m_Material->GetUniformHandle(name);
+			XYZ_ASSERT(handle != Material::sc_InvalidHandle, "Material uniform does not exist ", name.c_str());
+
+			auto uni = m_Material->getUniform(handle);
+			XYZ_ASSERT(size + offset <= uni->Size * uni->Count, "Material uniform out of range");
+			writeUniform(handle, &val, size, uni->Offset + offset);
 		}
 
+		// Returned value may be modified later, uniform is uploaded on every bind from now on
 		template <typename T>
 		T& Get(const std::string& name)
 		{
-			auto uni = m_Material->findUniform(name);
-			XYZ_ASSERT(uni, "Material uniform does not exist ", name.c_str());
-			auto& buffer =getUniformBufferTarget(uni->ShaderType);
+			uint32_t handle = m_Material->GetUniformHandle(name);
+			XYZ_ASSERT(handle != Material::sc_InvalidHandle, "Material uniform does not exist ", name.c_str());
+			auto uni = m_Material->getUniform(handle);
+			getDirtyRangeTarget(uni->ShaderType).Mark(uni->Offset, uni->Size * uni->Count);
+			getExposedRangeTarget(uni->ShaderType).Mark(uni->Offset, uni->Size * uni->Count);
+			markUpdated(handle);
+
+			auto& buffer = getUniformBufferTarget(uni->ShaderType);
 			return *(T*)&buffer[uni->Offset];
 		}
 
@@ -166,14 +212,24 @@ namespace XYZ {
 	private:
 
 		void onShaderReload();
-		void updateMaterialValue(const Uniform* uni);
+		void updateMaterialValue(uint32_t handle);
+		void writeUniform(uint32_t handle, const void* data, uint32_t size, uint32_t offset);
+		void markUpdated(uint32_t handle);
 		ByteBuffer& getUniformBufferTarget(ShaderType type);
+		UniformDirtyRange& getDirtyRangeTarget(ShaderType type);
+		UniformDirtyRange& getExposedRangeTarget(ShaderType type);
 	private:
 		Ref<Material> m_Material;
 
 		ByteBuffer m_VSUniformBuffer;
 		ByteBuffer m_FSUniformBuffer;
-		std::unordered_set<std::string> m_UpdatedValues;
+		mutable UniformDirtyRange m_VSDirtyRange;
+		mutable UniformDirtyRange m_FSDirtyRange;
+		// Uniforms returned by Get, they can be written through the reference at any time
+		UniformDirtyRange m_VSExposedRange{ UINT32_MAX, 0 };
+		UniformDirtyRange m_FSExposedRange{ UINT32_MAX, 0 };
+		// Values set on instance are not overwritten by parent material
+		std::vector<bool> m_UpdatedValues;
 	};
 
 }
\ No newline at end of file
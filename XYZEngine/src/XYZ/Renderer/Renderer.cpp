@@ -6,6 +6,7 @@
 #include "SceneRenderer.h"
 
 #include "XYZ/Core/Application.h"
+#include "XYZ/Debug/ShaderCacheSelfTest.h"
 
 #include <GL/glew.h>
 
@@ -74,6 +75,10 @@ namespace XYZ {
 		Renderer::Submit([=]() {
 			RendererAPI::Init();
 		});
+#ifdef XYZ_DEBUG
+		if (GetAPI() == RendererAPI::API::OpenGL)
+			XYZ_ASSERT(RunShaderCacheSelfTest(), "Shader cache self test failed");
+#endif
 		CustomRenderer2D::Init();
 		Renderer2D::Init();
 		SceneRenderer::Init();
@@ -214,6 +219,14 @@ namespace XYZ {
 		//s_Data.RenderThreadFinished.wait();
 	}
 
+	const void* Renderer::SubmitData(const void* data, uint32_t size, uint32_t type)
+	{
+		auto queue = GetRenderCommandQueue(type);
+		void* storageBuffer = queue.Get().Allocate([](void*) {}, size);
+		memcpy(storageBuffer, data, size);
+		return storageBuffer;
+	}
+
 	ScopedLockReference<RenderCommandQueue> Renderer::GetRenderCommandQueue(uint8_t type)
 	{
 		return s_Data.CommandQueue->Write();
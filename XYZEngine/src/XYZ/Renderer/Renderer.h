@@ -61,6 +61,9 @@ namespace XYZ {
 			new (storageBuffer) FuncT(std::forward<FuncT>(func));
 		}
 
+		// Copies data into the command queue, it stays valid for commands submitted after it
+		static const void* SubmitData(const void* data, uint32_t size, uint32_t type = Default);
+
 		static void BeginRenderPass(const Ref<RenderPass>& renderPass, bool clear);
 		static void EndRenderPass();
 
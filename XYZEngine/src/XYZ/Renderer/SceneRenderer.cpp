@@ -3,8 +3,10 @@
 
 #include "Renderer2D.h"
 #include "Renderer.h"
+#include "LightGrid.h"
 
 #include "XYZ/Core/Input.h"
+#include "XYZ/Debug/LightGridSelfTest.h"
 #include <glm/gtx/transform.hpp>
 
 namespace XYZ {
@@ -34,6 +36,11 @@ namespace XYZ {
 
 		Ref<ShaderStorageBuffer> LightStorageBuffer;
 		Ref<ShaderStorageBuffer> SpotLightStorageBuffer;
+		Ref<ShaderStorageBuffer> LightTileStorageBuffer;
+		Ref<ShaderStorageBuffer> LightIndexStorageBuffer;
+		uint32_t				 LightTileCapacity = 0;
+		uint32_t				 LightIndexCapacity = 0;
+		XYZ::LightGrid			 LightGrid;
 		
 		struct PointLight
 		{	
@@ -70,6 +77,9 @@ namespace XYZ {
 
 	void SceneRenderer::Init()
 	{
+#ifdef XYZ_DEBUG
+		XYZ_ASSERT(RunLightGridSelfTest(), "Light grid self test failed");
+#endif
 		// Composite pass
 		{
 			FramebufferSpecs specs;
@@ -134,6 +144,11 @@ namespace XYZ {
 		s_Data.LightShader		      = Shader::Create("Assets/Shaders/LightShader.glsl");
 		s_Data.LightStorageBuffer     = ShaderStorageBuffer::Create(s_Data.MaxNumberOfLights * sizeof(SceneRendererData::PointLight), 1);
 		s_Data.SpotLightStorageBuffer = ShaderStorageBuffer::Create(s_Data.MaxNumberOfLights * sizeof(SceneRendererData::SpotLight), 2);
+		// Capacity of tile buffers grows with viewport and number of visible lights
+		s_Data.LightTileCapacity	   = 1024;
+		s_Data.LightIndexCapacity	   = s_Data.MaxNumberOfLights;
+		s_Data.LightTileStorageBuffer  = ShaderStorageBuffer::Create(s_Data.LightTileCapacity * sizeof(LightTile), 3);
+		s_Data.LightIndexStorageBuffer = ShaderStorageBuffer::Create(s_Data.LightIndexCapacity * sizeof(uint32_t), 4);
 	}
 
 	void SceneRenderer::Shutdown()
@@ -152,6 +167,8 @@ namespace XYZ {
 
 		s_Data.LightStorageBuffer.Reset();
 		s_Data.SpotLightStorageBuffer.Reset();
+		s_Data.LightTileStorageBuffer.Reset();
+		s_Data.LightIndexStorageBuffer.Reset();
 	}
 
 	void SceneRenderer::SetViewportSize(uint32_t width, uint32_t height)
@@ -198,22 +215,30 @@ namespace XYZ {
 		s_Data.Queues[command->Material->GetRenderQueueID()].DrawCommandList.push_back({ command, transform });
 	}
 	void SceneRenderer::SubmitLight(PointLight2D* light, const glm::mat4& transform)
+	{
+		SubmitLight(light, glm::vec2(transform[3][0], transform[3][1]));
+	}
+	void SceneRenderer::SubmitLight(SpotLight2D* light, const glm::mat4& transform)
+	{
+		SubmitLight(light, glm::vec2(transform[3][0], transform[3][1]));
+	}
+	void SceneRenderer::SubmitLight(PointLight2D* light, const glm::vec2& position)
 	{
 		XYZ_ASSERT(s_Data.PointLightsList.size() + 1 < s_Data.MaxNumberOfLights, "Max number of lights per scene is ", s_Data.MaxNumberOfLights);
 
 		SceneRendererData::PointLight lightData;
-		lightData.Position  = glm::vec2(transform[3][0], transform[3][1]);
+		lightData.Position  = position;
 		lightData.Color     = glm::vec4(light->Color, 0.0f);
 		lightData.Radius    = light->Radius;
 		lightData.Intensity = light->Intensity;
 		s_Data.PointLightsList.push_back(lightData);
 	}
-	void SceneRenderer::SubmitLight(SpotLight2D* light, const glm::mat4& transform)
+	void SceneRenderer::SubmitLight(SpotLight2D* light, const glm::vec2& position)
 	{
 		XYZ_ASSERT(s_Data.SpotLightsList.size() + 1 < s_Data.MaxNumberOfLights, "Max number of lights per scene is ", s_Data.MaxNumberOfLights);
 
 		SceneRendererData::SpotLight lightData;
-		lightData.Position   = glm::vec2(transform[3][0], transform[3][1]);
+		lightData.Position   = position;
 		lightData.Color		 = glm::vec4(light->Color, 0.0f);
 		lightData.Radius	 = light->Radius;
 		lightData.Intensity  = light->Intensity;
@@ -288,6 +313,7 @@ namespace XYZ {
 			s_Data.SpotLightStorageBuffer->Update(s_Data.SpotLightsList.data(), (uint32_t)s_Data.SpotLightsList.size() * (uint32_t)sizeof(SceneRendererData::SpotLight));
 			s_Data.SpotLightStorageBuffer->BindRange(0, (uint32_t)s_Data.SpotLightsList.size() * (uint32_t)sizeof(SceneRendererData::SpotLight));
 		}
+		binLights();
 		geometryPass(queue, s_Data.GeometryPass, true);
 		lightPass();
 		bloomPass();
@@ -312,7 +338,7 @@ namespace XYZ {
 	
 	void SceneRenderer::sortQueue(RenderQueue& queue)
 	{
-		std::sort(queue.SpriteDrawList.begin(), queue.SpriteDrawList.end(),
+		std::stable_sort(queue.SpriteDrawList.begin(), queue.SpriteDrawList.end(),
 			[](const RenderQueue::SpriteDrawCommand& a, const RenderQueue::SpriteDrawCommand& b) {
 			if (a.Sprite->SortLayer == b.Sprite->SortLayer)
 				return a.Sprite->Material->GetFlags() < b.Sprite->Material->GetFlags();
@@ -339,24 +365,65 @@ namespace XYZ {
 		Renderer2D::Flush();
 		Renderer2D::FlushLines();
 
+		static const uint32_t s_TransformID = Shader::GetUniformID("u_Transform");
 		for (auto& dc : queue.DrawCommandList)
 		{		
 			auto shader = dc.Command->Material->GetShader();
 			dc.Command->Material->Bind();
-			shader->SetMat4("u_Transform", dc.Transform->WorldTransform);
+			shader->SetMat4(s_TransformID, dc.Transform->WorldTransform);
 			dc.Command->Bind();
 		}
 
 		Renderer2D::EndScene();
 		Renderer::EndRenderPass();
 	}
+	void SceneRenderer::binLights()
+	{
+		LightGrid& grid = s_Data.LightGrid;
+		grid.Begin(s_Data.ViewProjectionMatrix, s_Data.ViewportSize, s_Data.Options.LightTileSize);
+		grid.AddLights(LightGrid::Point, s_Data.PointLightsList);
+		grid.AddLights(LightGrid::Spot, s_Data.SpotLightsList);
+		grid.End();
+
+		const auto& tiles = grid.GetTiles();
+		const auto& indices = grid.GetLightIndices();
+		if (tiles.empty())
+			return;
+
+		const uint32_t tilesSize = (uint32_t)(tiles.size() * sizeof(LightTile));
+		if ((uint32_t)tiles.size() > s_Data.LightTileCapacity)
+		{
+			s_Data.LightTileCapacity = (uint32_t)tiles.size();
+			s_Data.LightTileStorageBuffer->Resize((void*)tiles.data(), tilesSize);
+		}
+		else
+		{
+			s_Data.LightTileStorageBuffer->Update((void*)tiles.data(), tilesSize);
+		}
+		s_Data.LightTileStorageBuffer->BindRange(0, tilesSize);
+
+		if (indices.empty())
+			return;
+
+		const uint32_t indicesSize = (uint32_t)(indices.size() * sizeof(uint32_t));
+		if ((uint32_t)indices.size() > s_Data.LightIndexCapacity)
+		{
+			// Grow with reserve, number of covered tiles changes every frame
+			s_Data.LightIndexCapacity = (uint32_t)indices.size() * 3 / 2;
+			s_Data.LightIndexStorageBuffer->Resize(nullptr, s_Data.LightIndexCapacity * sizeof(uint32_t));
+		}
+		s_Data.LightIndexStorageBuffer->Update((void*)indices.data(), indicesSize);
+		s_Data.LightIndexStorageBuffer->BindRange(0, indicesSize);
+	}
+
 	void SceneRenderer::lightPass()
 	{
 		Renderer::BeginRenderPass(s_Data.LightPass, true);
 
+		const LightGrid& grid = s_Data.LightGrid;
 		s_Data.LightShader->Bind();
-		s_Data.LightShader->SetInt("u_NumberPointLights", (int)s_Data.PointLightsList.size() + 10);
-		s_Data.LightShader->SetInt("u_NumberSpotLights", (int)s_Data.SpotLightsList.size());
+		s_Data.LightShader->SetInt("u_TileSize", (int)grid.GetTileSize());
+		s_Data.LightShader->SetInt("u_TileCountX", (int)grid.GetTileCount().x);
 
 		s_Data.GeometryPass->GetSpecification().TargetFramebuffer->BindTexture(0, 0);
 		s_Data.GeometryPass->GetSpecification().TargetFramebuffer->BindTexture(1, 1);
@@ -18,6 +18,8 @@ namespace XYZ {
 	{
 		bool ShowGrid = true;
 		bool ShowBoundingBoxes = false;
+		// Size in pixels of screen tiles with own light lists
+		uint32_t LightTileSize = 32;
 	};
 
 	struct SceneRendererCamera
@@ -62,6 +64,8 @@ namespace XYZ {
 		static void SubmitRendererCommand(const RendererCommand* command, TransformComponent* transform);
 		static void SubmitLight(PointLight2D* light, const glm::mat4& transform);
 		static void SubmitLight(SpotLight2D* light, const glm::mat4& transform);
+		static void SubmitLight(PointLight2D* light, const glm::vec2& position);
+		static void SubmitLight(SpotLight2D* light, const glm::vec2& position);
 
 		static void SetGridProperties(const GridProperties& props);
 
@@ -76,6 +80,7 @@ namespace XYZ {
 		static void flushLightQueue();
 		static void flushDefaultQueue();
 		static void sortQueue(RenderQueue& queue);
+		static void binLights();
 
 		static void geometryPass(RenderQueue& queue, const Ref<RenderPass>& pass, bool clear);
 		static void lightPass();
@@ -4,8 +4,15 @@
 #include "Renderer.h"
 #include "XYZ/API/OpenGL/OpenGLShader.h"
 
+#include <mutex>
+
 
 namespace XYZ {
+
+	static std::mutex s_UniformIDMutex;
+	static std::unordered_map<std::string, uint32_t> s_UniformIDs;
+	static std::vector<std::string> s_UniformNames;
+
 	Ref<Shader> Shader::Create(const std::string& path)
 	{
 		switch (Renderer::GetAPI())
@@ -42,6 +49,24 @@ namespace XYZ {
 		XYZ_ASSERT(false, "Renderer::GetAPI() = RendererAPI::None");
 		return nullptr;
 	}
+	uint32_t Shader::GetUniformID(const std::string& name)
+	{
+		std::scoped_lock<std::mutex> lock(s_UniformIDMutex);
+		auto it = s_UniformIDs.find(name);
+		if (it != s_UniformIDs.end())
+			return it->second;
+
+		uint32_t id = (uint32_t)s_UniformNames.size();
+		s_UniformIDs.emplace(name, id);
+		s_UniformNames.push_back(name);
+		return id;
+	}
+	std::string Shader::GetUniformName(uint32_t uniformID)
+	{
+		std::scoped_lock<std::mutex> lock(s_UniformIDMutex);
+		XYZ_ASSERT(uniformID < s_UniformNames.size(), "Invalid uniform id");
+		return s_UniformNames[uniformID];
+	}
 	void ShaderLibrary::Add(const Ref<Shader>& shader)
 	{
 		auto& name = shader->GetName();
@@ -114,8 +114,9 @@ namespace XYZ {
 		virtual void Bind() const = 0;
 		virtual void Unbind() const = 0;
 		virtual void Compute(uint32_t groupX, uint32_t groupY = 1, uint32_t groupZ = 1) const = 0;
-		virtual void SetVSUniforms(ByteBuffer buffer) const = 0;
-		virtual void SetFSUniforms(ByteBuffer buffer) const = 0;
+		// Only uniforms overlapping dirty byte range are uploaded if the buffer was the last one uploaded
+		virtual void SetVSUniforms(ByteBuffer buffer, uint32_t dirtyBegin = 0, uint32_t dirtyEnd = UINT32_MAX) const = 0;
+		virtual void SetFSUniforms(ByteBuffer buffer, uint32_t dirtyBegin = 0, uint32_t dirtyEnd = UINT32_MAX) const = 0;
 
 		virtual void Reload() = 0;
 		virtual void AddReloadCallback(std::function<void()> callback) = 0;
@@ -128,6 +129,15 @@ namespace XYZ {
 		virtual void SetFloat4(const std::string& name, const glm::vec4& value) = 0;
 		virtual void SetMat4(const std::string& name, const glm::mat4& value) = 0;
 
+		// Uniform ids avoid string lookups and copies, prefer them in code running every frame
+		virtual void SetInt(uint32_t uniformID, int value) = 0;
+		virtual void SetFloat(uint32_t uniformID, float value) = 0;
+		virtual void SetFloat2(uint32_t uniformID, const glm::vec2& value) = 0;
+		virtual void SetFloat3(uint32_t uniformID, const glm::vec3& value) = 0;
+		virtual void SetFloat4(uint32_t uniformID, const glm::vec4& value) = 0;
+		virtual void SetMat4(uint32_t uniformID, const glm::mat4& value) = 0;
+		virtual void SetMat4Array(uint32_t uniformID, const glm::mat4* values, uint32_t count) = 0;
+
 		virtual const UniformList& GetVSUniformList() const = 0;
 		virtual const UniformList& GetFSUniformList() const = 0;
 		virtual const TextureUniformList& GetTextureList() const = 0;
@@ -139,6 +149,10 @@ namespace XYZ {
 
 		static Ref<Shader> Create(const std::string& path);
 		static Ref<Shader> Create(const std::string& name, const std::string& path);
+
+		// Interns uniform name, id is unique for the name across all shaders
+		static uint32_t	   GetUniformID(const std::string& name);
+		static std::string GetUniformName(uint32_t uniformID);
 	};
 
 	class ShaderLibrary : public RefCount
@@ -61,19 +61,19 @@ namespace XYZ {
 
     void SkeletalMesh::Render()
     {
+        static const uint32_t s_TransformID = Shader::GetUniformID("u_Transform");
+        static const uint32_t s_ColorID = Shader::GetUniformID("u_Color");
+        static const uint32_t s_BonesID = Shader::GetUniformID("u_Bones");
+
         Ref<Shader> shader = m_Material->GetShader();
         m_Material->Bind();
-        shader->SetMat4("u_Transform", glm::translate(glm::vec3(0.0f)));
-        shader->SetFloat4("u_Color", glm::vec4(1.0f));
-
-        uint32_t counter = 0;
-        for (const SceneEntity& boneEntity : m_Bones)
-        {
-            const glm::mat4& transform = boneEntity.GetComponent<TransformComponent>().WorldTransform;
-            char name[12];
-            sprintf(name, "u_Bones[%u]", counter++);
-            shader->SetMat4(name, transform);
-        }
+        shader->SetMat4(s_TransformID, glm::translate(glm::vec3(0.0f)));
+        shader->SetFloat4(s_ColorID, glm::vec4(1.0f));
+
+        m_BoneTransforms.resize(m_Bones.size());
+        for (size_t i = 0; i < m_Bones.size(); ++i)
+            m_BoneTransforms[i] = m_Bones[i].GetComponent<TransformComponent>().WorldTransform;
+        shader->SetMat4Array(s_BonesID, m_BoneTransforms.data(), (uint32_t)m_BoneTransforms.size());
 
         m_VertexArray->Bind();
         Renderer::DrawIndexed(PrimitiveType::Triangles, (uint32_t)m_Indices.size());
@@ -95,5 +95,12 @@ namespace XYZ {
 
         Ref<IndexBuffer> ibo = IndexBuffer::Create(m_Indices.data(), (uint32_t)m_Indices.size());
         m_VertexArray->SetIndexBuffer(ibo);
+
+        m_SkinningStreams = SkinningStreams::FromVertices(m_Vertices);
+    }
+
+    void SkeletalMesh::SkinVertices(const glm::mat4* palette, SkinnedPositions& result) const
+    {
+        Skinning::Skin(palette, m_SkinningStreams, result);
     }
 }
\ No newline at end of file
@@ -4,6 +4,7 @@
 #include "XYZ/Renderer/Material.h"
 #include "XYZ/Utils/DataStructures/Tree.h"
 #include "XYZ/Utils/DataStructures/MemoryPool.h"
+#include "XYZ/Animation/Skinning.h"
 
 
 #include <glm/glm.hpp>
@@ -65,6 +66,8 @@ namespace XYZ {
 
 		void Render();
 		void RebuildBuffers();
+		// Cpu skinned positions for collisions and picking, palette is indexed by bone ids of vertices
+		void SkinVertices(const glm::mat4* palette, SkinnedPositions& result) const;
 
 		const Ref<Material>& GetMaterial() const { return m_Material; }
 		const std::vector<AnimatedVertex>& GetVertices() const { return m_Vertices; }
@@ -77,5 +80,7 @@ namespace XYZ {
 		std::vector<AnimatedVertex> m_Vertices;
 		std::vector<uint32_t> m_Indices;	
 		std::vector<SceneEntity> m_Bones;
+		std::vector<glm::mat4>	 m_BoneTransforms;
+		SkinningStreams			 m_SkinningStreams;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,379 @@
+#include "stdafx.h"
+#include "TextureAtlas.h"
+
+#include "XYZ/Asset/AssetManager.h"
+#include "XYZ/Renderer/SubTexture.h"
+
+#include <stb_image.h>
+#include <stbi_image_write.h>
+
+#include <cstring>
+#include <unordered_map>
+
+namespace XYZ {
+
+	static bool Intersects(const PackedRect& a, const PackedRect& b)
+	{
+		return a.X < b.X + b.Width && b.X < a.X + a.Width
+			&& a.Y < b.Y + b.Height && b.Y < a.Y + a.Height;
+	}
+
+	static bool Contains(const PackedRect& outer, const PackedRect& inner)
+	{
+		return inner.X >= outer.X && inner.Y >= outer.Y
+			&& inner.X + inner.Width <= outer.X + outer.Width
+			&& inner.Y + inner.Height <= outer.Y + outer.Height;
+	}
+
+	RectanglePacker::RectanglePacker(uint32_t width, uint32_t height)
+		: m_Width(width), m_Height(height)
+	{
+		m_FreeRects.push_back({ 0, 0, width, height });
+	}
+
+	bool RectanglePacker::Insert(uint32_t width, uint32_t height, PackedRect& result)
+	{
+		uint32_t bestShortSide = UINT32_MAX;
+		uint32_t bestLongSide = UINT32_MAX;
+		int32_t  bestIndex = -1;
+		for (size_t i = 0; i < m_FreeRects.size(); ++i)
+		{
+			const PackedRect& free = m_FreeRects[i];
+			if (free.Width < width || free.Height < height)
+				continue;
+
+			uint32_t leftoverX = free.Width - width;
+			uint32_t leftoverY = free.Height - height;
+			uint32_t shortSide = std::min(leftoverX, leftoverY);
+			uint32_t longSide = std::max(leftoverX, leftoverY);
+			if (shortSide < bestShortSide || (shortSide == bestShortSide && longSide < bestLongSide))
+			{
+				bestShortSide = shortSide;
+				bestLongSide = longSide;
+				bestIndex = (int32_t)i;
+			}
+		}
+		if (bestIndex == -1)
+			return false;
+
+		result = { m_FreeRects[bestIndex].X, m_FreeRects[bestIndex].Y, width, height };
+		splitFreeRects(result);
+		pruneFreeRects();
+		m_UsedArea += (uint64_t)width * height;
+		return true;
+	}
+
+	float RectanglePacker::GetOccupancy() const
+	{
+		return (float)((double)m_UsedArea / ((double)m_Width * m_Height));
+	}
+
+	void RectanglePacker::splitFreeRects(const PackedRect& used)
+	{
+		std::vector<PackedRect> newRects;
+		for (size_t i = 0; i < m_FreeRects.size();)
+		{
+			const PackedRect free = m_FreeRects[i];
+			if (!Intersects(free, used))
+			{
+				++i;
+				continue;
+			}
+			if (used.X > free.X)
+				newRects.push_back({ free.X, free.Y, used.X - free.X, free.Height });
+			if (used.X + used.Width < free.X + free.Width)
+				newRects.push_back({ used.X + used.Width, free.Y, free.X + free.Width - used.X - used.Width, free.Height });
+			if (used.Y > free.Y)
+				newRects.push_back({ free.X, free.Y, free.Width, used.Y - free.Y });
+			if (used.Y + used.Height < free.Y + free.Height)
+				newRects.push_back({ free.X, used.Y + used.Height, free.Width, free.Y + free.Height - used.Y - used.Height });
+
+			m_FreeRects[i] = m_FreeRects.back();
+			m_FreeRects.pop_back();
+		}
+		m_FreeRects.insert(m_FreeRects.end(), newRects.begin(), newRects.end());
+	}
+
+	void RectanglePacker::pruneFreeRects()
+	{
+		for (size_t i = 0; i < m_FreeRects.size(); ++i)
+		{
+			for (size_t j = i + 1; j < m_FreeRects.size();)
+			{
+				if (Contains(m_FreeRects[j], m_FreeRects[i]))
+				{
+					m_FreeRects[i] = m_FreeRects[j];
+					m_FreeRects[j] = m_FreeRects.back();
+					m_FreeRects.pop_back();
+					// Restart the inner loop, rect i changed
+					j = i + 1;
+				}
+				else if (Contains(m_FreeRects[i], m_FreeRects[j]))
+				{
+					m_FreeRects[j] = m_FreeRects.back();
+					m_FreeRects.pop_back();
+				}
+				else
+				{
+					++j;
+				}
+			}
+		}
+	}
+
+
+	TextureAtlasBuilder::TextureAtlasBuilder(const TextureAtlasSettings& settings)
+		: m_Settings(settings)
+	{
+	}
+
+	void TextureAtlasBuilder::AddImage(uint32_t id, const uint8_t* pixels, uint32_t width, uint32_t height, uint32_t channels)
+	{
+		XYZ_ASSERT(channels >= 1 && channels <= 4, "Unsupported number of channels");
+		Image image;
+		image.ID = id;
+		image.Width = width;
+		image.Height = height;
+		image.Pixels.resize((size_t)width * height * 4);
+		for (size_t i = 0; i < (size_t)width * height; ++i)
+		{
+			const uint8_t* source = &pixels[i * channels];
+			uint8_t* destination = &image.Pixels[i * 4];
+			destination[0] = source[0];
+			destination[1] = channels > 2 ? source[1] : source[0];
+			destination[2] = channels > 2 ? source[2] : source[0];
+			destination[3] = channels == 4 ? source[3] : (channels == 2 ? source[1] : 255);
+		}
+		m_Images.push_back(std::move(image));
+	}
+
+	bool TextureAtlasBuilder::AddImage(uint32_t id, const std::string& filepath)
+	{
+		int width, height, channels;
+		stbi_set_flip_vertically_on_load(0);
+		uint8_t* pixels = stbi_load(filepath.c_str(), &width, &height, &channels, 0);
+		if (!pixels)
+		{
+			XYZ_LOG_ERR("Failed to load image ", filepath);
+			return false;
+		}
+		AddImage(id, pixels, (uint32_t)width, (uint32_t)height, (uint32_t)channels);
+		stbi_image_free(pixels);
+		return true;
+	}
+
+	bool TextureAtlasBuilder::Build()
+	{
+		m_Pages.clear();
+		m_Placements.clear();
+
+		std::vector<const Image*> sorted;
+		sorted.reserve(m_Images.size());
+		for (const Image& image : m_Images)
+			sorted.push_back(&image);
+		std::sort(sorted.begin(), sorted.end(), [](const Image* a, const Image* b) {
+			uint32_t maxA = std::max(a->Width, a->Height), maxB = std::max(b->Width, b->Height);
+			if (maxA != maxB)
+				return maxA > maxB;
+			return a->Width * a->Height > b->Width * b->Height;
+		});
+
+		const uint32_t padding = m_Settings.Padding;
+		std::vector<RectanglePacker> packers;
+		bool success = true;
+		for (const Image* image : sorted)
+		{
+			uint32_t width = image->Width + 2 * padding;
+			uint32_t height = image->Height + 2 * padding;
+			if (width > m_Settings.MaxWidth || height > m_Settings.MaxHeight)
+			{
+				XYZ_LOG_WARN("Image ", image->ID, " does not fit into atlas page");
+				success = false;
+				continue;
+			}
+
+			TextureAtlasPlacement placement;
+			placement.ID = image->ID;
+			placement.Page = (uint32_t)packers.size();
+			for (uint32_t i = 0; i < (uint32_t)packers.size(); ++i)
+			{
+				if (packers[i].Insert(width, height, placement.Rect))
+				{
+					placement.Page = i;
+					break;
+				}
+			}
+			if (placement.Page == packers.size())
+			{
+				packers.emplace_back(m_Settings.MaxWidth, m_Settings.MaxHeight);
+				packers.back().Insert(width, height, placement.Rect);
+			}
+			m_Placements.push_back(placement);
+		}
+
+		// Shrink pages to the used area
+		m_Pages.resize(packers.size());
+		for (const TextureAtlasPlacement& placement : m_Placements)
+		{
+			TextureAtlasPage& page = m_Pages[placement.Page];
+			page.Width = std::max(page.Width, placement.Rect.X + placement.Rect.Width);
+			page.Height = std::max(page.Height, placement.Rect.Y + placement.Rect.Height);
+		}
+		for (TextureAtlasPage& page : m_Pages)
+		{
+			// Multiple of 4 keeps pages block compressible
+			page.Width = (page.Width + 3) & ~3u;
+			page.Height = (page.Height + 3) & ~3u;
+			page.Pixels.assign((size_t)page.Width * page.Height * 4, 0);
+		}
+
+		std::unordered_map<uint32_t, const Image*> images;
+		for (const Image& image : m_Images)
+			images[image.ID] = &image;
+
+		for (TextureAtlasPlacement& placement : m_Placements)
+		{
+			TextureAtlasPage& page = m_Pages[placement.Page];
+			blit(page, *images[placement.ID], placement.Rect);
+
+			// Inner rect without padding
+			PackedRect& rect = placement.Rect;
+			rect = { rect.X + padding, rect.Y + padding, rect.Width - 2 * padding, rect.Height - 2 * padding };
+			const float width = (float)page.Width;
+			const float height = (float)page.Height;
+			placement.TexCoords = {
+				(float)rect.X / width,
+				(float)(page.Height - rect.Y - rect.Height) / height,
+				(float)(rect.X + rect.Width) / width,
+				(float)(page.Height - rect.Y) / height
+			};
+		}
+		return success;
+	}
+
+	bool TextureAtlasBuilder::WritePages(const std::string& filepathPrefix, std::vector<std::string>* filepaths) const
+	{
+		for (size_t i = 0; i < m_Pages.size(); ++i)
+		{
+			const TextureAtlasPage& page = m_Pages[i];
+			std::string filepath = filepathPrefix + "_" + std::to_string(i) + ".png";
+			if (!stbi_write_png(filepath.c_str(), (int)page.Width, (int)page.Height, 4, page.Pixels.data(), (int)page.Width * 4))
+			{
+				XYZ_LOG_ERR("Could not write atlas page ", filepath);
+				return false;
+			}
+			if (filepaths)
+				filepaths->push_back(filepath);
+		}
+		return true;
+	}
+
+	const TextureAtlasPlacement* TextureAtlasBuilder::FindPlacement(uint32_t id) const
+	{
+		for (const TextureAtlasPlacement& placement : m_Placements)
+		{
+			if (placement.ID == id)
+				return &placement;
+		}
+		return nullptr;
+	}
+
+	glm::vec4 TextureAtlasBuilder::RemapTexCoords(const glm::vec4& placementTexCoords, const glm::vec4& texCoords)
+	{
+		const float width = placementTexCoords.z - placementTexCoords.x;
+		const float height = placementTexCoords.w - placementTexCoords.y;
+		return {
+			placementTexCoords.x + texCoords.x * width,
+			placementTexCoords.y + texCoords.y * height,
+			placementTexCoords.x + texCoords.z * width,
+			placementTexCoords.y + texCoords.w * height
+		};
+	}
+
+	uint32_t TextureAtlasBuilder::PackSubTextures(const std::string& directory, const std::string& atlasName, const TextureAtlasSettings& settings)
+	{
+		std::vector<Ref<SubTexture>> subTextures;
+		for (auto& asset : AssetManager::FindAssetsByType(AssetType::SubTexture))
+			subTextures.push_back(AssetManager::GetAsset<SubTexture>(asset->Handle));
+
+		// Directory handles are stored with forward slashes
+		std::string directoryPath = directory;
+		std::replace(directoryPath.begin(), directoryPath.end(), '\\', '/');
+		while (directoryPath.size() > 1 && directoryPath.back() == '/')
+			directoryPath.pop_back();
+
+		// Unique source textures by filepath, renderer IDs are assigned later on the render thread
+		std::vector<Ref<Texture>> textures;
+		std::unordered_map<std::string, uint32_t> textureIndices;
+		TextureAtlasBuilder builder(settings);
+		for (auto& subTexture : subTextures)
+		{
+			const Ref<Texture>& texture = subTexture->GetTexture();
+			if (!texture.Raw() || texture->GetFilepath().empty())
+				continue;
+			if (textureIndices.find(texture->GetFilepath()) != textureIndices.end())
+				continue;
+
+			uint32_t id = (uint32_t)textures.size();
+			if (builder.AddImage(id, texture->GetFilepath()))
+			{
+				textureIndices[texture->GetFilepath()] = id;
+				textures.push_back(texture);
+			}
+		}
+		if (textures.empty())
+			return 0;
+
+		builder.Build();
+		std::vector<std::string> pagePaths;
+		if (!builder.WritePages(directoryPath + "/" + atlasName, &pagePaths))
+			return 0;
+
+		GUID directoryHandle = AssetManager::GetDirectoryHandle(directoryPath);
+		std::vector<Ref<Texture2D>> pages;
+		for (const std::string& pagePath : pagePaths)
+		{
+			Ref<Texture2D> page = Texture2D::Create(TextureSpecs(), pagePath);
+			AssetManager::RegisterAsset(page, Utils::GetFilename(pagePath) + ".tex", AssetType::Texture, directoryHandle);
+			pages.push_back(page);
+		}
+
+		uint32_t count = 0;
+		for (auto& subTexture : subTextures)
+		{
+			const Ref<Texture>& texture = subTexture->GetTexture();
+			if (!texture.Raw())
+				continue;
+			auto it = textureIndices.find(texture->GetFilepath());
+			if (it == textureIndices.end())
+				continue;
+
+			const TextureAtlasPlacement* placement = builder.FindPlacement(it->second);
+			if (!placement)
+				continue;
+
+			subTexture->SetTexCoords(RemapTexCoords(placement->TexCoords, subTexture->GetTexCoords()));
+			subTexture->SetTexture(pages[placement->Page]);
+			AssetSerializer::SerializeAsset(subTexture);
+			count++;
+		}
+		XYZ_LOG_INFO("Packed ", textures.size(), " textures into ", pages.size(), " atlas pages, ", count, " sub textures updated");
+		return count;
+	}
+
+	void TextureAtlasBuilder::blit(TextureAtlasPage& page, const Image& image, const PackedRect& rect) const
+	{
+		const int32_t padding = (int32_t)m_Settings.Padding;
+		for (uint32_t y = 0; y < rect.Height; ++y)
+		{
+			int32_t sourceY = std::clamp((int32_t)y - padding, 0, (int32_t)image.Height - 1);
+			for (uint32_t x = 0; x < rect.Width; ++x)
+			{
+				int32_t sourceX = std::clamp((int32_t)x - padding, 0, (int32_t)image.Width - 1);
+				const uint8_t* source = &image.Pixels[((size_t)sourceY * image.Width + sourceX) * 4];
+				uint8_t* destination = &page.Pixels[((size_t)(rect.Y + y) * page.Width + rect.X + x) * 4];
+				memcpy(destination, source, 4);
+			}
+		}
+	}
+}
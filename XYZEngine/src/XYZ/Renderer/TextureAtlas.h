@@ -0,0 +1,99 @@
+#pragma once
+#include <glm/glm.hpp>
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace XYZ {
+
+	struct PackedRect
+	{
+		uint32_t X = 0, Y = 0;
+		uint32_t Width = 0, Height = 0;
+	};
+
+	// MaxRects bin packer using best short side fit heuristic
+	class RectanglePacker
+	{
+	public:
+		RectanglePacker(uint32_t width, uint32_t height);
+
+		bool Insert(uint32_t width, uint32_t height, PackedRect& result);
+
+		uint32_t GetWidth() const { return m_Width; }
+		uint32_t GetHeight() const { return m_Height; }
+		float	 GetOccupancy() const;
+	private:
+		void splitFreeRects(const PackedRect& used);
+		void pruneFreeRects();
+
+	private:
+		uint32_t m_Width;
+		uint32_t m_Height;
+		uint64_t m_UsedArea = 0;
+		std::vector<PackedRect> m_FreeRects;
+	};
+
+	struct TextureAtlasSettings
+	{
+		uint32_t MaxWidth = 2048;
+		uint32_t MaxHeight = 2048;
+		// Border around every image filled with its edge pixels to prevent bleeding
+		uint32_t Padding = 2;
+	};
+
+	struct TextureAtlasPage
+	{
+		uint32_t Width = 0;
+		uint32_t Height = 0;
+		std::vector<uint8_t> Pixels; // RGBA8, first row is top of the image
+	};
+
+	struct TextureAtlasPlacement
+	{
+		uint32_t   ID = 0;
+		uint32_t   Page = 0;
+		PackedRect Rect;
+		// Rect in texture coordinates of the page, y goes up as in textures loaded with vertical flip
+		glm::vec4  TexCoords;
+	};
+
+	class TextureAtlasBuilder
+	{
+	public:
+		TextureAtlasBuilder(const TextureAtlasSettings& settings = TextureAtlasSettings());
+
+		// Pixels are copied, first row is top of the image
+		void AddImage(uint32_t id, const uint8_t* pixels, uint32_t width, uint32_t height, uint32_t channels);
+		bool AddImage(uint32_t id, const std::string& filepath);
+		bool Build();
+
+		bool WritePages(const std::string& filepathPrefix, std::vector<std::string>* filepaths = nullptr) const;
+
+		const std::vector<TextureAtlasPage>&	  GetPages() const { return m_Pages; }
+		const std::vector<TextureAtlasPlacement>& GetPlacements() const { return m_Placements; }
+		const TextureAtlasPlacement*			  FindPlacement(uint32_t id) const;
+
+		// Maps tex coords of the source image to tex coords inside the atlas
+		static glm::vec4 RemapTexCoords(const glm::vec4& placementTexCoords, const glm::vec4& texCoords);
+		// Packs textures of all SubTexture assets into atlases stored in directory and rewrites the sub textures
+		static uint32_t  PackSubTextures(const std::string& directory, const std::string& atlasName, const TextureAtlasSettings& settings = TextureAtlasSettings());
+
+	private:
+		struct Image
+		{
+			uint32_t ID;
+			uint32_t Width, Height;
+			std::vector<uint8_t> Pixels; // RGBA8
+		};
+
+		void blit(TextureAtlasPage& page, const Image& image, const PackedRect& rect) const;
+
+	private:
+		TextureAtlasSettings			   m_Settings;
+		std::vector<Image>				   m_Images;
+		std::vector<TextureAtlasPage>	   m_Pages;
+		std::vector<TextureAtlasPlacement> m_Placements;
+	};
+}
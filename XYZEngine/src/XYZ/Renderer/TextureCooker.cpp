@@ -0,0 +1,400 @@
+#include "stdafx.h"
+#include "TextureCooker.h"
+
+#include "XYZ/Asset/AssetManager.h"
+#include "XYZ/Utils/StringUtils.h"
+
+#include <stb_image.h>
+
+#include <filesystem>
+#include <cstring>
+
+namespace XYZ {
+
+	static constexpr uint64_t sc_MipAlignment = 16;
+
+	struct BlockColor
+	{
+		int R, G, B;
+	};
+
+	static uint16_t PackColor565(const BlockColor& color)
+	{
+		return (uint16_t)(((color.R * 31 + 127) / 255) << 11 | ((color.G * 63 + 127) / 255) << 5 | ((color.B * 31 + 127) / 255));
+	}
+
+	static BlockColor UnpackColor565(uint16_t color)
+	{
+		int r = (color >> 11) & 31;
+		int g = (color >> 5) & 63;
+		int b = color & 31;
+		return { (r << 3) | (r >> 2), (g << 2) | (g >> 4), (b << 3) | (b >> 2) };
+	}
+
+	static int ColorDistance(const BlockColor& a, const BlockColor& b)
+	{
+		int dr = a.R - b.R, dg = a.G - b.G, db = a.B - b.B;
+		return dr * dr + dg * dg + db * db;
+	}
+
+	static void FetchBlock(const uint8_t* source, uint32_t width, uint32_t height, uint32_t channels, uint32_t blockX, uint32_t blockY, uint8_t block[16][4])
+	{
+		for (uint32_t y = 0; y < 4; ++y)
+		{
+			uint32_t sy = std::min(blockY * 4 + y, height - 1);
+			for (uint32_t x = 0; x < 4; ++x)
+			{
+				uint32_t sx = std::min(blockX * 4 + x, width - 1);
+				const uint8_t* pixel = &source[((size_t)sy * width + sx) * channels];
+				uint8_t* out = block[y * 4 + x];
+				out[0] = pixel[0];
+				out[1] = channels > 1 ? pixel[1] : pixel[0];
+				out[2] = channels > 2 ? pixel[2] : pixel[0];
+				out[3] = channels > 3 ? pixel[3] : 255;
+			}
+		}
+	}
+
+	static void EncodeColorBlock(const uint8_t block[16][4], uint8_t* result)
+	{
+		BlockColor minColor = { 255, 255, 255 };
+		BlockColor maxColor = { 0, 0, 0 };
+		BlockColor center = { 0, 0, 0 };
+		for (uint32_t i = 0; i < 16; ++i)
+		{
+			minColor.R = std::min<int>(minColor.R, block[i][0]); maxColor.R = std::max<int>(maxColor.R, block[i][0]);
+			minColor.G = std::min<int>(minColor.G, block[i][1]); maxColor.G = std::max<int>(maxColor.G, block[i][1]);
+			minColor.B = std::min<int>(minColor.B, block[i][2]); maxColor.B = std::max<int>(maxColor.B, block[i][2]);
+			center.R += block[i][0]; center.G += block[i][1]; center.B += block[i][2];
+		}
+		center = { center.R / 16, center.G / 16, center.B / 16 };
+
+		// Pick the bounding box diagonal that follows the color distribution
+		int covRG = 0, covRB = 0;
+		for (uint32_t i = 0; i < 16; ++i)
+		{
+			int r = block[i][0] - center.R;
+			covRG += r * (block[i][1] - center.G);
+			covRB += r * (block[i][2] - center.B);
+		}
+		if (covRG < 0)
+			std::swap(minColor.G, maxColor.G);
+		if (covRB < 0)
+			std::swap(minColor.B, maxColor.B);
+
+		// Inset the end points to reduce error of the interpolated colors
+		auto inset = [](int& lo, int& hi) {
+			int offset = (hi - lo) / 16;
+			lo += offset;
+			hi -= offset;
+		};
+		inset(minColor.R, maxColor.R);
+		inset(minColor.G, maxColor.G);
+		inset(minColor.B, maxColor.B);
+
+		uint16_t color0 = PackColor565(maxColor);
+		uint16_t color1 = PackColor565(minColor);
+		if (color0 < color1)
+			std::swap(color0, color1);
+
+		uint32_t indices = 0;
+		if (color0 != color1)
+		{
+			BlockColor palette[4];
+			palette[0] = UnpackColor565(color0);
+			palette[1] = UnpackColor565(color1);
+			palette[2] = { (2 * palette[0].R + palette[1].R) / 3, (2 * palette[0].G + palette[1].G) / 3, (2 * palette[0].B + palette[1].B) / 3 };
+			palette[3] = { (palette[0].R + 2 * palette[1].R) / 3, (palette[0].G + 2 * palette[1].G) / 3, (palette[0].B + 2 * palette[1].B) / 3 };
+			for (uint32_t i = 0; i < 16; ++i)
+			{
+				BlockColor color = { block[i][0], block[i][1], block[i][2] };
+				uint32_t best = 0;
+				int bestDistance = ColorDistance(color, palette[0]);
+				for (uint32_t p = 1; p < 4; ++p)
+				{
+					int distance = ColorDistance(color, palette[p]);
+					if (distance < bestDistance)
+					{
+						bestDistance = distance;
+						best = p;
+					}
+				}
+				indices |= best << (i * 2);
+			}
+		}
+		result[0] = (uint8_t)(color0 & 0xFF);
+		result[1] = (uint8_t)(color0 >> 8);
+		result[2] = (uint8_t)(color1 & 0xFF);
+		result[3] = (uint8_t)(color1 >> 8);
+		memcpy(&result[4], &indices, sizeof(uint32_t));
+	}
+
+	static void EncodeAlphaBlock(const uint8_t block[16][4], uint8_t* result)
+	{
+		int minAlpha = 255, maxAlpha = 0;
+		for (uint32_t i = 0; i < 16; ++i)
+		{
+			minAlpha = std::min<int>(minAlpha, block[i][3]);
+			maxAlpha = std::max<int>(maxAlpha, block[i][3]);
+		}
+		result[0] = (uint8_t)maxAlpha;
+		result[1] = (uint8_t)minAlpha;
+
+		uint64_t indices = 0;
+		if (maxAlpha != minAlpha)
+		{
+			const int range = maxAlpha - minAlpha;
+			for (uint32_t i = 0; i < 16; ++i)
+			{
+				// Position between min ( 0 ) and max ( 7 )
+				int position = ((block[i][3] - minAlpha) * 7 + range / 2) / range;
+				uint64_t code;
+				if (position == 7)
+					code = 0;
+				else if (position == 0)
+					code = 1;
+				else
+					code = 8 - position;
+				indices |= code << (i * 3);
+			}
+		}
+		for (uint32_t i = 0; i < 6; ++i)
+			result[2 + i] = (uint8_t)(indices >> (i * 8));
+	}
+
+	size_t TextureCooker::GetMipSize(CookedTextureFormat format, uint32_t width, uint32_t height)
+	{
+		size_t blocks = (size_t)std::max(1u, (width + 3) / 4) * (size_t)std::max(1u, (height + 3) / 4);
+		switch (format)
+		{
+		case CookedTextureFormat::R8:    return (size_t)width * height;
+		case CookedTextureFormat::RGB8:  return (size_t)width * height * 3;
+		case CookedTextureFormat::RGBA8: return (size_t)width * height * 4;
+		case CookedTextureFormat::BC1:   return blocks * 8;
+		case CookedTextureFormat::BC3:   return blocks * 16;
+		}
+		XYZ_ASSERT(false, "Unknown cooked texture format");
+		return 0;
+	}
+
+	void TextureCooker::GenerateMip(const uint8_t* source, uint32_t width, uint32_t height, uint32_t channels, std::vector<uint8_t>& result)
+	{
+		uint32_t mipWidth = std::max(1u, width / 2);
+		uint32_t mipHeight = std::max(1u, height / 2);
+		result.resize((size_t)mipWidth * mipHeight * channels);
+		for (uint32_t y = 0; y < mipHeight; ++y)
+		{
+			uint32_t y0 = std::min(y * 2, height - 1);
+			uint32_t y1 = std::min(y * 2 + 1, height - 1);
+			for (uint32_t x = 0; x < mipWidth; ++x)
+			{
+				uint32_t x0 = std::min(x * 2, width - 1);
+				uint32_t x1 = std::min(x * 2 + 1, width - 1);
+				for (uint32_t c = 0; c < channels; ++c)
+				{
+					uint32_t sum = source[((size_t)y0 * width + x0) * channels + c]
+								 + source[((size_t)y0 * width + x1) * channels + c]
+								 + source[((size_t)y1 * width + x0) * channels + c]
+								 + source[((size_t)y1 * width + x1) * channels + c];
+					result[((size_t)y * mipWidth + x) * channels + c] = (uint8_t)((sum + 2) / 4);
+				}
+			}
+		}
+	}
+
+	void TextureCooker::CompressBC1(const uint8_t* source, uint32_t width, uint32_t height, uint32_t channels, uint8_t* result)
+	{
+		uint32_t blocksX = std::max(1u, (width + 3) / 4);
+		uint32_t blocksY = std::max(1u, (height + 3) / 4);
+		uint8_t block[16][4];
+		for (uint32_t by = 0; by < blocksY; ++by)
+		{
+			for (uint32_t bx = 0; bx < blocksX; ++bx)
+			{
+				FetchBlock(source, width, height, channels, bx, by, block);
+				EncodeColorBlock(block, result);
+				result += 8;
+			}
+		}
+	}
+
+	void TextureCooker::CompressBC3(const uint8_t* source, uint32_t width, uint32_t height, uint8_t* result)
+	{
+		uint32_t blocksX = std::max(1u, (width + 3) / 4);
+		uint32_t blocksY = std::max(1u, (height + 3) / 4);
+		uint8_t block[16][4];
+		for (uint32_t by = 0; by < blocksY; ++by)
+		{
+			for (uint32_t bx = 0; bx < blocksX; ++bx)
+			{
+				FetchBlock(source, width, height, 4, bx, by, block);
+				EncodeAlphaBlock(block, result);
+				EncodeColorBlock(block, result + 8);
+				result += 16;
+			}
+		}
+	}
+
+	bool TextureCooker::Cook(const uint8_t* pixels, uint32_t width, uint32_t height, uint32_t channels, const TextureCookSettings& settings, std::vector<uint8_t>& result)
+	{
+		if (!pixels || !width || !height)
+			return false;
+
+		CookedTextureFormat format;
+		switch (channels)
+		{
+		case 1: format = CookedTextureFormat::R8; break;
+		case 3: format = settings.Compress ? CookedTextureFormat::BC1 : CookedTextureFormat::RGB8; break;
+		case 4: format = settings.Compress ? CookedTextureFormat::BC3 : CookedTextureFormat::RGBA8; break;
+		default:
+			XYZ_LOG_ERR("Unsupported number of channels ", channels);
+			return false;
+		}
+
+		uint32_t mipCount = 1;
+		if (settings.GenerateMips)
+		{
+			while ((width | height) >> mipCount)
+				mipCount++;
+		}
+
+		std::vector<CookedTextureMip> mips(mipCount);
+		uint64_t offset = sizeof(CookedTextureHeader) + mipCount * sizeof(CookedTextureMip);
+		for (uint32_t level = 0; level < mipCount; ++level)
+		{
+			offset = (offset + sc_MipAlignment - 1) / sc_MipAlignment * sc_MipAlignment;
+			mips[level].Width = std::max(1u, width >> level);
+			mips[level].Height = std::max(1u, height >> level);
+			mips[level].Offset = offset;
+			mips[level].Size = GetMipSize(format, mips[level].Width, mips[level].Height);
+			offset += mips[level].Size;
+		}
+
+		result.assign((size_t)offset, 0);
+		CookedTextureHeader header = {};
+		header.Magic = sc_Magic;
+		header.Version = sc_Version;
+		header.Width = width;
+		header.Height = height;
+		header.Channels = channels;
+		header.Format = format;
+		header.MipCount = mipCount;
+		memcpy(result.data(), &header, sizeof(CookedTextureHeader));
+		memcpy(result.data() + sizeof(CookedTextureHeader), mips.data(), mipCount * sizeof(CookedTextureMip));
+
+		std::vector<uint8_t> current(pixels, pixels + (size_t)width * height * channels);
+		std::vector<uint8_t> next;
+		for (uint32_t level = 0; level < mipCount; ++level)
+		{
+			const CookedTextureMip& mip = mips[level];
+			uint8_t* destination = result.data() + mip.Offset;
+			if (format == CookedTextureFormat::BC1)
+				CompressBC1(current.data(), mip.Width, mip.Height, channels, destination);
+			else if (format == CookedTextureFormat::BC3)
+				CompressBC3(current.data(), mip.Width, mip.Height, destination);
+			else
+				memcpy(destination, current.data(), current.size());
+
+			if (level + 1 < mipCount)
+			{
+				GenerateMip(current.data(), mip.Width, mip.Height, channels, next);
+				std::swap(current, next);
+			}
+		}
+		return true;
+	}
+
+	bool TextureCooker::Cook(const std::string& sourcePath, const std::string& destinationPath, const TextureCookSettings& settings)
+	{
+		int width, height, channels;
+		stbi_set_flip_vertically_on_load(settings.FlipVertically ? 1 : 0);
+		uint8_t* pixels = stbi_load(sourcePath.c_str(), &width, &height, &channels, 0);
+		if (!pixels)
+		{
+			XYZ_LOG_ERR("Failed to load image ", sourcePath);
+			return false;
+		}
+
+		std::vector<uint8_t> cooked;
+		bool success = Cook(pixels, (uint32_t)width, (uint32_t)height, (uint32_t)channels, settings, cooked);
+		stbi_image_free(pixels);
+		if (!success)
+			return false;
+
+		std::ofstream out(destinationPath, std::ios::out | std::ios::binary | std::ios::trunc);
+		if (!out)
+		{
+			XYZ_LOG_ERR("Could not write cooked texture ", destinationPath);
+			return false;
+		}
+		out.write((const char*)cooked.data(), cooked.size());
+		return (bool)out;
+	}
+
+	uint32_t TextureCooker::CookDirectory(const std::string& directory, const TextureCookSettings& settings)
+	{
+		static const char* s_ImageExtensions[] = { "png", "jpg", "jpeg", "tga", "bmp" };
+
+		uint32_t count = 0;
+		for (auto& it : std::filesystem::recursive_directory_iterator(directory))
+		{
+			if (it.is_directory())
+				continue;
+
+			std::string path = it.path().string();
+			std::replace(path.begin(), path.end(), '\\', '/');
+			std::string extension = Utils::GetExtension(path);
+			std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+			bool isImage = std::find_if(std::begin(s_ImageExtensions), std::end(s_ImageExtensions), [&](const char* ext) {
+				return extension == ext;
+			}) != std::end(s_ImageExtensions);
+
+			if (!isImage || HasCookedTexture(path))
+				continue;
+
+			if (Cook(path, GetCookedPath(path), settings))
+				count++;
+		}
+		return count;
+	}
+
+	bool TextureCooker::Parse(const uint8_t* data, size_t size, CookedTextureView& view)
+	{
+		if (size < sizeof(CookedTextureHeader))
+			return false;
+
+		const CookedTextureHeader* header = (const CookedTextureHeader*)data;
+		if (header->Magic != sc_Magic || header->Version != sc_Version || header->MipCount == 0)
+			return false;
+		if (sizeof(CookedTextureHeader) + (size_t)header->MipCount * sizeof(CookedTextureMip) > size)
+			return false;
+
+		const CookedTextureMip* mips = (const CookedTextureMip*)(data + sizeof(CookedTextureHeader));
+		for (uint32_t level = 0; level < header->MipCount; ++level)
+		{
+			if (mips[level].Offset + mips[level].Size > size)
+				return false;
+		}
+		view.Header = header;
+		view.Mips = mips;
+		view.Data = data;
+		return true;
+	}
+
+	bool TextureCooker::HasCookedTexture(const std::string& sourcePath)
+	{
+		std::string cookedPath = GetCookedPath(sourcePath);
+		if (AssetManager::IsAssetPackMounted())
+			return AssetManager::FileExists(cookedPath);
+
+		std::error_code error;
+		auto cookedTime = std::filesystem::last_write_time(cookedPath, error);
+		if (error)
+			return false;
+		auto sourceTime = std::filesystem::last_write_time(sourcePath, error);
+		// Source might not be shipped at all
+		if (error)
+			return true;
+		return cookedTime >= sourceTime;
+	}
+}
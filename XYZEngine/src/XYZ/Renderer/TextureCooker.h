@@ -0,0 +1,79 @@
+#pragma once
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace XYZ {
+
+	enum class CookedTextureFormat : uint32_t
+	{
+		R8,
+		RGB8,
+		RGBA8,
+		BC1,	// RGB, 8 bytes per 4x4 block
+		BC3		// RGBA, 16 bytes per 4x4 block
+	};
+
+	// On disk layout: CookedTextureHeader, CookedTextureMip[MipCount], mip payloads
+	struct CookedTextureHeader
+	{
+		uint32_t Magic;
+		uint32_t Version;
+		uint32_t Width;
+		uint32_t Height;
+		uint32_t Channels;
+		CookedTextureFormat Format;
+		uint32_t MipCount;
+		uint32_t Reserved;
+	};
+
+	struct CookedTextureMip
+	{
+		uint32_t Width;
+		uint32_t Height;
+		uint64_t Offset;
+		uint64_t Size;
+	};
+
+	// Non owning view of a cooked texture stored in memory
+	struct CookedTextureView
+	{
+		const CookedTextureHeader* Header = nullptr;
+		const CookedTextureMip*	   Mips = nullptr;
+		const uint8_t*			   Data = nullptr;
+
+		const uint8_t* GetMipData(uint32_t level) const { return Data + Mips[level].Offset; }
+		bool IsCompressed() const { return Header->Format == CookedTextureFormat::BC1 || Header->Format == CookedTextureFormat::BC3; }
+	};
+
+	struct TextureCookSettings
+	{
+		bool GenerateMips = true;
+		bool Compress = true;
+		bool FlipVertically = true;
+	};
+
+	class TextureCooker
+	{
+	public:
+		static bool Cook(const std::string& sourcePath, const std::string& destinationPath, const TextureCookSettings& settings = TextureCookSettings());
+		static bool Cook(const uint8_t* pixels, uint32_t width, uint32_t height, uint32_t channels, const TextureCookSettings& settings, std::vector<uint8_t>& result);
+
+		// Cooks every image in directory that has no up to date cooked texture
+		static uint32_t CookDirectory(const std::string& directory, const TextureCookSettings& settings = TextureCookSettings());
+
+		static bool Parse(const uint8_t* data, size_t size, CookedTextureView& view);
+
+		// Cooked texture exists and is not older than its source
+		static bool HasCookedTexture(const std::string& sourcePath);
+		static std::string GetCookedPath(const std::string& sourcePath) { return sourcePath + ".xyztex"; }
+
+		static void GenerateMip(const uint8_t* source, uint32_t width, uint32_t height, uint32_t channels, std::vector<uint8_t>& result);
+		static void CompressBC1(const uint8_t* source, uint32_t width, uint32_t height, uint32_t channels, uint8_t* result);
+		static void CompressBC3(const uint8_t* source, uint32_t width, uint32_t height, uint8_t* result);
+		static size_t GetMipSize(CookedTextureFormat format, uint32_t width, uint32_t height);
+
+		static constexpr uint32_t sc_Magic = 0x58545A58; // "XZTX"
+		static constexpr uint32_t sc_Version = 1;
+	};
+}
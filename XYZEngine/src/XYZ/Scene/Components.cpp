@@ -78,6 +78,28 @@ namespace XYZ {
 		childRel.Depth = parentRel.Depth + 1;
 	}
 
+	void Relationship::SetupRelations(Entity parent, const Entity* children, size_t count, ECSManager& ecs)
+	{
+		if (count == 0)
+			return;
+
+		auto& storage = ecs.GetStorage<Relationship>();
+		auto& parentRel = storage.GetComponent(parent);
+		const Entity oldFirstChild = parentRel.FirstChild;
+		for (size_t i = 0; i < count; ++i)
+		{
+			auto& childRel = storage.GetComponent(children[i]);
+			XYZ_ASSERT(!childRel.Parent, "Child already has parent");
+			childRel.Parent = parent;
+			childRel.PreviousSibling = i > 0 ? children[i - 1] : Entity();
+			childRel.NextSibling = i + 1 < count ? children[i + 1] : oldFirstChild;
+			childRel.Depth = parentRel.Depth + 1;
+		}
+		if (oldFirstChild)
+			storage.GetComponent(oldFirstChild).PreviousSibling = children[count - 1];
+		parentRel.FirstChild = children[0];
+	}
+
 	void Relationship::RemoveRelation(Entity child, ECSManager& ecs)
 	{
 		removeRelation(child, ecs);
@@ -121,6 +143,18 @@ namespace XYZ {
 	}
 	glm::mat4 TransformComponent::GetTransform() const
 	{
+		if (Rotation.x == 0.0f && Rotation.y == 0.0f)
+		{
+			// Rotation around z only, matrix is built directly without quaternion
+			const float c = std::cos(Rotation.z);
+			const float s = std::sin(Rotation.z);
+			glm::mat4 result(1.0f);
+			result[0] = glm::vec4(c * Scale.x, s * Scale.x, 0.0f, 0.0f);
+			result[1] = glm::vec4(-s * Scale.y, c * Scale.y, 0.0f, 0.0f);
+			result[2] = glm::vec4(0.0f, 0.0f, Scale.z, 0.0f);
+			result[3] = glm::vec4(Translation, 1.0f);
+			return result;
+		}
 		glm::mat4 rotation = glm::toMat4(glm::quat(Rotation));
 		return glm::translate(glm::mat4(1.0f), Translation)
 			* rotation
@@ -135,5 +169,23 @@ namespace XYZ {
 		glm::decompose(transform, Scale, rotation, Translation, skew, perspective);
 		Rotation = glm::eulerAngles(rotation);
 	}
+
+	glm::mat4 WorldTransform2D::ToMat4() const
+	{
+		glm::mat4 result(1.0f);
+		result[0] = glm::vec4(AxisX, 0.0f, 0.0f);
+		result[1] = glm::vec4(AxisY, 0.0f, 0.0f);
+		result[3] = glm::vec4(Translation, 1.0f);
+		return result;
+	}
+
+	WorldTransform2D WorldTransform2D::FromMat4(const glm::mat4& transform)
+	{
+		WorldTransform2D result;
+		result.AxisX = glm::vec2(transform[0]);
+		result.AxisY = glm::vec2(transform[1]);
+		result.Translation = glm::vec3(transform[3]);
+		return result;
+	}
 	
 }
\ No newline at end of file
@@ -25,7 +25,7 @@ namespace XYZ {
 		{}
 		bool operator==(const IDComponent& other) const
 		{
-			return (std::string)ID == (std::string)other.ID;
+			return ID == other.ID;
 		}
 
 		GUID ID;
@@ -51,6 +51,23 @@ namespace XYZ {
 		void DecomposeTransform(const glm::mat4& transform);
 	};
 
+	// Compact world transform for 2D, written together with WorldTransform by hierarchy update.
+	// Stored separately, systems reading only world positions and bounds do not stream whole TransformComponent
+	struct WorldTransform2D
+	{
+		glm::vec2 AxisX = glm::vec2(1.0f, 0.0f);
+		glm::vec2 AxisY = glm::vec2(0.0f, 1.0f);
+		glm::vec3 Translation = glm::vec3(0.0f);
+
+		glm::vec2 TransformPoint(const glm::vec2& point) const
+		{
+			return AxisX * point.x + AxisY * point.y + glm::vec2(Translation);
+		}
+		glm::mat4 ToMat4() const;
+
+		static WorldTransform2D FromMat4(const glm::mat4& transform);
+	};
+
 	struct SceneTagComponent 
 	{
 		std::string Name;
@@ -110,6 +127,8 @@ namespace XYZ {
 	{
 		AnimatorComponent() = default;
 		Ref<Animation> Animation;
+		// Key lookup hints of clip channels used by AnimationEvaluator, animation must be created for entity of the animator
+		std::vector<uint32_t> Cursors;
 	};
 
 
@@ -158,6 +177,8 @@ namespace XYZ {
 		uint32_t GetDepth() const { return Depth; }
 
 		static void SetupRelation(Entity parent, Entity child, ECSManager& ecs);
+		// Links children without parent in front of the children of parent, in the given order
+		static void SetupRelations(Entity parent, const Entity* children, size_t count, ECSManager& ecs);
 		static void RemoveRelation(Entity child, ECSManager& ecs);
 
 	private:
@@ -34,11 +34,16 @@ namespace XYZ {
 		m_ViewportHeight(0)
 	{
 		m_ECS.CreateStorage<ScriptComponent>();
+		m_ECS.AddListener<IDComponent>(std::bind(&Scene::onIDComponentChange, this, std::placeholders::_1, std::placeholders::_2), this);
+		m_ECS.AddListener<SceneTagComponent>(std::bind(&Scene::onSceneTagComponentChange, this, std::placeholders::_1, std::placeholders::_2), this);
+		m_SpatialIndex.Attach(m_ECS);
+		m_PhysicsBridge.Attach(m_ECS);
 		m_SceneEntity = m_ECS.CreateEntity();
 
 		m_ECS.EmplaceComponent<Relationship>(m_SceneEntity);
 		m_ECS.EmplaceComponent<IDComponent>(m_SceneEntity);
 		m_ECS.EmplaceComponent<TransformComponent>(m_SceneEntity);
+		m_ECS.EmplaceComponent<WorldTransform2D>(m_SceneEntity);
 		m_ECS.EmplaceComponent<SceneTagComponent>(m_SceneEntity, name);	
 
 
@@ -47,6 +52,8 @@ namespace XYZ {
 
 	Scene::~Scene()
 	{
+		m_SpatialIndex.Detach(m_ECS);
+		m_PhysicsBridge.Detach(m_ECS);
 	}
 
 	SceneEntity Scene::CreateEntity(const std::string& name, const GUID& guid)
@@ -60,10 +67,11 @@ namespace XYZ {
 		entity.EmplaceComponent<Relationship>(m_SceneEntity);
 		entity.EmplaceComponent<SceneTagComponent>(name);
 		entity.EmplaceComponent<TransformComponent>(glm::vec3(0.0f, 0.0f, 0.0f));
+		entity.EmplaceComponent<WorldTransform2D>();
 		auto& sceneRelation = m_ECS.GetComponent<Relationship>(m_SceneEntity);
 		Relationship::SetupRelation(m_SceneEntity, id, m_ECS);
 
-		m_Entities.push_back(id);
+		addEntity(id);
 		return entity;
 	}
 
@@ -79,32 +87,61 @@ namespace XYZ {
 		entity.EmplaceComponent<Relationship>((Entity)entity.m_ID);
 		entity.EmplaceComponent<SceneTagComponent>(name);
 		entity.EmplaceComponent<TransformComponent>(glm::vec3(0.0f, 0.0f, 0.0f));
+		entity.EmplaceComponent<WorldTransform2D>();
 		auto& sceneRelation = m_ECS.GetComponent<Relationship>(m_SceneEntity);
 		Relationship::SetupRelation(m_SceneEntity, id, m_ECS);
 
-		m_Entities.push_back(id);
+		addEntity(id);
 		return entity;
 	}
 
 	void Scene::DestroyEntity(SceneEntity entity)
 	{
-		Entity lastEntity = m_Entities.back();
 		if (entity.m_ID == m_SelectedEntity)
 			m_SelectedEntity = Entity();
 		
-		for (auto it = m_Entities.begin(); it != m_Entities.end(); ++it)
-		{
-			if ((*it) == entity.m_ID)
-			{
-				*it = std::move(m_Entities.back());
-				m_Entities.pop_back();
-				break;
-			}
-		}
+		removeEntity(entity.m_ID);
 		Relationship::RemoveRelation(entity.m_ID, m_ECS);
 		m_ECS.DestroyEntity(Entity(entity.m_ID));
 	}
 
+	void Scene::CreateEntities(const std::string& name, uint32_t count, std::vector<SceneEntity>& result)
+	{
+		std::vector<Entity> entities;
+		m_ECS.CreateEntities<IDComponent, Relationship, SceneTagComponent, TransformComponent, WorldTransform2D>(count, entities);
+
+		// Default IDComponent generates new GUID for every entity
+		m_ECS.EmplaceComponents<IDComponent>(entities.data(), entities.size());
+		m_ECS.EmplaceComponents<Relationship>(entities.data(), entities.size());
+		m_ECS.EmplaceComponents<SceneTagComponent>(entities.data(), entities.size(), name);
+		m_ECS.EmplaceComponents<TransformComponent>(entities.data(), entities.size(), glm::vec3(0.0f, 0.0f, 0.0f));
+		m_ECS.EmplaceComponents<WorldTransform2D>(entities.data(), entities.size());
+		Relationship::SetupRelations(m_SceneEntity, entities.data(), entities.size(), m_ECS);
+		addEntities(entities.data(), entities.size());
+
+		result.reserve(result.size() + count);
+		for (Entity id : entities)
+			result.push_back({ id, this });
+	}
+
+	void Scene::DestroyEntities(const SceneEntity* entities, size_t count)
+	{
+		std::vector<Entity> ids;
+		ids.reserve(count);
+		for (size_t i = 0; i < count; ++i)
+		{
+			XYZ_ASSERT(entities[i].m_Scene == this, "Entity does not belong to the scene");
+			const Entity id = entities[i].m_ID;
+			if (id == m_SelectedEntity)
+				m_SelectedEntity = Entity();
+
+			removeEntity(id);
+			Relationship::RemoveRelation(id, m_ECS);
+			ids.push_back(id);
+		}
+		m_ECS.DestroyEntities(ids.data(), ids.size());
+	}
+
 	void Scene::OnPlay()
 	{
 		s_EditTransforms.clear();
@@ -153,11 +190,8 @@ namespace XYZ {
 			ent.GetComponent<TransformComponent>() = s_EditTransforms[(uint32_t)entity];
 		}
 
-		auto& rigidStorage = m_ECS.GetStorage<RigidBody2DComponent>();
-		for (auto& body : rigidStorage)
-		{
-			m_PhysicsWorld.DestroyBody(static_cast<b2Body*>(body.RuntimeBody));
-		}
+		m_PhysicsBridge.DestroyBodies();
+		m_ContactListener.Clear();
 
 		auto& scriptStorage = m_ECS.GetStorage<ScriptComponent>();
 		for (size_t i = 0; i < scriptStorage.Size(); ++i)
@@ -187,12 +221,7 @@ namespace XYZ {
 		SceneRenderer::GetOptions().ShowGrid = false;
 		SceneRenderer::BeginScene(this, renderCamera);
 
-		auto renderView = m_ECS.CreateView<TransformComponent, SpriteRenderer>();
-		for (auto entity : renderView)
-		{
-			auto [transform, renderer] = renderView.Get<TransformComponent, SpriteRenderer>(entity);
-			SceneRenderer::SubmitSprite(&renderer, &transform);
-		}
+		submitVisible(renderCamera.Camera.GetProjectionMatrix() * renderCamera.ViewMatrix, false);
 
 		auto particleView = m_ECS.CreateView<TransformComponent, ParticleComponentGPU>();
 		for (auto entity : particleView)
@@ -207,54 +236,27 @@ namespace XYZ {
 			auto [transform, particle] = particleViewCPU.Get<TransformComponent, ParticleComponentCPU>(entity);
 			SceneRenderer::SubmitRendererCommand(&particle.System->GetRenderer(), &transform);
 		}
-		
-		auto lightView = m_ECS.CreateView<TransformComponent, PointLight2D>();
-		for (auto entity : lightView)
-		{
-			auto [transform, light] = lightView.Get<TransformComponent, PointLight2D>(entity);
-			SceneRenderer::SubmitLight(&light, transform.WorldTransform);
-		}
-		auto spotLightView = m_ECS.CreateView<TransformComponent, SpotLight2D>();
-		for (auto entity : spotLightView)
-		{
-			auto [transform, light] = spotLightView.Get<TransformComponent, SpotLight2D>(entity);
-			SceneRenderer::SubmitLight(&light, transform.WorldTransform);
-		}
 
 		SceneRenderer::EndScene();
 	}
 
 	void Scene::OnUpdate(Timestep ts)
 	{
-		int32_t velocityIterations = 6;
-		int32_t positionIterations = 2;
-		m_PhysicsWorld.Step(ts, velocityIterations, positionIterations);
-
-		m_ECS.CreateStorage<RigidBody2DComponent>();
-		auto rigidView = m_ECS.CreateView<TransformComponent, RigidBody2DComponent>();
-		for (auto entity : rigidView)
-		{
-			auto [transform, rigidBody] = rigidView.Get<TransformComponent, RigidBody2DComponent>(entity);
-			b2Body* body = static_cast<b2Body*>(rigidBody.RuntimeBody);
-			transform.Translation.x = body->GetPosition().x;
-			transform.Translation.y = body->GetPosition().y;
-			transform.Rotation.z = body->GetAngle();
-		}
-
-		auto& scriptStorage = m_ECS.GetStorage<ScriptComponent>();
-		for (size_t i = 0; i < scriptStorage.Size(); ++i)
-		{
-			ScriptComponent& scriptComponent = scriptStorage[i];
-			if (!scriptComponent.ModuleName.empty())
-				ScriptEngine::OnUpdateEntity({ scriptStorage.GetEntityAtIndex(i),this }, ts);
-		}
+		ThreadPool& pool = Application::GetThreadPool();
+		const bool asyncPhysics = m_PhysicsBridge.GetSettings().Asynchronous;
+		// Sync point of physics started at the end of previous update
+		m_PhysicsBridge.WaitStep();
+		if (!asyncPhysics)
+			m_PhysicsBridge.Step(m_PhysicsWorld, ts, &pool);
+		m_PhysicsBridge.SyncTransforms(m_ECS, &pool);
+		m_ContactListener.Flush();
+		ScriptEngine::OnContacts(m_ContactListener);
+
+		ScriptEngine::OnUpdate(ts);
 		
 		m_ECS.CreateStorage<AnimatorComponent>();
 		auto& animatorStorage = m_ECS.GetStorage<AnimatorComponent>();
-		for (auto & anim : animatorStorage)
-		{
-			anim.Animation->Update(ts);
-		}
+		m_AnimationEvaluator.Update(animatorStorage, ts, &Application::GetThreadPool());
 		
 		auto particleViewCPU = m_ECS.CreateView<TransformComponent, ParticleComponentCPU>();
 		for (auto entity : particleViewCPU)
@@ -279,6 +281,10 @@ namespace XYZ {
 		}
 		
 		updateHierarchy();
+
+		// Physics of next frame runs while this frame is rendered
+		if (asyncPhysics)
+			m_PhysicsBridge.BeginStep(m_PhysicsWorld, ts, pool);
 	}
 
 	void Scene::OnRenderEditor(const Editor::EditorCamera& camera, Timestep ts)
@@ -286,13 +292,8 @@ namespace XYZ {
 		updateHierarchy();
 		SceneRenderer::BeginScene(this, camera.GetViewProjection(), camera.GetPosition());
 		
-		auto renderView = m_ECS.CreateView<TransformComponent, SpriteRenderer>();
-		for (auto entity : renderView)
-		{
-			auto [transform, renderer] = renderView.Get<TransformComponent, SpriteRenderer>(entity);
-			if (renderer.Visible && renderer.SubTexture.Raw() && renderer.Material.Raw())
-				SceneRenderer::SubmitSprite(&renderer, &transform);
-		}
+		submitVisible(camera.GetViewProjection(), true);
+
 		auto editorRenderView = m_ECS.CreateView<TransformComponent, EditorSpriteRenderer>();
 		for (auto entity : editorRenderView)
 		{
@@ -314,20 +315,6 @@ namespace XYZ {
 			particle.System->Update(ts);
 			SceneRenderer::SubmitRendererCommand(&particle.System->GetRenderer(), &transform);
 		}
-		
-		auto lightView = m_ECS.CreateView<TransformComponent, PointLight2D>();
-		for (auto entity : lightView)
-		{
-			auto [transform, light] = lightView.Get<TransformComponent, PointLight2D>(entity);
-			SceneRenderer::SubmitLight(&light, transform.WorldTransform);
-		}	
-
-		auto spotLightView = m_ECS.CreateView<TransformComponent, SpotLight2D>();
-		for (auto entity : spotLightView)
-		{
-			auto [transform, light] = spotLightView.Get<TransformComponent, SpotLight2D>(entity);
-			SceneRenderer::SubmitLight(&light, transform.WorldTransform);
-		}
 
 		if (m_SelectedEntity)
 		{
@@ -359,6 +346,48 @@ namespace XYZ {
 		SceneRenderer::EndScene();
 	}
 
+	void Scene::RayCast(const Ray& ray, std::vector<Entity>& result)
+	{
+		// Only proxies of entities moved since the last pick are refreshed
+		m_SpatialIndex.Update(m_ECS, { SpatialProxyType::Pickable });
+		m_SpatialIndex.RayCast(SpatialProxyType::Pickable, ray, m_RayCastHits);
+
+		struct Pick
+		{
+			Entity	ID;
+			float	Distance;
+			int64_t SortLayer;
+		};
+		std::vector<Pick> picks;
+		picks.reserve(m_RayCastHits.size());
+		for (const RayCastHit& hit : m_RayCastHits)
+		{
+			Entity entity(hit.DataIndex);
+			if (entity == m_SceneEntity)
+				continue;
+
+			int64_t sortLayer = -1;
+			if (m_ECS.Contains<SpriteRenderer>(entity))
+				sortLayer = m_ECS.GetComponent<SpriteRenderer>(entity).SortLayer;
+			picks.push_back({ entity, hit.Distance, sortLayer });
+		}
+		std::sort(picks.begin(), picks.end(), [](const Pick& a, const Pick& b) {
+			if (a.Distance != b.Distance)
+				return a.Distance < b.Distance;
+			return a.SortLayer > b.SortLayer;
+		});
+
+		result.clear();
+		for (const Pick& pick : picks)
+			result.push_back(pick.ID);
+	}
+
+	bool Scene::GetPickBounds(Entity entity, AABB& result)
+	{
+		m_SpatialIndex.Update(m_ECS, { SpatialProxyType::Pickable });
+		return m_SpatialIndex.GetBounds(SpatialProxyType::Pickable, entity, result);
+	}
+
 	void Scene::SetViewportSize(uint32_t width, uint32_t height)
 	{
 		m_ViewportWidth = width;
@@ -371,7 +400,29 @@ namespace XYZ {
 	}
 	SceneEntity Scene::GetEntityByName(const std::string& name)
 	{
-		return { m_ECS.FindEntity<SceneTagComponent>(name), this };
+		auto it = m_EntityNameMap.find(name);
+		if (it != m_EntityNameMap.end())
+			return { it->second.front(), this };
+		return { Entity(), this };
+	}
+
+	void Scene::SetEntityName(Entity entity, const std::string& name)
+	{
+		SceneTagComponent& tag = m_ECS.GetComponent<SceneTagComponent>(entity);
+		if (tag.Name == name)
+			return;
+
+		removeEntityName(entity);
+		tag.Name = name;
+		addEntityName(entity, name);
+	}
+
+	SceneEntity Scene::GetEntityByGUID(const GUID& guid)
+	{
+		auto it = m_EntityGUIDMap.find(guid);
+		if (it != m_EntityGUIDMap.end())
+			return { it->second, this };
+		return { Entity(), this };
 	}
 
 	SceneEntity Scene::GetSelectedEntity()
@@ -380,6 +431,88 @@ namespace XYZ {
 	}
 
 
+	void Scene::onIDComponentChange(uint32_t entity, CallbackType type)
+	{
+		if (type == CallbackType::ComponentCreate)
+		{
+			const GUID& guid = m_ECS.GetComponent<IDComponent>(entity).ID;
+			m_EntityGUIDMap[guid] = entity;
+			m_EntityGUIDs[entity] = guid;
+		}
+		else
+		{
+			// Entity destroy is reported to listeners of every component type
+			auto it = m_EntityGUIDs.find(entity);
+			if (it != m_EntityGUIDs.end())
+			{
+				m_EntityGUIDMap.erase(it->second);
+				m_EntityGUIDs.erase(it);
+			}
+		}
+	}
+
+	void Scene::onSceneTagComponentChange(uint32_t entity, CallbackType type)
+	{
+		if (type == CallbackType::ComponentCreate)
+			addEntityName(entity, m_ECS.GetComponent<SceneTagComponent>(entity).Name);
+		else
+			removeEntityName(entity);
+	}
+
+	void Scene::addEntityName(Entity entity, const std::string& name)
+	{
+		m_EntityNameMap[name].push_back(entity);
+		m_EntityNames[entity] = name;
+	}
+
+	void Scene::removeEntityName(uint32_t entity)
+	{
+		auto it = m_EntityNames.find(entity);
+		if (it == m_EntityNames.end())
+			return;
+
+		auto nameIt = m_EntityNameMap.find(it->second);
+		std::vector<Entity>& entities = nameIt->second;
+		entities.erase(std::find(entities.begin(), entities.end(), Entity(entity)));
+		if (entities.empty())
+			m_EntityNameMap.erase(nameIt);
+		m_EntityNames.erase(it);
+	}
+
+	void Scene::submitVisible(const glm::mat4& viewProjection, bool editor)
+	{
+		const std::initializer_list<SpatialProxyType> types = {
+			SpatialProxyType::Sprite, SpatialProxyType::PointLight, SpatialProxyType::SpotLight
+		};
+		m_SpatialIndex.Update(m_ECS, types);
+		m_SpatialIndex.Query(SceneSpatialIndex::CameraAABB(viewProjection), m_VisibleEntities, types);
+
+		// Tree order depends on insertion history, storage order keeps submission of sprites
+		// with equal sort keys stable between frames
+		auto& sprites = m_VisibleEntities.Get(SpatialProxyType::Sprite);
+		std::sort(sprites.begin(), sprites.end(), [this](Entity a, Entity b) {
+			return m_ECS.GetComponentIndex<SpriteRenderer>(a) < m_ECS.GetComponentIndex<SpriteRenderer>(b);
+		});
+
+		for (Entity entity : m_VisibleEntities.Get(SpatialProxyType::Sprite))
+		{
+			auto& transform = m_ECS.GetComponent<TransformComponent>(entity);
+			auto& renderer = m_ECS.GetComponent<SpriteRenderer>(entity);
+			if (!editor || (renderer.Visible && renderer.SubTexture.Raw() && renderer.Material.Raw()))
+				SceneRenderer::SubmitSprite(&renderer, &transform);
+		}
+		for (Entity entity : m_VisibleEntities.Get(SpatialProxyType::PointLight))
+		{
+			const auto& transform = m_ECS.GetComponent<WorldTransform2D>(entity);
+			SceneRenderer::SubmitLight(&m_ECS.GetComponent<PointLight2D>(entity), glm::vec2(transform.Translation));
+		}
+		for (Entity entity : m_VisibleEntities.Get(SpatialProxyType::SpotLight))
+		{
+			const auto& transform = m_ECS.GetComponent<WorldTransform2D>(entity);
+			SceneRenderer::SubmitLight(&m_ECS.GetComponent<SpotLight2D>(entity), glm::vec2(transform.Translation));
+		}
+	}
+
 	void Scene::updateHierarchy()
 	{
 		std::stack<Entity> entities;
@@ -405,98 +538,60 @@ namespace XYZ {
 			{
 				transform.WorldTransform = transform.GetTransform();
 			}
+			WorldTransform2D& worldTransform = m_ECS.GetComponent<WorldTransform2D>(tmp);
+			const WorldTransform2D newWorldTransform = WorldTransform2D::FromMat4(transform.WorldTransform);
+			// Only moved entities update their spatial proxies
+			if (memcmp(&worldTransform, &newWorldTransform, sizeof(WorldTransform2D)) != 0)
+			{
+				worldTransform = newWorldTransform;
+				m_SpatialIndex.MarkDirty(tmp);
+			}
 		}
 	}
 
-	void Scene::setupPhysics()
+	void Scene::addEntity(Entity entity)
 	{
-		auto& storage = m_ECS.GetStorage<RigidBody2DComponent>();
-		m_PhysicsEntityBuffer = new SceneEntity[storage.Size()];
+		if (m_EntityIndices.size() <= (uint32_t)entity)
+			m_EntityIndices.resize((size_t)entity + 1);
+		m_EntityIndices[entity] = (uint32_t)m_Entities.size();
+		m_Entities.push_back(entity);
+	}
 
-		size_t counter = 0;
-		for (auto& rigidBody : storage)
+	void Scene::addEntities(const Entity* entities, size_t count)
+	{
+		uint32_t highest = 0;
+		for (size_t i = 0; i < count; ++i)
+			highest = std::max(highest, (uint32_t)entities[i]);
+		if (m_EntityIndices.size() <= highest)
+			m_EntityIndices.resize((size_t)highest + 1);
+
+		m_Entities.reserve(m_Entities.size() + count);
+		for (size_t i = 0; i < count; ++i)
 		{
-			SceneEntity entity(storage.GetEntityAtIndex(counter), this);
-			const TransformComponent& transform = entity.GetComponent<TransformComponent>();
-			auto [translation, rotation, scale] = transform.GetWorldComponents();
-
-			b2BodyDef bodyDef;
-		
-			if (rigidBody.Type == RigidBody2DComponent::BodyType::Dynamic)
-				bodyDef.type = b2_dynamicBody;
-			else if (rigidBody.Type == RigidBody2DComponent::BodyType::Static)
-				bodyDef.type = b2_staticBody;
-			else if (rigidBody.Type == RigidBody2DComponent::BodyType::Kinematic)
-				bodyDef.type = b2_kinematicBody;
-			
-			
-			bodyDef.position.Set(transform.Translation.x, transform.Translation.y);
-			bodyDef.angle = transform.Rotation.z;
-			bodyDef.userData.pointer = reinterpret_cast<uintptr_t>(&m_PhysicsEntityBuffer[counter]);
-			
-			b2Body* body = m_PhysicsWorld.CreateBody(&bodyDef);
-			rigidBody.RuntimeBody = body;
-			
-			if (entity.HasComponent<BoxCollider2DComponent>())
-			{
-				BoxCollider2DComponent& boxCollider = entity.GetComponent<BoxCollider2DComponent>();
-				b2PolygonShape poly;
-			
-				poly.SetAsBox( boxCollider.Size.x / 2.0f, boxCollider.Size.y / 2.0f, 
-					   b2Vec2{ boxCollider.Offset.x, boxCollider.Offset.y }, 0.0f);
-				b2FixtureDef fixture;
-				fixture.shape = &poly;
-				fixture.density = boxCollider.Density;
-				fixture.friction = boxCollider.Friction;
-				boxCollider.RuntimeFixture = body->CreateFixture(&fixture);
-			}
-			else if (entity.HasComponent<CircleCollider2DComponent>())
-			{
-				CircleCollider2DComponent& circleCollider = entity.GetComponent<CircleCollider2DComponent>();
-				b2CircleShape circle;
-				circle.m_radius = circleCollider.Radius;
-				circle.m_p = b2Vec2(circleCollider.Offset.x, circleCollider.Offset.y);
-
-				b2FixtureDef fixture;
-				fixture.shape = &circle;
-				fixture.density  = circleCollider.Density;
-				fixture.friction = circleCollider.Friction;
-				circleCollider.RuntimeFixture = body->CreateFixture(&fixture);
-			}
-			else if (entity.HasComponent<PolygonCollider2DComponent>())
-			{
-				PolygonCollider2DComponent& meshCollider = entity.GetComponent<PolygonCollider2DComponent>();
-				b2PolygonShape poly;
-				poly.Set((const b2Vec2*)meshCollider.Vertices.data(), (int32_t)meshCollider.Vertices.size());
-				b2FixtureDef fixture;
-				fixture.shape = &poly;
-				fixture.density =  meshCollider.Density;
-				fixture.friction = meshCollider.Friction;
-				meshCollider.RuntimeFixture = body->CreateFixture(&fixture);
-			}
-			else if (entity.HasComponent<ChainCollider2DComponent>())
-			{
-				ChainCollider2DComponent& chainCollider = entity.GetComponent<ChainCollider2DComponent>();
-				
-				b2ChainShape chain;
-				chain.CreateChain((const b2Vec2*)chainCollider.Points.data(), (int32_t)chainCollider.Points.size(),
-					{ chainCollider.Points[0].x, chainCollider.Points[0].y },
-					{ chainCollider.Points.back().x, chainCollider.Points.back().y });
-				b2FixtureDef fixture;
-				fixture.shape = &chain;
-				fixture.density  = chainCollider.Density;
-				fixture.friction = chainCollider.Friction;
-				chainCollider.RuntimeFixture = body->CreateFixture(&fixture);
-			}
-			counter++;
+			m_EntityIndices[entities[i]] = (uint32_t)m_Entities.size();
+			m_Entities.push_back(entities[i]);
 		}
+	}
 
-		auto& boxStorage = m_ECS.GetStorage<BoxCollider2DComponent>();
-		counter = 0;
-		for (auto& box : boxStorage)
-		{
-			
-		}
+	void Scene::removeEntity(Entity entity)
+	{
+		const uint32_t index = m_EntityIndices[entity];
+		const Entity last = m_Entities.back();
+		m_Entities[index] = last;
+		m_EntityIndices[last] = index;
+		m_Entities.pop_back();
+	}
+
+	void Scene::setupPhysics()
+	{
+		m_ContactListener.Clear();
+		m_ECS.CreateStorage<RigidBody2DComponent>();
+		auto& storage = m_ECS.GetStorage<RigidBody2DComponent>();
+		m_PhysicsEntityBuffer = new SceneEntity[storage.Size()];
+		for (size_t i = 0; i < storage.Size(); ++i)
+			m_PhysicsEntityBuffer[i] = SceneEntity(storage.GetEntityAtIndex(i), this);
+
+		m_PhysicsBridge.CreateBodies(m_PhysicsWorld, m_ECS, m_PhysicsEntityBuffer);
 	}
 
 }
\ No newline at end of file
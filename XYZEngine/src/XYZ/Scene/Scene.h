@@ -6,9 +6,12 @@
 #include "XYZ/Event/Event.h"
 #include "XYZ/Renderer/Camera.h"
 #include "XYZ/Physics/ContactListener.h"
+#include "XYZ/Physics/PhysicsBridge.h"
+#include "XYZ/Animation/AnimationEvaluator.h"
 
 #include "XYZ/Editor/EditorCamera.h"
 #include "SceneCamera.h"
+#include "SceneSpatialIndex.h"
 
 
 #include "XYZ/Asset/Asset.h"
@@ -38,9 +41,16 @@ namespace XYZ {
         SceneEntity CreateEntity(const std::string& name, const GUID& guid);
         SceneEntity CreateEntity(const std::string& name, SceneEntity parent, const GUID& guid);
         void DestroyEntity(SceneEntity entity);
+        // Appends entities created under the scene entity to the result.
+        // Components are appended storage by storage and linked to the scene entity at once
+        void CreateEntities(const std::string& name, uint32_t count, std::vector<SceneEntity>& result);
+        // Components are removed storage by storage, unlinking and removal from entity list stay per entity
+        void DestroyEntities(const SceneEntity* entities, size_t count);
         void SetState(SceneState state) { m_State = state; }
         void SetViewportSize(uint32_t width, uint32_t height);
         void SetSelectedEntity(Entity entity) { m_SelectedEntity = entity; }
+        // Renames entity, name of SceneTagComponent must not be changed directly
+        void SetEntityName(Entity entity, const std::string& name);
 
         void OnPlay();
         void OnStop();
@@ -48,10 +58,19 @@ namespace XYZ {
         void OnRender();
         void OnRenderEditor(const Editor::EditorCamera& camera, Timestep ts);
 
+        // Entities hit by the ray, the closest first, sprites of higher sort layer first at equal distance
+        void RayCast(const Ray& ray, std::vector<Entity>& result);
+        // Bounds of the entity changed without change of its transform, for example light radius
+        void MarkBoundsDirty(Entity entity) { m_SpatialIndex.MarkDirty(entity); }
+        // Bounds tested by RayCast, false if the entity is not pickable
+        bool GetPickBounds(Entity entity, AABB& result);
+
         SceneEntity GetEntity(uint32_t index);
         SceneEntity GetEntityByName(const std::string& name);
+        SceneEntity GetEntityByGUID(const GUID& guid);
         SceneEntity GetSelectedEntity();
         ECSManager& GetECS() {return m_ECS;}
+        PhysicsSettings& GetPhysicsSettings() { return m_PhysicsBridge.GetSettings(); }
         inline const std::vector<Entity>& GetEntities() const { return m_Entities; }
 
         inline SceneState GetState() const { return m_State; }
@@ -61,17 +80,42 @@ namespace XYZ {
 
     private:
         void updateHierarchy();
+        void addEntity(Entity entity);
+        void addEntities(const Entity* entities, size_t count);
+        void removeEntity(Entity entity);
         void setupPhysics();
+        void onIDComponentChange(uint32_t entity, CallbackType type);
+        void onSceneTagComponentChange(uint32_t entity, CallbackType type);
+        void addEntityName(Entity entity, const std::string& name);
+        void removeEntityName(uint32_t entity);
+        void submitVisible(const glm::mat4& viewProjection, bool editor);
 
     private:
         b2World         m_PhysicsWorld;
         ContactListener m_ContactListener;
         SceneEntity*    m_PhysicsEntityBuffer;
+        PhysicsBridge   m_PhysicsBridge;
 
         ECSManager  m_ECS;
         GUID        m_UUID;
         Entity      m_SceneEntity;
         std::vector<Entity> m_Entities;
+        // Index of the entity in m_Entities
+        std::vector<uint32_t> m_EntityIndices;
+
+        AnimationEvaluator m_AnimationEvaluator;
+
+        // Only renderables intersecting camera bounds are submitted
+        SceneSpatialIndex  m_SpatialIndex;
+        SpatialQueryResult m_VisibleEntities;
+        std::vector<RayCastHit> m_RayCastHits;
+
+        // Maintained by IDComponent callbacks
+        std::unordered_map<GUID, Entity> m_EntityGUIDMap;
+        std::unordered_map<uint32_t, GUID> m_EntityGUIDs;
+        // Maintained by SceneTagComponent callbacks and SetEntityName, entities sharing name are in creation order
+        std::unordered_map<std::string, std::vector<Entity>> m_EntityNameMap;
+        std::unordered_map<uint32_t, std::string> m_EntityNames;
 
         std::string m_Name;
         SceneState  m_State;
@@ -65,6 +65,8 @@ namespace XYZ {
 			m_Scene->DestroyEntity(*this);
 		}
 
+		Scene* GetScene() const { return m_Scene; }
+
 		bool IsValid() const
 		{
 			return m_Scene && m_ID && m_Scene->m_ECS.IsValid(m_ID);
@@ -5,6 +5,7 @@
 #include "XYZ/Scene/Components.h"
 #include "XYZ/Asset/AssetManager.h"
 #include "XYZ/Script/ScriptEngine.h"
+#include "XYZ/Animation/Animation.h"
 
 #define GLM_ENABLE_EXPERIMENTAL
 #include <glm/gtx/quaternion.hpp>
@@ -207,6 +208,16 @@ namespace XYZ {
 		out << YAML::EndMap; // Script Component
 	}
 
+	template <>
+	void SceneSerializer::serialize<AnimatorComponent>(YAML::Emitter& out, const AnimatorComponent& val)
+	{
+		out << YAML::Key << "AnimatorComponent";
+		out << YAML::BeginMap;
+		out << YAML::Key << "ClipPath" << YAML::Value << val.Animation->GetClipPath();
+		out << YAML::Key << "Repeat" << YAML::Value << val.Animation->IsRepeating();
+		out << YAML::EndMap; // AnimatorComponent
+	}
+
 	template<>
 	void SceneSerializer::serialize<SceneEntity>(YAML::Emitter& out, const SceneEntity& val)
 	{
@@ -261,6 +272,13 @@ namespace XYZ {
 		{
 			serialize<SpotLight2D>(out, val.GetComponent<SpotLight2D>());
 		}
+		if (val.HasComponent<AnimatorComponent>())
+		{
+			// Keys of tracks are not serialized, only baked clips are stored
+			const AnimatorComponent& animator = val.GetComponent<AnimatorComponent>();
+			if (animator.Animation.Raw() && animator.Animation->IsBaked())
+				serialize<AnimatorComponent>(out, animator);
+		}
 		out << YAML::EndMap; // Entity
 	}
 
@@ -458,6 +476,17 @@ namespace XYZ {
 		entity.AddComponent(chain);
 	}
 
+	template <>
+	void SceneSerializer::deserialize<AnimatorComponent>(YAML::Node& data, SceneEntity entity)
+	{
+		Ref<Animation> animation = Ref<Animation>::Create(entity);
+		if (!animation->LoadClip(data["ClipPath"].as<std::string>()))
+			return;
+
+		animation->SetRepeat(data["Repeat"].as<bool>());
+		entity.EmplaceComponent<AnimatorComponent>().Animation = animation;
+	}
+
 	template <>
 	void SceneSerializer::deserialize<SceneEntity>(YAML::Node& data, SceneEntity ent)
 	{
@@ -525,6 +554,12 @@ namespace XYZ {
 		{
 			deserialize<SpotLight2D>(spotLightComponent, entity);
 		}
+
+		auto animatorComponent = data["AnimatorComponent"];
+		if (animatorComponent)
+		{
+			deserialize<AnimatorComponent>(animatorComponent, entity);
+		}
 	}
 
 
@@ -556,14 +591,14 @@ namespace XYZ {
 
 	Ref<Scene> SceneSerializer::Deserialize()
 	{
-		std::ifstream stream(m_Scene->FilePath);
-		std::stringstream strStream;
-		strStream << stream.rdbuf();
-		YAML::Node data = YAML::Load(strStream.str());
+		std::string source;
+		if (!AssetManager::ReadFile(m_Scene->FilePath, source))
+			XYZ_LOG_ERR("Could not read scene ", m_Scene->FilePath);
+		YAML::Node data = YAML::Load(source);
 
 		m_Scene->m_Name = data["Scene"].as<std::string>();
 		ECSManager& ecs = m_Scene->m_ECS;
-		ecs.GetComponent<SceneTagComponent>(m_Scene->m_SceneEntity).Name = m_Scene->m_Name;
+		m_Scene->SetEntityName(m_Scene->m_SceneEntity, m_Scene->m_Name);
 		auto entities = data["Entities"];
 		if (entities)
 		{
@@ -574,27 +609,27 @@ namespace XYZ {
 			for (auto data : entities)
 			{
 				GUID guid = data["Entity"].as<std::string>();
-				Entity entity = ecs.FindEntity<IDComponent>(IDComponent(guid));
+				Entity entity = m_Scene->GetEntityByGUID(guid);
 				Relationship& relationship = ecs.GetComponent<Relationship>(entity);
 				if (data["Parent"])
 				{
 					std::string parent = data["Parent"].as<std::string>();
-					relationship.Parent = ecs.FindEntity<IDComponent>(IDComponent({ parent }));
+					relationship.Parent = m_Scene->GetEntityByGUID(parent);
 				}
 				if (data["NextSibling"])
 				{
 					std::string nextSibling = data["NextSibling"].as<std::string>();
-					relationship.NextSibling = ecs.FindEntity<IDComponent>(IDComponent({ nextSibling }));
+					relationship.NextSibling = m_Scene->GetEntityByGUID(nextSibling);
 				}
 				if (data["PreviousSibling"])
 				{
 					std::string previousSibling = data["PreviousSibling"].as<std::string>();
-					relationship.PreviousSibling = ecs.FindEntity<IDComponent>(IDComponent({ previousSibling }));
+					relationship.PreviousSibling = m_Scene->GetEntityByGUID(previousSibling);
 				}
 				if (data["FirstChild"])
 				{
 					std::string firstChild = data["FirstChild"].as<std::string>();
-					relationship.FirstChild = ecs.FindEntity<IDComponent>(IDComponent({ firstChild }));
+					relationship.FirstChild = m_Scene->GetEntityByGUID(firstChild);
 				}
 			}
 		}
@@ -0,0 +1,208 @@
+#include "stdafx.h"
+#include "SceneSpatialIndex.h"
+
+#include "Components.h"
+
+namespace XYZ {
+
+	// Bounds of unit quad centered at the origin of transform
+	static AABB QuadAABB(const WorldTransform2D& transform)
+	{
+		const glm::vec2 extents = (glm::abs(transform.AxisX) + glm::abs(transform.AxisY)) * 0.5f;
+		const glm::vec2 center(transform.Translation);
+		return AABB(glm::vec3(center - extents, transform.Translation.z), glm::vec3(center + extents, transform.Translation.z));
+	}
+
+	static AABB LightAABB(const WorldTransform2D& transform, float radius)
+	{
+		const glm::vec3& position = transform.Translation;
+		return AABB(position - glm::vec3(radius, radius, 0.0f), position + glm::vec3(radius, radius, 0.0f));
+	}
+
+	static AABB ProxyAABB(const SpriteRenderer& sprite, const WorldTransform2D& transform)
+	{
+		return QuadAABB(transform);
+	}
+
+	static AABB ProxyAABB(const TransformComponent& component, const WorldTransform2D& transform)
+	{
+		return QuadAABB(transform);
+	}
+
+	static AABB ProxyAABB(const PointLight2D& light, const WorldTransform2D& transform)
+	{
+		return LightAABB(transform, light.Radius);
+	}
+
+	static AABB ProxyAABB(const SpotLight2D& light, const WorldTransform2D& transform)
+	{
+		return LightAABB(transform, light.Radius);
+	}
+
+	static bool Equal(const AABB& a, const AABB& b)
+	{
+		return a.Min == b.Min && a.Max == b.Max;
+	}
+
+	void SpatialQueryResult::Clear()
+	{
+		for (auto& entities : Entities)
+			entities.clear();
+	}
+
+	void SceneSpatialIndex::Attach(ECSManager& ecs)
+	{
+		auto listener = [this](SpatialProxyType type) {
+			return [this, type](uint32_t entity, CallbackType callbackType) {
+				if (callbackType == CallbackType::ComponentCreate)
+					markDirty(type, entity);
+				else if (callbackType == CallbackType::ComponentRemove || callbackType == CallbackType::EntityDestroy)
+					removeProxy(type, entity);
+			};
+		};
+		ecs.AddListener<SpriteRenderer>(listener(SpatialProxyType::Sprite), this);
+		ecs.AddListener<PointLight2D>(listener(SpatialProxyType::PointLight), this);
+		ecs.AddListener<SpotLight2D>(listener(SpatialProxyType::SpotLight), this);
+		ecs.AddListener<TransformComponent>(listener(SpatialProxyType::Pickable), this);
+	}
+
+	void SceneSpatialIndex::Detach(ECSManager& ecs)
+	{
+		ecs.RemoveListener<SpriteRenderer>(this);
+		ecs.RemoveListener<PointLight2D>(this);
+		ecs.RemoveListener<SpotLight2D>(this);
+		ecs.RemoveListener<TransformComponent>(this);
+	}
+
+	void SceneSpatialIndex::MarkDirty(Entity entity)
+	{
+		for (size_t i = 0; i < (size_t)SpatialProxyType::NumTypes; ++i)
+			markDirty((SpatialProxyType)i, entity);
+	}
+
+	void SceneSpatialIndex::Update(ECSManager& ecs, std::initializer_list<SpatialProxyType> types)
+	{
+		for (SpatialProxyType type : types)
+		{
+			switch (type)
+			{
+			case SpatialProxyType::Sprite:
+				updateProxies<SpriteRenderer>(ecs, type);
+				break;
+			case SpatialProxyType::PointLight:
+				updateProxies<PointLight2D>(ecs, type);
+				break;
+			case SpatialProxyType::SpotLight:
+				updateProxies<SpotLight2D>(ecs, type);
+				break;
+			case SpatialProxyType::Pickable:
+				updateProxies<TransformComponent>(ecs, type);
+				break;
+			}
+		}
+	}
+
+	void SceneSpatialIndex::Query(const AABB& aabb, SpatialQueryResult& result, std::initializer_list<SpatialProxyType> types)
+	{
+		result.Clear();
+		for (SpatialProxyType type : types)
+		{
+			DynamicTree& tree = m_Trees[(size_t)type];
+			std::vector<Entity>& entities = result.Get(type);
+			tree.Query([&](int32_t index) {
+				entities.push_back(Entity(tree.GetDataIndex(index)));
+				return false;
+			}, aabb);
+		}
+	}
+
+	bool SceneSpatialIndex::GetBounds(SpatialProxyType type, Entity entity, AABB& result) const
+	{
+		const std::vector<int32_t>& proxies = m_Proxies[(size_t)type];
+		if ((uint32_t)entity >= proxies.size() || proxies[entity] == NULL_NODE)
+			return false;
+
+		result = m_Trees[(size_t)type].GetAABB(proxies[entity]);
+		return true;
+	}
+
+	void SceneSpatialIndex::RayCast(SpatialProxyType type, const Ray& ray, std::vector<RayCastHit>& hits)
+	{
+		m_Trees[(size_t)type].RayCast(ray, hits);
+	}
+
+	AABB SceneSpatialIndex::CameraAABB(const glm::mat4& viewProjection)
+	{
+		const glm::mat4 inverse = glm::inverse(viewProjection);
+		glm::vec3 min(std::numeric_limits<float>::max());
+		glm::vec3 max(-std::numeric_limits<float>::max());
+		for (float z : { -1.0f, 1.0f })
+		{
+			for (float y : { -1.0f, 1.0f })
+			{
+				for (float x : { -1.0f, 1.0f })
+				{
+					const glm::vec4 corner = inverse * glm::vec4(x, y, z, 1.0f);
+					const glm::vec3 position = glm::vec3(corner) / corner.w;
+					min = glm::min(min, position);
+					max = glm::max(max, position);
+				}
+			}
+		}
+		return AABB(min, max);
+	}
+
+	template <typename T>
+	void SceneSpatialIndex::updateProxies(ECSManager& ecs, SpatialProxyType type)
+	{
+		std::vector<Entity>& dirty = m_Dirty[(size_t)type];
+		std::vector<bool>& flags = m_DirtyFlags[(size_t)type];
+		for (const Entity entity : dirty)
+		{
+			flags[entity] = false;
+			// Entity could be destroyed or lose the component after it was queued
+			if (!ecs.IsValid(entity) || !ecs.Contains<T>(entity) || !ecs.Contains<WorldTransform2D>(entity))
+				continue;
+
+			const WorldTransform2D& transform = ecs.GetComponent<WorldTransform2D>(entity);
+			updateProxy(type, entity, ProxyAABB(ecs.GetComponent<T>(entity), transform));
+		}
+		dirty.clear();
+	}
+
+	void SceneSpatialIndex::updateProxy(SpatialProxyType type, Entity entity, const AABB& aabb)
+	{
+		std::vector<int32_t>& proxies = m_Proxies[(size_t)type];
+		if (proxies.size() <= (uint32_t)entity)
+			proxies.resize((size_t)entity + 1, NULL_NODE);
+
+		DynamicTree& tree = m_Trees[(size_t)type];
+		int32_t& proxy = proxies[entity];
+		if (proxy == NULL_NODE)
+			proxy = tree.Insert(entity, aabb);
+		else if (!Equal(tree.GetAABB(proxy), aabb))
+			tree.Move(proxy, aabb);
+	}
+
+	void SceneSpatialIndex::markDirty(SpatialProxyType type, uint32_t entity)
+	{
+		std::vector<bool>& flags = m_DirtyFlags[(size_t)type];
+		if (flags.size() <= entity)
+			flags.resize((size_t)entity + 1, false);
+		if (flags[entity])
+			return;
+
+		flags[entity] = true;
+		m_Dirty[(size_t)type].push_back(entity);
+	}
+
+	void SceneSpatialIndex::removeProxy(SpatialProxyType type, uint32_t entity)
+	{
+		std::vector<int32_t>& proxies = m_Proxies[(size_t)type];
+		if (entity >= proxies.size() || proxies[entity] == NULL_NODE)
+			return;
+
+		m_Trees[(size_t)type].Remove(proxies[entity]);
+		proxies[entity] = NULL_NODE;
+	}
+}
@@ -0,0 +1,67 @@
+#pragma once
+#include "XYZ/ECS/ECSManager.h"
+#include "XYZ/Utils/DataStructures/DynamicTree.h"
+
+#include <glm/glm.hpp>
+
+namespace XYZ {
+
+	enum class SpatialProxyType : uint8_t
+	{
+		Sprite,
+		PointLight,
+		SpotLight,
+		Pickable, // Bounds of every entity used by editor selection
+		NumTypes
+	};
+
+	struct SpatialQueryResult
+	{
+		void Clear();
+
+		std::vector<Entity>&	   Get(SpatialProxyType type)		{ return Entities[(size_t)type]; }
+		const std::vector<Entity>& Get(SpatialProxyType type) const { return Entities[(size_t)type]; }
+
+		std::vector<Entity> Entities[(size_t)SpatialProxyType::NumTypes];
+	};
+
+	// Broadphase of the scene with one tree per proxy type. Entities are queued by component
+	// callbacks and MarkDirty, Update refreshes only queued proxies
+	class SceneSpatialIndex
+	{
+	public:
+		void Attach(ECSManager& ecs);
+		void Detach(ECSManager& ecs);
+
+		// Bounds of the entity changed, for example its world transform or light radius
+		void MarkDirty(Entity entity);
+		// Inserts new proxies and moves proxies of dirty entities
+		void Update(ECSManager& ecs, std::initializer_list<SpatialProxyType> types);
+		void Query(const AABB& aabb, SpatialQueryResult& result, std::initializer_list<SpatialProxyType> types);
+		// Hits sorted by entry distance, DataIndex of hit is entity
+		void RayCast(SpatialProxyType type, const Ray& ray, std::vector<RayCastHit>& hits);
+
+		// Bounds stored at the last update, false if entity has no proxy
+		bool GetBounds(SpatialProxyType type, Entity entity, AABB& result) const;
+		const DynamicTree& GetTree(SpatialProxyType type) const { return m_Trees[(size_t)type]; }
+
+		// Bounds of the area visible through camera, corners of near and far plane are projected to xy plane
+		static AABB CameraAABB(const glm::mat4& viewProjection);
+
+	private:
+		template <typename T>
+		void updateProxies(ECSManager& ecs, SpatialProxyType type);
+
+		void updateProxy(SpatialProxyType type, Entity entity, const AABB& aabb);
+		void removeProxy(SpatialProxyType type, uint32_t entity);
+		void markDirty(SpatialProxyType type, uint32_t entity);
+
+	private:
+		DynamicTree m_Trees[(size_t)SpatialProxyType::NumTypes];
+		// Tree leaf of entity, indexed by entity id
+		std::vector<int32_t> m_Proxies[(size_t)SpatialProxyType::NumTypes];
+		// Entities waiting for update, flags prevent duplicates
+		std::vector<Entity>	 m_Dirty[(size_t)SpatialProxyType::NumTypes];
+		std::vector<bool>	 m_DirtyFlags[(size_t)SpatialProxyType::NumTypes];
+	};
+}
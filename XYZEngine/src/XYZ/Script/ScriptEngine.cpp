@@ -5,6 +5,7 @@
 #include <mono/metadata/assembly.h>
 #include <mono/metadata/debug-helpers.h>
 #include <mono/metadata/attrdefs.h>
+#include <mono/metadata/object.h>
 
 #include <iostream>
 #include <chrono>
@@ -42,6 +43,7 @@ namespace XYZ {
 		MonoMethod* OnCreateMethod = nullptr;
 		MonoMethod* OnDestroyMethod = nullptr;
 		MonoMethod* OnUpdateMethod = nullptr;
+		MonoMethod* OnContactsMethod = nullptr;
 		uint32_t	Handle = 0;
 
 		void InitClassMethods(MonoImage* image)
@@ -49,12 +51,78 @@ namespace XYZ {
 			OnCreateMethod = GetMethod(image, FullName + ":OnCreate()");
 			OnDestroyMethod = GetMethod(image, FullName + ":OnDestroy()");
 			OnUpdateMethod = GetMethod(image, FullName + ":OnUpdate(single)");
+			// Optional, scripts without contact handling are skipped
+			OnContactsMethod = Class ? mono_class_get_method_from_name(Class, "OnContacts", 1) : nullptr;
 		}
 	};
 
 	using EntityClassMap = std::unordered_map<uint32_t, std::unordered_map<std::string, EntityScriptClass*>>;
 	static EntityClassMap s_EntityClassMap;
 
+	// Managed methods called through unmanaged thunks, exception is returned in the last argument
+	using OnUpdateThunk = void(__stdcall*)(MonoObject*, float, MonoException**);
+	using OnUpdateBatchThunk = void(__stdcall*)(MonoObject*, float, MonoException**);
+
+	// Layout must match XYZ.TransformData
+	struct ScriptTransformData
+	{
+		glm::vec3 Translation;
+		glm::vec3 Rotation;
+		glm::vec3 Scale;
+	};
+
+	// Entities with the same script class, updated by one managed call if the class
+	// defines static OnUpdateBatch(EntityBatch, float), otherwise by cached OnUpdate thunk
+	struct ScriptBatch
+	{
+		OnUpdateBatchThunk				 UpdateBatch = nullptr;
+		OnUpdateThunk					 Update = nullptr;
+		std::string						 ClassName;
+
+		std::vector<Entity>				 Entities;
+		std::vector<uint32_t>			 Handles;
+		uint32_t						 BatchHandle = 0; // XYZ.EntityBatch passed to OnUpdateBatch
+
+		// Native memory exposed to scripts as TransformSpan, changed entries are written back
+		std::vector<ScriptTransformData> Transforms;
+		std::vector<ScriptTransformData> OriginalTransforms;
+	};
+	// Layout must match XYZ.ContactSpan
+	struct ScriptContactSpan
+	{
+		const ContactEvent* Data;
+		int32_t				Length;
+	};
+	static_assert(sizeof(ContactEvent) == 12, "Layout must match XYZ.ContactEvent");
+
+	// Ordered by class name, so classes are updated in the same order every frame
+	static std::map<std::string, ScriptBatch> s_ScriptBatches;
+	static bool s_ScriptBatchesDirty = true;
+
+	static void ClearScriptBatches()
+	{
+		for (auto& [className, batch] : s_ScriptBatches)
+		{
+			if (batch.BatchHandle)
+				mono_gchandle_free(batch.BatchHandle);
+		}
+		s_ScriptBatches.clear();
+		s_ScriptBatchesDirty = true;
+	}
+
+	static void LogScriptException(MonoException* exception, const std::string& className)
+	{
+		MonoString* message = mono_object_to_string((MonoObject*)exception, nullptr);
+		if (!message)
+		{
+			XYZ_LOG_ERR("Script ", className, " threw exception");
+			return;
+		}
+		char* utf8 = mono_string_to_utf8(message);
+		XYZ_LOG_ERR("Script ", className, " threw exception: ", utf8);
+		mono_free(utf8);
+	}
+
 	static MonoObject* GetInstance(uint32_t handle)
 	{
 		XYZ_ASSERT(handle, "Entity has not been instantiated!");
@@ -199,6 +267,9 @@ namespace XYZ {
 
 	void ScriptEngine::Shutdown()
 	{
+		if (s_SceneContext.Raw())
+			s_SceneContext->m_ECS.RemoveListener<ScriptComponent>(&s_ScriptBatches);
+		ClearScriptBatches();
 		s_SceneContext.Reset();
 		for (auto it : s_EntityClassMap)
 		{
@@ -213,6 +284,9 @@ namespace XYZ {
 
 	void ScriptEngine::LoadXYZRuntimeAssembly(const std::string& path)
 	{
+		// Batches reference objects and thunks of the old domain
+		ClearScriptBatches();
+
 		MonoDomain* domain = nullptr;
 		bool cleanup = false;
 		if (s_MonoDomain)
@@ -257,7 +331,17 @@ namespace XYZ {
 
 	void ScriptEngine::SetSceneContext(const Ref<Scene>& scene)
 	{
+		if (s_SceneContext.Raw())
+			s_SceneContext->m_ECS.RemoveListener<ScriptComponent>(&s_ScriptBatches);
+
+		ClearScriptBatches();
 		s_SceneContext = scene;
+		if (s_SceneContext.Raw())
+		{
+			s_SceneContext->m_ECS.AddListener<ScriptComponent>([](uint32_t entity, CallbackType type) {
+				s_ScriptBatchesDirty = true;
+			}, &s_ScriptBatches);
+		}
 	}
 	const Ref<Scene>& ScriptEngine::GetCurrentSceneContext()
 	{
@@ -271,6 +355,7 @@ namespace XYZ {
 	}
 	void ScriptEngine::OnDestroyEntity(SceneEntity entity)
 	{
+		s_ScriptBatchesDirty = true;
 		ScriptComponent& scriptComponent = entity.GetComponent<ScriptComponent>();
 		if (scriptComponent.ScriptClass->OnDestroyMethod)
 			CallMethod(GetInstance(scriptComponent.ScriptClass->Handle), scriptComponent.ScriptClass->OnDestroyMethod);
@@ -285,6 +370,143 @@ namespace XYZ {
 		}
 	}
 
+	void ScriptEngine::OnUpdate(Timestep ts)
+	{
+		XYZ_ASSERT(s_SceneContext.Raw(), "No active scene!");
+		if (s_ScriptBatchesDirty)
+			rebuildScriptBatches();
+
+		ECSManager& ecs = s_SceneContext->m_ECS;
+		for (auto& [className, batch] : s_ScriptBatches)
+		{
+			MonoException* exception = nullptr;
+			if (batch.UpdateBatch)
+			{
+				for (size_t i = 0; i < batch.Entities.size(); ++i)
+				{
+					const TransformComponent& transform = ecs.GetComponent<TransformComponent>(batch.Entities[i]);
+					batch.Transforms[i] = { transform.Translation, transform.Rotation, transform.Scale };
+				}
+				batch.OriginalTransforms = batch.Transforms;
+
+				batch.UpdateBatch(GetInstance(batch.BatchHandle), ts, &exception);
+
+				for (size_t i = 0; i < batch.Entities.size(); ++i)
+				{
+					const ScriptTransformData& data = batch.Transforms[i];
+					if (memcmp(&data, &batch.OriginalTransforms[i], sizeof(ScriptTransformData)) == 0)
+						continue;
+
+					TransformComponent& transform = ecs.GetComponent<TransformComponent>(batch.Entities[i]);
+					transform.Translation = data.Translation;
+					transform.Rotation = data.Rotation;
+					transform.Scale = data.Scale;
+				}
+			}
+			else
+			{
+				// Exception in one entity does not stop update of the rest of the class
+				for (uint32_t handle : batch.Handles)
+				{
+					batch.Update(GetInstance(handle), ts, &exception);
+					if (exception)
+					{
+						LogScriptException(exception, batch.ClassName);
+						exception = nullptr;
+					}
+				}
+			}
+			if (exception)
+				LogScriptException(exception, batch.ClassName);
+		}
+	}
+
+	void ScriptEngine::OnContacts(const ContactListener& listener)
+	{
+		XYZ_ASSERT(s_SceneContext.Raw(), "No active scene!");
+		ECSManager& ecs = s_SceneContext->m_ECS;
+		const std::vector<ContactEvent>& events = listener.GetEvents();
+		for (const ContactGroup& group : listener.GetGroups())
+		{
+			// Entity could be destroyed after the step
+			if (!ecs.IsValid(group.Owner) || !ecs.Contains<ScriptComponent>(group.Owner))
+				continue;
+
+			const EntityScriptClass* scriptClass = ecs.GetComponent<ScriptComponent>(group.Owner).ScriptClass;
+			if (!scriptClass || !scriptClass->OnContactsMethod || !scriptClass->Handle)
+				continue;
+
+			ScriptContactSpan span = { &events[group.Offset], (int32_t)group.Count };
+			void* args[] = { &span };
+			CallMethod(GetInstance(scriptClass->Handle), scriptClass->OnContactsMethod, args);
+		}
+	}
+
+	void ScriptEngine::rebuildScriptBatches()
+	{
+		ClearScriptBatches();
+		s_ScriptBatchesDirty = false;
+
+		ECSManager& ecs = s_SceneContext->m_ECS;
+		ecs.CreateStorage<ScriptComponent>();
+		ComponentStorage<ScriptComponent>& scriptStorage = ecs.GetStorage<ScriptComponent>();
+		for (size_t i = 0; i < scriptStorage.Size(); ++i)
+		{
+			const ScriptComponent& scriptComponent = scriptStorage[i];
+			const EntityScriptClass* scriptClass = scriptComponent.ScriptClass;
+			if (scriptComponent.ModuleName.empty() || !scriptClass || !scriptClass->Class || !scriptClass->Handle)
+				continue;
+
+			ScriptBatch& batch = s_ScriptBatches[scriptClass->FullName];
+			if (batch.ClassName.empty())
+			{
+				batch.ClassName = scriptClass->FullName;
+				MonoMethod* batchMethod = mono_class_get_method_from_name(scriptClass->Class, "OnUpdateBatch", 2);
+				if (batchMethod && (mono_method_get_flags(batchMethod, nullptr) & MONO_METHOD_ATTR_STATIC))
+					batch.UpdateBatch = (OnUpdateBatchThunk)mono_method_get_unmanaged_thunk(batchMethod);
+				else if (scriptClass->OnUpdateMethod)
+					batch.Update = (OnUpdateThunk)mono_method_get_unmanaged_thunk(scriptClass->OnUpdateMethod);
+			}
+			batch.Entities.push_back(scriptStorage.GetEntityAtIndex(i));
+			batch.Handles.push_back(scriptClass->Handle);
+		}
+
+		MonoClass* entityClass = mono_class_from_name(s_CoreAssemblyImage, "XYZ", "Entity");
+		MonoClass* batchClass = mono_class_from_name(s_CoreAssemblyImage, "XYZ", "EntityBatch");
+		MonoClassField* entitiesField = mono_class_get_field_from_name(batchClass, "m_Entities");
+		MonoClassField* transformsField = mono_class_get_field_from_name(batchClass, "m_Transforms");
+		MonoClassField* countField = mono_class_get_field_from_name(batchClass, "m_Count");
+		for (auto it = s_ScriptBatches.begin(); it != s_ScriptBatches.end();)
+		{
+			ScriptBatch& batch = it->second;
+			if (!batch.UpdateBatch && !batch.Update)
+			{
+				it = s_ScriptBatches.erase(it);
+				continue;
+			}
+			if (batch.UpdateBatch)
+			{
+				const int32_t count = (int32_t)batch.Entities.size();
+				batch.Transforms.resize(count);
+				batch.OriginalTransforms.resize(count);
+
+				MonoArray* entities = mono_array_new(s_MonoDomain, entityClass, count);
+				for (int32_t i = 0; i < count; ++i)
+					mono_array_setref(entities, i, GetInstance(batch.Handles[i]));
+
+				// Transforms are stored in native memory, their address does not change until next rebuild
+				void* transforms = batch.Transforms.data();
+				MonoObject* batchObject = mono_object_new(s_MonoDomain, batchClass);
+				mono_runtime_object_init(batchObject);
+				mono_field_set_value(batchObject, entitiesField, entities);
+				mono_field_set_value(batchObject, transformsField, &transforms);
+				mono_field_set_value(batchObject, countField, (void*)&count);
+				batch.BatchHandle = mono_gchandle_new(batchObject, false);
+			}
+			++it;
+		}
+	}
+
 	bool ScriptEngine::ModuleExists(const std::string& moduleName)
 	{
 		std::string NamespaceName, ClassName;
@@ -355,7 +577,8 @@ namespace XYZ {
 		scriptComponent.ScriptClass->FullName = scriptComponent.ModuleName;
 
 		scriptComponent.ScriptClass->Class = GetClass(s_AppAssemblyImage, *scriptComponent.ScriptClass);
-		scriptComponent.ScriptClass->InitClassMethods(s_AppAssemblyImage);		
+		scriptComponent.ScriptClass->InitClassMethods(s_AppAssemblyImage);
+		s_ScriptBatchesDirty = true;
 	}
 
 	void ScriptEngine::InstantiateEntityClass(SceneEntity entity)
@@ -365,6 +588,7 @@ namespace XYZ {
 		
 		XYZ_ASSERT(scriptComponent.ScriptClass, "");
 		scriptComponent.ScriptClass->Handle = Instantiate(*scriptComponent.ScriptClass);
+		s_ScriptBatchesDirty = true;
 
 		MonoProperty* entityIDProperty = mono_class_get_property_from_name(scriptComponent.ScriptClass->Class, "ID");
 		mono_property_get_get_method(entityIDProperty);
@@ -2,6 +2,7 @@
 
 #include "XYZ/ECS/Entity.h"
 #include "XYZ/Scene/Scene.h"
+#include "XYZ/Physics/ContactListener.h"
 
 extern "C" {
 
@@ -29,11 +30,18 @@ namespace XYZ {
 		static void OnCreateEntity(SceneEntity entity);
 		static void OnDestroyEntity(SceneEntity entity);
 		static void OnUpdateEntity(SceneEntity entity, Timestep ts);
+		// Updates all script entities of current scene context, entities are grouped by script class
+		static void OnUpdate(Timestep ts);
+		// Calls OnContacts(ContactSpan) of scripts once with all contacts of the entity
+		static void OnContacts(const ContactListener& listener);
 
 		static bool ModuleExists(const std::string& moduleName);
 		static void InitScriptEntity(SceneEntity entity);
 		static void InstantiateEntityClass(SceneEntity entity);
 		static MonoDomain* GetMonoDomain();
+
+	private:
+		static void rebuildScriptBatches();
 	};
 
 }
\ No newline at end of file
@@ -0,0 +1,157 @@
+#include "stdafx.h"
+#include "Compression.h"
+
+#include <cstring>
+
+namespace XYZ::Utils {
+
+	static constexpr size_t   sc_MinMatch = 4;
+	static constexpr size_t   sc_MaxOffset = 65535;
+	static constexpr uint32_t sc_HashBits = 14;
+	// Last bytes are always emitted as literals so the match search can read 4 bytes safely
+	static constexpr size_t   sc_LastLiterals = 5;
+
+	static uint32_t HashSequence(const uint8_t* data)
+	{
+		uint32_t value;
+		memcpy(&value, data, sizeof(uint32_t));
+		return (value * 2654435761u) >> (32 - sc_HashBits);
+	}
+
+	static void WriteLength(std::vector<uint8_t>& destination, size_t length)
+	{
+		while (length >= 255)
+		{
+			destination.push_back(255);
+			length -= 255;
+		}
+		destination.push_back((uint8_t)length);
+	}
+
+	static void WriteSequence(std::vector<uint8_t>& destination, const uint8_t* literals, size_t literalCount, size_t matchLength, size_t offset)
+	{
+		size_t matchCode = matchLength ? matchLength - sc_MinMatch : 0;
+		uint8_t token = (uint8_t)((std::min<size_t>(literalCount, 15) << 4) | std::min<size_t>(matchCode, 15));
+		destination.push_back(token);
+		if (literalCount >= 15)
+			WriteLength(destination, literalCount - 15);
+
+		if (literalCount)
+			destination.insert(destination.end(), literals, literals + literalCount);
+		if (matchLength)
+		{
+			destination.push_back((uint8_t)(offset & 0xFF));
+			destination.push_back((uint8_t)(offset >> 8));
+			if (matchCode >= 15)
+				WriteLength(destination, matchCode - 15);
+		}
+	}
+
+	size_t GetMaxCompressedSize(size_t size)
+	{
+		return size + size / 255 + 16;
+	}
+
+	size_t Compress(const uint8_t* source, size_t sourceSize, std::vector<uint8_t>& destination)
+	{
+		destination.clear();
+		destination.reserve(GetMaxCompressedSize(sourceSize));
+
+		std::vector<int64_t> hashTable((size_t)1 << sc_HashBits, -1);
+		size_t anchor = 0;
+		size_t position = 0;
+		if (sourceSize > sc_LastLiterals + sc_MinMatch)
+		{
+			const size_t matchLimit = sourceSize - sc_LastLiterals;
+			while (position + sc_MinMatch <= matchLimit)
+			{
+				uint32_t hash = HashSequence(&source[position]);
+				int64_t candidate = hashTable[hash];
+				hashTable[hash] = (int64_t)position;
+
+				if (candidate < 0
+					|| position - (size_t)candidate > sc_MaxOffset
+					|| memcmp(&source[candidate], &source[position], sc_MinMatch) != 0)
+				{
+					position++;
+					continue;
+				}
+
+				size_t matchLength = sc_MinMatch;
+				while (position + matchLength < matchLimit
+					&& source[candidate + matchLength] == source[position + matchLength])
+					matchLength++;
+
+				WriteSequence(destination, &source[anchor], position - anchor, matchLength, position - (size_t)candidate);
+				position += matchLength;
+				anchor = position;
+			}
+		}
+		// Trailing literals
+		WriteSequence(destination, &source[anchor], sourceSize - anchor, 0, 0);
+		return destination.size();
+	}
+
+	bool Decompress(const uint8_t* source, size_t sourceSize, uint8_t* destination, size_t destinationSize)
+	{
+		size_t in = 0;
+		size_t out = 0;
+		while (in < sourceSize)
+		{
+			uint8_t token = source[in++];
+			size_t literalCount = token >> 4;
+			if (literalCount == 15)
+			{
+				uint8_t next;
+				do
+				{
+					if (in >= sourceSize)
+						return false;
+					next = source[in++];
+					literalCount += next;
+				} while (next == 255);
+			}
+			if (in + literalCount > sourceSize || out + literalCount > destinationSize)
+				return false;
+
+			if (literalCount)
+				memcpy(&destination[out], &source[in], literalCount);
+			in += literalCount;
+			out += literalCount;
+
+			// Last sequence contains only literals
+			if (in == sourceSize)
+				break;
+
+			if (in + 2 > sourceSize)
+				return false;
+			size_t offset = (size_t)source[in] | ((size_t)source[in + 1] << 8);
+			in += 2;
+			if (offset == 0 || offset > out)
+				return false;
+
+			size_t matchLength = (token & 0x0F);
+			if (matchLength == 15)
+			{
+				uint8_t next;
+				do
+				{
+					if (in >= sourceSize)
+						return false;
+					next = source[in++];
+					matchLength += next;
+				} while (next == 255);
+			}
+			matchLength += sc_MinMatch;
+			if (out + matchLength > destinationSize)
+				return false;
+
+			// Byte by byte copy, match can overlap with its own output
+			const uint8_t* match = &destination[out - offset];
+			for (size_t i = 0; i < matchLength; ++i)
+				destination[out + i] = match[i];
+			out += matchLength;
+		}
+		return out == destinationSize;
+	}
+}
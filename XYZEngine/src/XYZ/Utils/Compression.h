@@ -0,0 +1,11 @@
+#pragma once
+#include <stdint.h>
+#include <vector>
+
+namespace XYZ::Utils {
+	// Byte oriented LZ77 block compression ( LZ4 like sequence layout ).
+	// Fast to decode, intended for packed asset payloads
+	size_t GetMaxCompressedSize(size_t size);
+	size_t Compress(const uint8_t* source, size_t sourceSize, std::vector<uint8_t>& destination);
+	bool   Decompress(const uint8_t* source, size_t sourceSize, uint8_t* destination, size_t destinationSize);
+}
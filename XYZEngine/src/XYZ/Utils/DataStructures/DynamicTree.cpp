@@ -3,95 +3,370 @@
 
 #include "XYZ/Renderer/Renderer2D.h"
 
+#include <limits>
+
 
 
 // Copied Box2D implementation of the dynamic tree
 // https://github.com/behdad/box2d/blob/master/Box2D/Box2D/Collision/b2DynamicTree.cpp
 
 
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+	#define XYZ_DYNAMIC_TREE_SSE
+	#include <immintrin.h>
+#endif
+
 namespace XYZ {
+
+	static bool ContainsAABB(const AABB& a, const AABB& b)
+	{
+		return a.Min.x <= b.Min.x && a.Min.y <= b.Min.y && a.Min.z <= b.Min.z
+			&& b.Max.x <= a.Max.x && b.Max.y <= a.Max.y && b.Max.z <= a.Max.z;
+	}
+
+	// Bit mask of children of wide node intersecting box.
+	// Tests x and y only, same as AABB::Intersect used by Query
+	static int32_t IntersectWide(const WideNode& node, const AABB& box)
+	{
+	#ifdef XYZ_DYNAMIC_TREE_SSE
+		const __m128 x = _mm_and_ps(
+			_mm_cmple_ps(_mm_load_ps(node.MinX), _mm_set1_ps(box.Max.x)),
+			_mm_cmple_ps(_mm_set1_ps(box.Min.x), _mm_load_ps(node.MaxX))
+		);
+		const __m128 y = _mm_and_ps(
+			_mm_cmple_ps(_mm_load_ps(node.MinY), _mm_set1_ps(box.Max.y)),
+			_mm_cmple_ps(_mm_set1_ps(box.Min.y), _mm_load_ps(node.MaxY))
+		);
+		return _mm_movemask_ps(_mm_and_ps(x, y)) & node.ValidMask;
+	#else
+		int32_t mask = 0;
+		for (int32_t i = 0; i < 4; ++i)
+		{
+			if (node.MinX[i] <= box.Max.x && box.Min.x <= node.MaxX[i]
+			 && node.MinY[i] <= box.Max.y && box.Min.y <= node.MaxY[i])
+				mask |= 1 << i;
+		}
+		return mask & node.ValidMask;
+	#endif
+	}
+
+	struct WideRay
+	{
+		WideRay(const Ray& ray)
+			: Origin(ray.Origin)
+		{
+			// Infinite inverse of zero direction gives 0 * inf = NaN when origin lies on a box plane,
+			// large finite value keeps the slab test exact for axis aligned rays
+			for (int32_t axis = 0; axis < 3; ++axis)
+			{
+				const float direction = ray.Direction[axis];
+				InverseDirection[axis] = std::abs(direction) > sc_MinDirection ? 1.0f / direction : std::copysign(sc_MaxInverseDirection, direction);
+			}
+		}
+
+		glm::vec3 Origin;
+		glm::vec3 InverseDirection;
+
+		static constexpr float sc_MinDirection = 1e-30f;
+		static constexpr float sc_MaxInverseDirection = 1e30f;
+	};
+
+	// Bit mask of children of wide node hit by ray, entry distances are written to distances
+	static int32_t IntersectWide(const WideNode& node, const WideRay& ray, float* distances)
+	{
+	#ifdef XYZ_DYNAMIC_TREE_SSE
+		const __m128 ox = _mm_set1_ps(ray.Origin.x), oy = _mm_set1_ps(ray.Origin.y), oz = _mm_set1_ps(ray.Origin.z);
+		const __m128 ix = _mm_set1_ps(ray.InverseDirection.x), iy = _mm_set1_ps(ray.InverseDirection.y), iz = _mm_set1_ps(ray.InverseDirection.z);
+
+		const __m128 t1 = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(node.MinX), ox), ix);
+		const __m128 t2 = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(node.MaxX), ox), ix);
+		const __m128 t3 = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(node.MinY), oy), iy);
+		const __m128 t4 = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(node.MaxY), oy), iy);
+		const __m128 t5 = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(node.MinZ), oz), iz);
+		const __m128 t6 = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(node.MaxZ), oz), iz);
+
+		const __m128 tmin = _mm_max_ps(_mm_max_ps(_mm_min_ps(t1, t2), _mm_min_ps(t3, t4)), _mm_min_ps(t5, t6));
+		const __m128 tmax = _mm_min_ps(_mm_min_ps(_mm_max_ps(t1, t2), _mm_max_ps(t3, t4)), _mm_max_ps(t5, t6));
+		const __m128 hit = _mm_and_ps(_mm_cmpge_ps(tmax, _mm_setzero_ps()), _mm_cmple_ps(tmin, tmax));
+
+		_mm_storeu_ps(distances, _mm_max_ps(tmin, _mm_setzero_ps()));
+		return _mm_movemask_ps(hit) & node.ValidMask;
+	#else
+		int32_t mask = 0;
+		for (int32_t i = 0; i < 4; ++i)
+		{
+			const float t1 = (node.MinX[i] - ray.Origin.x) * ray.InverseDirection.x;
+			const float t2 = (node.MaxX[i] - ray.Origin.x) * ray.InverseDirection.x;
+			const float t3 = (node.MinY[i] - ray.Origin.y) * ray.InverseDirection.y;
+			const float t4 = (node.MaxY[i] - ray.Origin.y) * ray.InverseDirection.y;
+			const float t5 = (node.MinZ[i] - ray.Origin.z) * ray.InverseDirection.z;
+			const float t6 = (node.MaxZ[i] - ray.Origin.z) * ray.InverseDirection.z;
+
+			const float tmin = std::max(std::max(std::min(t1, t2), std::min(t3, t4)), std::min(t5, t6));
+			const float tmax = std::min(std::min(std::max(t1, t2), std::max(t3, t4)), std::max(t5, t6));
+			distances[i] = std::max(tmin, 0.0f);
+			if (tmax >= 0.0f && tmin <= tmax)
+				mask |= 1 << i;
+		}
+		return mask & node.ValidMask;
+	#endif
+	}
+
 	bool DynamicTree::RayCast(const Ray& ray, uint32_t& result)
 	{
-		std::stack<int32_t> stack;
-		stack.push(m_RootIndex);
-		while (!stack.empty())
+		if (m_RootIndex == NULL_NODE)
+			return false;
+
+		float closest = std::numeric_limits<float>::max();
+		bool hit = false;
+
+		struct Entry
 		{
-			int32_t index = stack.top();
-			stack.pop();
-			if (!ray.IntersectsAABB(m_Nodes[index].Box))
+			int32_t Index;
+			float	Distance;
+		};
+		// Nodes are stored with their entry distance, subtrees farther than closest hit are skipped
+		GrowableStack<Entry, sc_StackSize> stack;
+		float distance;
+		if (ray.IntersectsAABB(m_Nodes[m_RootIndex].Box, distance))
+			stack.Push({ m_RootIndex, distance });
+
+		while (!stack.Empty())
+		{
+			const Entry entry = stack.Pop();
+			if (entry.Distance >= closest)
+				continue;
+
+			const Node& node = m_Nodes[entry.Index];
+			if (node.IsLeaf())
 			{
+				if (ray.IntersectsAABB(m_TightBoxes[entry.Index], distance) && distance < closest)
+				{
+					closest = distance;
+					result = node.DataIndex;
+					hit = true;
+				}
 				continue;
 			}
-			if (m_Nodes[index].IsLeaf())
+
+			float firstDistance, secondDistance;
+			const bool first = ray.IntersectsAABB(m_Nodes[node.FirstChild].Box, firstDistance) && firstDistance < closest;
+			const bool second = ray.IntersectsAABB(m_Nodes[node.SecondChild].Box, secondDistance) && secondDistance < closest;
+			// Nearer child is pushed last so it is visited first
+			if (first && second)
 			{
-				uint32_t objectIndex = m_Nodes[index].DataIndex;
-				if (ray.IntersectsAABB(m_Nodes[index].Box))
+				if (firstDistance < secondDistance)
 				{
-					result = objectIndex;
-					return true;
+					stack.Push({ node.SecondChild, secondDistance });
+					stack.Push({ node.FirstChild, firstDistance });
 				}
+				else
+				{
+					stack.Push({ node.FirstChild, firstDistance });
+					stack.Push({ node.SecondChild, secondDistance });
+				}
+			}
+			else if (first)
+				stack.Push({ node.FirstChild, firstDistance });
+			else if (second)
+				stack.Push({ node.SecondChild, secondDistance });
+		}
+		return hit;
+	}
+	void DynamicTree::RayCast(const Ray& ray, std::vector<RayCastHit>& hits)
+	{
+		hits.clear();
+		if (m_RootIndex == NULL_NODE)
+			return;
+
+		GrowableStack<int32_t, sc_StackSize> stack;
+		stack.Push(m_RootIndex);
+		while (!stack.Empty())
+		{
+			const int32_t index = stack.Pop();
+			const Node& node = m_Nodes[index];
+			float distance;
+			if (!ray.IntersectsAABB(node.Box, distance))
+				continue;
+			if (node.IsLeaf())
+			{
+				if (ray.IntersectsAABB(m_TightBoxes[index], distance))
+					hits.push_back({ node.DataIndex, distance });
 			}
 			else
 			{
-				stack.push(m_Nodes[index].FirstChild);
-				stack.push(m_Nodes[index].SecondChild);
+				stack.Push(node.FirstChild);
+				stack.Push(node.SecondChild);
 			}
 		}
-		return false;
+		std::sort(hits.begin(), hits.end(), [](const RayCastHit& a, const RayCastHit& b) {
+			return a.Distance < b.Distance;
+		});
 	}
-	void DynamicTree::Query(const CollisionCallback& callback,const AABB& aabb)
+	void DynamicTree::QueryBatch(const AABB* boxes, uint32_t count, std::vector<QueryHit>& hits)
 	{
-		std::stack<int32_t> stack;
-		stack.push(m_RootIndex);
-		while (!stack.empty())
+		hits.clear();
+		if (m_RootIndex == NULL_NODE)
+			return;
+		if (m_WideTreeDirty)
+			buildWideTree();
+
+		GrowableStack<int32_t, sc_StackSize> stack;
+		for (uint32_t query = 0; query < count; ++query)
 		{
-			int32_t index = stack.top();
-			stack.pop();
-			if (index == NULL_NODE)
-				continue;
+			const AABB& box = boxes[query];
+			stack.Push(0);
+			while (!stack.Empty())
+			{
+				const WideNode& node = m_WideNodes[stack.Pop()];
+				const int32_t mask = IntersectWide(node, box);
+				for (int32_t slot = 0; slot < 4; ++slot)
+				{
+					if (!(mask & (1 << slot)))
+						continue;
+
+					const int32_t child = node.Children[slot];
+					if (child < 0)
+						hits.push_back({ query, m_Nodes[~child].DataIndex });
+					else
+						stack.Push(child);
+				}
+			}
+		}
+	}
+	void DynamicTree::RayCastBatch(const Ray* rays, uint32_t count, std::vector<RayCastHit>& hits)
+	{
+		hits.assign(count, { 0, std::numeric_limits<float>::infinity() });
+		if (m_RootIndex == NULL_NODE)
+			return;
+		if (m_WideTreeDirty)
+			buildWideTree();
 
-			const Node& node = m_Nodes[index];
-			if (node.Box.Intersect(aabb))
+		struct Entry
+		{
+			int32_t Index;
+			float	Distance;
+		};
+		GrowableStack<Entry, sc_StackSize> stack;
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			const WideRay ray(rays[i]);
+			RayCastHit& hit = hits[i];
+
+			stack.Push({ 0, 0.0f });
+			while (!stack.Empty())
 			{
-				if (node.IsLeaf())
+				const Entry entry = stack.Pop();
+				if (entry.Distance >= hit.Distance)
+					continue;
+
+				const WideNode& node = m_WideNodes[entry.Index];
+				alignas(16) float distances[4];
+				const int32_t mask = IntersectWide(node, ray, distances);
+
+				// Children are pushed from the farthest so the nearest is visited first
+				Entry children[4];
+				uint32_t childCount = 0;
+				for (int32_t slot = 0; slot < 4; ++slot)
 				{
-					bool proceed = callback(index);
-					if (proceed)
-						return;
+					if (!(mask & (1 << slot)) || distances[slot] >= hit.Distance)
+						continue;
+
+					const int32_t child = node.Children[slot];
+					if (child < 0)
+					{
+						hit = { m_Nodes[~child].DataIndex, distances[slot] };
+						continue;
+					}
+					Entry newEntry = { child, distances[slot] };
+					uint32_t position = childCount++;
+					for (; position > 0 && children[position - 1].Distance < newEntry.Distance; --position)
+						children[position] = children[position - 1];
+					children[position] = newEntry;
 				}
-				else
+				for (uint32_t c = 0; c < childCount; ++c)
 				{
-					stack.push(node.FirstChild);
-					stack.push(node.SecondChild);
+					if (children[c].Distance < hit.Distance)
+						stack.Push(children[c]);
 				}
 			}
 		}
 	}
 	int32_t DynamicTree::Insert(uint32_t objectIndex, const AABB& box)
 	{
-		int32_t leaf = m_Nodes.Insert({ box , objectIndex });
+		int32_t leaf = m_Nodes.Insert({ fatten(box), objectIndex });
 		
 		if (m_MovedNodes.size() < m_Nodes.Range())
+		{
 			m_MovedNodes.resize(m_Nodes.Range());
+			m_TightBoxes.resize(m_Nodes.Range());
+		}
+		m_TightBoxes[leaf] = box;
 		insertLeaf(leaf);
+		m_WideTreeDirty = true;
 		return leaf;
 	}
 	void DynamicTree::Move(int32_t index, const glm::vec2& displacement)
 	{
-		removeLeaf(index);
+		AABB box = m_TightBoxes[index] + displacement;
+		Move(index, box);
+	}
+	void DynamicTree::Move(int32_t index, const AABB& box)
+	{
+		Node& node = m_Nodes[index];
+		m_TightBoxes[index] = box;
+		m_MovedNodes[index] = true;
+		m_WideTreeDirty = true;
 
-		m_Nodes[index].Box.Min.x += displacement.x;
-		m_Nodes[index].Box.Min.y += displacement.y;
-		m_Nodes[index].Box.Max.x += displacement.x;
-		m_Nodes[index].Box.Max.y += displacement.y;
+		// Small moves stay inside enlarged box, shrunk leaves are reinserted to keep the tree tight
+		const AABB fatBox = fatten(box);
+		if (ContainsAABB(node.Box, box) && node.Box.GetPerimeter() <= 2.0f * fatBox.GetPerimeter())
+			return;
 
-		m_MovedNodes[index] = true;
+		removeLeaf(index);
+		m_Nodes[index].Box = fatBox;
 		insertLeaf(index);
 	}
 	void DynamicTree::Remove(int32_t index)
 	{		
 		removeLeaf(index);
 		m_Nodes.Erase(index);
+		m_WideTreeDirty = true;
+	}
+	void DynamicTree::SetAABB(int32_t index, const AABB& box)
+	{
+		Node& node = m_Nodes[index];
+		m_TightBoxes[index] = box;
+		if (!ContainsAABB(node.Box, box))
+			node.Box = fatten(box);
+
+		m_MovedNodes[index] = true;
+		m_WideTreeDirty = true;
+	}
+	void DynamicTree::Refit()
+	{
+		if (m_RootIndex == NULL_NODE)
+			return;
+
+		// Parents are stored before children, reverse order visits children first
+		m_RefitOrder.clear();
+		m_RefitOrder.push_back(m_RootIndex);
+		for (size_t i = 0; i < m_RefitOrder.size(); ++i)
+		{
+			const Node& node = m_Nodes[m_RefitOrder[i]];
+			if (!node.IsLeaf())
+			{
+				m_RefitOrder.push_back(node.FirstChild);
+				m_RefitOrder.push_back(node.SecondChild);
+			}
+		}
+		for (auto it = m_RefitOrder.rbegin(); it != m_RefitOrder.rend(); ++it)
+		{
+			Node& node = m_Nodes[*it];
+			if (!node.IsLeaf())
+				node.Box = AABB::Union(m_Nodes[node.FirstChild].Box, m_Nodes[node.SecondChild].Box);
+		}
+		m_WideTreeDirty = true;
 	}
 
 	void DynamicTree::SubmitToRenderer()
@@ -140,8 +415,90 @@ namespace XYZ {
 
 	void DynamicTree::CleanMovedNodes()
 	{
-		for (auto& node : m_MovedNodes)
-			node = false;
+		std::fill(m_MovedNodes.begin(), m_MovedNodes.end(), false);
+	}
+
+	AABB DynamicTree::fatten(const AABB& box) const
+	{
+		const glm::vec3 margin(m_Margin);
+		return AABB(box.Min - margin, box.Max + margin);
+	}
+
+	void DynamicTree::buildWideTree()
+	{
+		m_WideNodes.clear();
+		m_WideTreeDirty = false;
+		if (m_RootIndex == NULL_NODE)
+			return;
+
+		buildWideNode(m_RootIndex);
+	}
+
+	int32_t DynamicTree::buildWideNode(int32_t index)
+	{
+		// Children of binary node are expanded until there are four, the largest first
+		int32_t children[4];
+		int32_t count = 0;
+		if (m_Nodes[index].IsLeaf())
+		{
+			children[count++] = index;
+		}
+		else
+		{
+			children[count++] = m_Nodes[index].FirstChild;
+			children[count++] = m_Nodes[index].SecondChild;
+		}
+		while (count < 4)
+		{
+			int32_t largest = -1;
+			float largestPerimeter = -1.0f;
+			for (int32_t i = 0; i < count; ++i)
+			{
+				const Node& child = m_Nodes[children[i]];
+				if (!child.IsLeaf() && child.Box.GetPerimeter() > largestPerimeter)
+				{
+					largest = i;
+					largestPerimeter = child.Box.GetPerimeter();
+				}
+			}
+			if (largest == -1)
+				break;
+
+			const Node& expanded = m_Nodes[children[largest]];
+			children[largest] = expanded.FirstChild;
+			children[count++] = expanded.SecondChild;
+		}
+
+		const int32_t wideIndex = (int32_t)m_WideNodes.size();
+		m_WideNodes.emplace_back();
+		for (int32_t i = 0; i < 4; ++i)
+		{
+			WideNode& wide = m_WideNodes[wideIndex];
+			if (i >= count)
+			{
+				wide.MinX[i] = wide.MinY[i] = wide.MinZ[i] = std::numeric_limits<float>::max();
+				wide.MaxX[i] = wide.MaxY[i] = wide.MaxZ[i] = -std::numeric_limits<float>::max();
+				wide.Children[i] = 0;
+				continue;
+			}
+			const Node& child = m_Nodes[children[i]];
+			// Leaves use their exact box so hits do not need another test
+			const AABB& box = child.IsLeaf() ? m_TightBoxes[children[i]] : child.Box;
+			wide.MinX[i] = box.Min.x; wide.MinY[i] = box.Min.y; wide.MinZ[i] = box.Min.z;
+			wide.MaxX[i] = box.Max.x; wide.MaxY[i] = box.Max.y; wide.MaxZ[i] = box.Max.z;
+			wide.ValidMask |= 1 << i;
+			if (child.IsLeaf())
+			{
+				wide.Children[i] = ~children[i];
+			}
+			else
+			{
+				// Vector may reallocate, wide node is looked up again in next iteration
+				const int32_t childWide = buildWideNode(children[i]);
+				m_WideNodes[wideIndex].Children[i] = childWide;
+			}
+		}
+		return wideIndex;
 	}
 
 	void DynamicTree::insertLeaf(int32_t leaf)
@@ -2,15 +2,14 @@
 #include "XYZ/Utils/Math/AABB.h"
 #include "XYZ/Utils/Math/Ray.h"
 #include "XYZ/Utils/DataStructures/FreeList.h"
-
-#include <stack>
+#include "XYZ/Utils/DataStructures/GrowableStack.h"
 
 namespace XYZ {
 
 #define NULL_NODE (-1)
 	struct Node
 	{
-		AABB	 Box;
+		AABB	 Box; // Leaves are enlarged by margin of the tree
 		uint32_t DataIndex;
 
 		int32_t ParentIndex = NULL_NODE;
@@ -21,35 +20,125 @@ namespace XYZ {
 		bool IsLeaf() const { return FirstChild == NULL_NODE; }
 	};
 
+	// Four children of collapsed tree in SoA layout, tested at once
+	struct alignas(16) WideNode
+	{
+		float MinX[4], MinY[4], MinZ[4];
+		float MaxX[4], MaxY[4], MaxZ[4];
+		// Index of wide node, or ~index of leaf node if negative
+		int32_t Children[4];
+		int32_t ValidMask;
+	};
+
 	using CollisionCallback = std::function<bool(int32_t)>;
 
+	struct RayCastHit
+	{
+		uint32_t DataIndex;
+		float	 Distance;
+	};
+
+	struct QueryHit
+	{
+		uint32_t QueryIndex;
+		uint32_t DataIndex;
+	};
+
 	class DynamicTree
 	{
 	public:
+		// Finds leaf with the closest entry point of the ray
 		bool RayCast(const Ray& ray, uint32_t& result);
-		void Query(const CollisionCallback& callback, const AABB& aabb);
+		// Finds all leaves hit by the ray, sorted by entry distance
+		void RayCast(const Ray& ray, std::vector<RayCastHit>& hits);
+		// Callback receives index of leaf node, returning true stops the query.
+		// Boxes overlap test is 2D like AABB::Intersect, z is ignored
+		template <typename Callback>
+		void Query(const Callback& callback, const AABB& aabb);
+
+		// Batched versions traverse collapsed four wide tree rebuilt after the tree changed.
+		// Hits of all queries, grouped by query index, z is ignored as in Query
+		void QueryBatch(const AABB* boxes, uint32_t count, std::vector<QueryHit>& hits);
+		// Closest hit of every ray, distance is infinity if ray did not hit anything
+		void RayCastBatch(const Ray* rays, uint32_t count, std::vector<RayCastHit>& hits);
 
 		int32_t Insert(uint32_t objectIndex, const AABB& box);
+		// Leaf is reinserted only if it leaves its enlarged box
 		void Move(int32_t index, const glm::vec2& displacement);
+		void Move(int32_t index, const AABB& box);
 		void Remove(int32_t index);
 
+		// Changes box of leaf without restructuring the tree, Refit must be called before next query
+		void SetAABB(int32_t index, const AABB& box);
+		// Recomputes boxes of internal nodes bottom up, cheaper than reinserting many moved leaves
+		void Refit();
+
+		void SetMargin(float margin) { m_Margin = margin; }
+
 		uint32_t GetDataIndex(int32_t index) const { return m_Nodes[index].DataIndex; }
-		const AABB& GetAABB(int32_t index) const { return m_Nodes[index].Box; }
+		const AABB& GetAABB(int32_t index) const { return m_TightBoxes[index]; }
+		const AABB& GetFatAABB(int32_t index) const { return m_Nodes[index].Box; }
+		float GetMargin() const { return m_Margin; }
 		// Debug
 		void SubmitToRenderer();
 
 		void CleanMovedNodes();
 		const std::vector<bool>& GetMovedNodes() const { return m_MovedNodes; }
 
+		static constexpr size_t sc_StackSize = 256;
 	private:
 		void insertLeaf(int32_t index);
 		void removeLeaf(int32_t leaf);
 		int32_t balance(int32_t index);
 
+		AABB fatten(const AABB& box) const;
+		static bool containsXY(const AABB& a, const AABB& b)
+		{
+			return a.Min.x <= b.Min.x && a.Min.y <= b.Min.y && b.Max.x <= a.Max.x && b.Max.y <= a.Max.y;
+		}
+		void buildWideTree();
+		int32_t buildWideNode(int32_t index);
+
 	private:
 		FreeList<Node> m_Nodes;
 
+		// Box of leaf as inserted or moved, indexed by node. Kept outside of nodes,
+		// traversal touches it only for leaves whose enlarged box passed the test
+		std::vector<AABB> m_TightBoxes;
 		std::vector<bool> m_MovedNodes;
 		int32_t m_RootIndex = NULL_NODE;
+		float	m_Margin = 0.1f;
+
+		std::vector<WideNode> m_WideNodes;
+		std::vector<int32_t>  m_RefitOrder;
+		bool				  m_WideTreeDirty = true;
 	};
-}
\ No newline at end of file
+
+	template <typename Callback>
+	inline void DynamicTree::Query(const Callback& callback, const AABB& aabb)
+	{
+		if (m_RootIndex == NULL_NODE)
+			return;
+
+		GrowableStack<int32_t, sc_StackSize> stack;
+		stack.Push(m_RootIndex);
+		while (!stack.Empty())
+		{
+			const int32_t index = stack.Pop();
+			const Node& node = m_Nodes[index];
+			if (!node.Box.Intersect(aabb))
+				continue;
+			if (node.IsLeaf())
+			{
+				// Enlarged box inside of the query implies hit, exact box is read only on partial overlap
+				if ((containsXY(aabb, node.Box) || m_TightBoxes[index].Intersect(aabb)) && callback(index))
+					return;
+			}
+			else
+			{
+				stack.Push(node.FirstChild);
+				stack.Push(node.SecondChild);
+			}
+		}
+	}
+}
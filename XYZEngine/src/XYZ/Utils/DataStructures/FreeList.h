@@ -107,6 +107,12 @@ namespace XYZ {
 			m_Data.resize(static_cast<size_t>(size));
 		}
 
+		// Reserves memory for the given number of elements
+		void Reserve(size_t size)
+		{
+			m_Data.reserve(size);
+		}
+
 		// Removes all elements from the free list.
 		void Clear()
 		{
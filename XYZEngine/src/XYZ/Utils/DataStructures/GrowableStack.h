@@ -0,0 +1,50 @@
+#pragma once
+
+#include <memory>
+
+namespace XYZ {
+
+	// Stack with inline storage, allocates only if more than N elements are pushed
+	template <typename T, size_t N>
+	class GrowableStack
+	{
+	public:
+		GrowableStack() = default;
+		GrowableStack(const GrowableStack<T, N>&) = delete;
+		GrowableStack<T, N>& operator=(const GrowableStack<T, N>&) = delete;
+
+		void Push(const T& elem)
+		{
+			if (m_Count == m_Capacity)
+				grow();
+			m_Data[m_Count++] = elem;
+		}
+
+		T Pop()
+		{
+			return m_Data[--m_Count];
+		}
+
+		bool   Empty() const { return m_Count == 0; }
+		size_t Size()  const { return m_Count; }
+
+	private:
+		void grow()
+		{
+			std::unique_ptr<T[]> heap(new T[m_Capacity * 2]);
+			for (size_t i = 0; i < m_Count; ++i)
+				heap[i] = m_Data[i];
+
+			m_Heap = std::move(heap);
+			m_Data = m_Heap.get();
+			m_Capacity *= 2;
+		}
+
+	private:
+		T					 m_Array[N];
+		T*					 m_Data = m_Array;
+		std::unique_ptr<T[]> m_Heap;
+		size_t				 m_Count = 0;
+		size_t				 m_Capacity = N;
+	};
+}
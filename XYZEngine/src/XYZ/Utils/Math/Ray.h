@@ -22,6 +22,13 @@ namespace XYZ {
         }
 
         bool IntersectsAABB(const AABB& aabb) const
+        {
+            float distance;
+            return IntersectsAABB(aabb, distance);
+        }
+
+        // Distance is parameter of the entry point in multiples of Direction, zero if origin is inside
+        bool IntersectsAABB(const AABB& aabb, float& distance) const
         {
             glm::vec3 dirfrac;
             // r.dir is unit direction vector of ray
@@ -53,6 +60,7 @@ namespace XYZ {
             {
                 return false;
             }
+            distance = glm::max(tmin, 0.0f);
             return true;
         }
 
@@ -1,5 +1,8 @@
 #include "GameLayer.h"
 
+#include <XYZ/Debug/DynamicTreeBenchmark.h>
+#include <XYZ/Debug/SkinningBenchmark.h>
+
 
 namespace XYZ {
 
@@ -67,6 +70,7 @@ namespace XYZ {
 	{
 		EventDispatcher dispatcher(event);
 		dispatcher.Dispatch<WindowResizeEvent>(Hook(&GameLayer::onWindowResize, this));
+		dispatcher.Dispatch<KeyPressedEvent>(Hook(&GameLayer::onKeyPress, this));
 		m_EditorCamera.OnEvent(event);
 	}
 
@@ -76,4 +80,19 @@ namespace XYZ {
 		m_EditorCamera.SetViewportSize((float)event.GetWidth(), (float)event.GetHeight());
 		return false;
 	}
+
+	bool GameLayer::onKeyPress(KeyPressedEvent& event)
+	{
+		if (event.IsKeyPressed(KeyCode::KEY_F1))
+		{
+			RunDynamicTreeBenchmark(100000, 10000);
+			return true;
+		}
+		else if (event.IsKeyPressed(KeyCode::KEY_F2))
+		{
+			RunSkinningBenchmark(100000, 64, 100, &Application::GetThreadPool());
+			return true;
+		}
+		return false;
+	}
 }
\ No newline at end of file
@@ -18,6 +18,7 @@ namespace XYZ {
 
 	private:
 		bool onWindowResize(WindowResizeEvent& event);
+		bool onKeyPress(KeyPressedEvent& event);
 
 	private:
 		Ref<Scene> m_Scene;
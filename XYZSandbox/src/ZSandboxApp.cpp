@@ -8,6 +8,7 @@ namespace XYZ {
 	{
 	public:
 		Sandbox()
+			: Application({ true })
 		{
 			PushLayer(new GameLayer());
 		}
@@ -1,6 +1,7 @@
 project "XYZScriptCore"
 		kind "SharedLib"
 		language "C#"
+		clr "Unsafe"
 			
 		targetdir ("%{wks.location}/XYZEditor/Assets/Scripts")
 		objdir ("bin-int/" .. outputdir .. "/%{prj.name}")
@@ -0,0 +1,43 @@
+﻿using System;
+using System.Runtime.InteropServices;
+
+namespace XYZ
+{
+    public enum ContactEventType : byte
+    {
+        Begin,
+        End
+    }
+
+    // Layout must match native ContactEvent
+    [StructLayout(LayoutKind.Sequential)]
+    public struct ContactEvent
+    {
+        public uint Owner;
+        public uint Other;
+        public ContactEventType Type;
+    }
+
+    // Contacts of one entity recorded during physics step, passed to
+    // public void OnContacts(ContactSpan contacts)
+    // which is called once per frame if the entity had any contacts.
+    // View of native memory, valid only during OnContacts
+    [StructLayout(LayoutKind.Sequential)]
+    public unsafe struct ContactSpan
+    {
+        private readonly ContactEvent* m_Data;
+        private readonly int m_Length;
+
+        public int Length { get { return m_Length; } }
+
+        public ContactEvent this[int index]
+        {
+            get
+            {
+                if ((uint)index >= (uint)m_Length)
+                    throw new IndexOutOfRangeException();
+                return m_Data[index];
+            }
+        }
+    }
+}
@@ -0,0 +1,63 @@
+﻿using System;
+using System.Runtime.InteropServices;
+
+namespace XYZ
+{
+    // Layout must match native ScriptTransformData
+    [StructLayout(LayoutKind.Sequential)]
+    public struct TransformData
+    {
+        public Vector3 Translation;
+        public Vector3 Rotation;
+        public Vector3 Scale;
+    }
+
+    // View of native transforms, valid only during OnUpdateBatch.
+    // Memory is not managed by garbage collector so it does not have to be pinned
+    public unsafe struct TransformSpan
+    {
+        private readonly TransformData* m_Data;
+        private readonly int m_Length;
+
+        internal TransformSpan(IntPtr data, int length)
+        {
+            m_Data = (TransformData*)data;
+            m_Length = length;
+        }
+
+        public int Length { get { return m_Length; } }
+
+        public ref TransformData this[int index]
+        {
+            get
+            {
+                if ((uint)index >= (uint)m_Length)
+                    throw new IndexOutOfRangeException();
+                return ref m_Data[index];
+            }
+        }
+    }
+
+    // Entities of one script class, passed to
+    // public static void OnUpdateBatch(EntityBatch batch, float ts)
+    // which is called once per frame instead of OnUpdate of every entity
+    public sealed class EntityBatch
+    {
+        // Fields are set by the engine
+        private Entity[] m_Entities;
+        private IntPtr m_Transforms;
+        private int m_Count;
+
+        public int Count { get { return m_Count; } }
+
+        public Entity[] Entities { get { return m_Entities; } }
+
+        // Changed transforms are written back to components after OnUpdateBatch returns
+        public TransformSpan Transforms { get { return new TransformSpan(m_Transforms, m_Count); } }
+
+        public T Get<T>(int index) where T : Entity
+        {
+            return (T)m_Entities[index];
+        }
+    }
+}